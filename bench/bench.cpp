@@ -0,0 +1,413 @@
+/*
+    SIMDwrap_bench: every kernel in bench.hpp at working sets sized for L1,
+    L2, L3 and main memory, for the scalar baseline and, at each compiled
+    level the host can run, SIMDwrap and the legacy classes. Prints a table
+    and writes the results as JSON, to diff between builds before upgrading.
+
+        SIMDwrap_bench [--json path] [--filter text] [--min-time ms]
+
+    --filter keeps kernels whose name or group contains the text. Each
+    result is the best of a few trials of at least --min-time each.
+    Cycles are time stamp counter ticks, which run at the nominal clock
+    whatever the core is actually running at, and are left out where
+    there's no such counter.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif !defined(SW_PLATFORM_ARM)
+#include <x86intrin.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace sw_bench {
+
+    const kernel_info kernel_infos[kernel_count] = {
+        { "add_f32", "arithmetic", { operand::f32, operand::f32, operand::none }, operand::f32, false },
+        { "mul_add_f32", "arithmetic", { operand::f32, operand::f32, operand::f32 }, operand::f32, false },
+        { "div_f32", "arithmetic", { operand::f32, operand::f32, operand::none }, operand::f32, false },
+        { "sum_f32", "reduction", { operand::f32, operand::none, operand::none }, operand::f32, true },
+        { "max_f32", "reduction", { operand::f32, operand::none, operand::none }, operand::f32, true },
+        { "dot_f32", "reduction", { operand::f32, operand::f32, operand::none }, operand::f32, true },
+        { "sqrt_f32", "math", { operand::f32, operand::none, operand::none }, operand::f32, false },
+        { "exp_f32", "math", { operand::f32, operand::none, operand::none }, operand::f32, false },
+        { "log_f32", "math", { operand::f32, operand::none, operand::none }, operand::f32, false },
+        { "sin_f32", "math", { operand::f32, operand::none, operand::none }, operand::f32, false },
+        { "transform_points_f32", "matrix", { operand::point, operand::none, operand::none }, operand::point, false },
+        { "convert_f32_i32", "conversion", { operand::f32, operand::none, operand::none }, operand::i32, false },
+        { "convert_f64_f32", "conversion", { operand::f64, operand::none, operand::none }, operand::f32, false },
+        { "convert_f32_f16", "conversion", { operand::f32, operand::none, operand::none }, operand::f16, false },
+    };
+
+}
+
+namespace {
+
+    using namespace sw_bench;
+    using clock_type = std::chrono::steady_clock;
+
+    struct options {
+        std::string json_path = "SIMDwrap_bench.json";
+        std::string filter;
+        double min_seconds = 0.01;
+    };
+
+    struct size_class {
+        const char* name;
+        size_t working_set;
+    };
+
+    struct result {
+        const kernel_info* info;
+        const char* size;
+        size_t count;
+        size_t bytes;
+        const char* implementation;
+        const char* isa;
+        double elements_per_second;
+        // negative without a cycle counter
+        double cycles_per_element;
+        double speedup;
+    };
+
+    size_t operand_size(operand op) noexcept {
+        switch (op) {
+        case operand::f32:
+        case operand::i32:
+            return 4;
+        case operand::f64:
+            return 8;
+        case operand::f16:
+            return 2;
+        case operand::point:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    // bytes read and written per element
+    size_t element_bytes(kernel_info const& info) noexcept {
+        size_t result = info.reduction ? 0 : operand_size(info.out);
+        for (operand op : info.in) {
+            result += operand_size(op);
+        }
+        return result;
+    }
+
+#if !defined(SW_PLATFORM_ARM)
+    bool has_cycle_counter() noexcept {
+        return true;
+    }
+
+    uint64_t read_cycle_counter() noexcept {
+        return __rdtsc();
+    }
+#else
+    bool has_cycle_counter() noexcept {
+        return false;
+    }
+
+    uint64_t read_cycle_counter() noexcept {
+        return 0;
+    }
+#endif
+
+    // counter ticks per second, against the steady clock over a short busy wait
+    double cycle_counter_rate() noexcept {
+        if (!has_cycle_counter()) {
+            return 0.0;
+        }
+        const auto start = clock_type::now();
+        const uint64_t first = read_cycle_counter();
+        while (clock_type::now() - start < std::chrono::milliseconds(50)) {
+        }
+        const uint64_t last = read_cycle_counter();
+        return double(last - first) / std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    // per cache level in bytes, 0 where the OS doesn't say
+    size_t cache_size(int level) noexcept {
+        long result = 0;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+        switch (level) {
+        case 1:
+            result = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+            break;
+        case 2:
+            result = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            break;
+        default:
+            result = sysconf(_SC_LEVEL3_CACHE_SIZE);
+            break;
+        }
+#else
+        (void)level;
+#endif
+        return result > 0 ? size_t(result) : 0;
+    }
+
+    // half of each cache so the working set stays resident, and well past the last level for memory
+    std::vector<size_t> cache_sizes() {
+        const size_t fallback[3] = { 32 << 10, 1 << 20, 8 << 20 };
+        std::vector<size_t> result(3);
+        for (int level = 1; level <= 3; ++level) {
+            const size_t size = cache_size(level);
+            result[level - 1] = size != 0 ? size : fallback[level - 1];
+        }
+        return result;
+    }
+
+    std::vector<size_class> size_classes(std::vector<size_t> const& caches) {
+        return {
+            { "l1", caches[0] / 2 },
+            { "l2", caches[1] / 2 },
+            { "l3", caches[2] / 2 },
+            { "dram", std::max(caches[2] * 4, size_t(64) << 20) }
+        };
+    }
+
+    // 64 byte aligned block, filled with values every kernel is defined for
+    class storage {
+    public:
+        storage(operand op, size_t count, uint64_t seed) : bytes(std::max(operand_size(op) * count, size_t(64))) {
+            data = ::operator new(bytes, std::align_val_t(64));
+            std::memset(data, 0, bytes);
+            fill(op, count, seed);
+        }
+
+        storage(storage const&) = delete;
+        storage& operator=(storage const&) = delete;
+
+        ~storage() {
+            ::operator delete(data, std::align_val_t(64));
+        }
+
+        void* get() const noexcept {
+            return data;
+        }
+
+    private:
+        // in [0.5, 4), positive for sqrt and log and a divisor away from zero
+        void fill(operand op, size_t count, uint64_t seed) noexcept {
+            uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+            auto next = [&state]() {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return 0.5 + double(state >> 11) * (3.5 / double(uint64_t(1) << 53));
+            };
+            if (op == operand::f32 || op == operand::point) {
+                float* values = static_cast<float*>(data);
+                for (size_t i = 0; i < bytes / sizeof(float); ++i) {
+                    values[i] = float(next());
+                }
+            }
+            else if (op == operand::f64) {
+                double* values = static_cast<double*>(data);
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = next();
+                }
+            }
+        }
+
+        size_t bytes;
+        void* data;
+    };
+
+    struct timing {
+        double seconds;
+        double cycles;
+    };
+
+    // best of several trials, each repeating fn until it has run for at least min_seconds
+    timing measure(kernel_fn fn, buffers const& b, double min_seconds) {
+        fn(b);
+        size_t calls = 1;
+        for (;;) {
+            const auto start = clock_type::now();
+            for (size_t i = 0; i < calls; ++i) {
+                fn(b);
+            }
+            if (std::chrono::duration<double>(clock_type::now() - start).count() >= min_seconds) {
+                break;
+            }
+            calls *= 2;
+        }
+        timing best{ 0.0, 0.0 };
+        for (int trial = 0; trial < 5; ++trial) {
+            const auto start = clock_type::now();
+            const uint64_t first = read_cycle_counter();
+            for (size_t i = 0; i < calls; ++i) {
+                fn(b);
+            }
+            const uint64_t last = read_cycle_counter();
+            const double seconds = std::chrono::duration<double>(clock_type::now() - start).count() / double(calls);
+            if (trial == 0 || seconds < best.seconds) {
+                best = timing{ seconds, double(last - first) / double(calls) };
+            }
+        }
+        return best;
+    }
+
+    struct implementation {
+        const suite* kernels;
+        const char* isa;
+    };
+
+    // scalar, then SIMDwrap and the legacy classes at every level built here that the host can run
+    std::vector<implementation> implementations() {
+        std::vector<const level_suites*> levels;
+#if defined(SW_GENERIC_KERNELS)
+        levels.push_back(&suites_generic());
+#endif
+#if !defined(SW_PLATFORM_ARM)
+        levels.push_back(&suites_sse41());
+        levels.push_back(&suites_avx2());
+        levels.push_back(&suites_avx512());
+#endif
+        std::vector<implementation> result{ { &scalar_suite(), nullptr } };
+        for (const level_suites* level : levels) {
+            if (sw::is_supported(level->level)) {
+                result.push_back({ &level->simdwrap, sw::isa_name(level->level) });
+                result.push_back({ &level->legacy, sw::isa_name(level->level) });
+            }
+        }
+        return result;
+    }
+
+    bool selected(kernel_info const& info, options const& opts) {
+        return opts.filter.empty() || std::strstr(info.name, opts.filter.c_str()) != nullptr || std::strstr(info.group, opts.filter.c_str()) != nullptr;
+    }
+
+    std::vector<result> run(options const& opts, std::vector<size_class> const& sizes) {
+        static const float matrix[16] = { 0.5f, 0.25f, 0.0f, 0.0f, -0.25f, 0.5f, 0.125f, 0.0f, 0.0f, 0.75f, 1.0f, 0.0f, 1.0f, 2.0f, 3.0f, 1.0f };
+        const std::vector<implementation> impls = implementations();
+        std::vector<result> results;
+        for (size_t k = 0; k < kernel_count; ++k) {
+            kernel_info const& info = kernel_infos[k];
+            if (!selected(info, opts)) {
+                continue;
+            }
+            const size_t bytes = element_bytes(info);
+            for (size_class const& size : sizes) {
+                const size_t count = std::max(size.working_set / bytes / 16 * 16, size_t(16));
+                std::vector<std::unique_ptr<storage>> inputs;
+                buffers b{ { nullptr, nullptr, nullptr }, nullptr, matrix, count };
+                for (size_t i = 0; i < 3 && info.in[i] != operand::none; ++i) {
+                    inputs.push_back(std::make_unique<storage>(info.in[i], count, k * 3 + i + 1));
+                    b.in[i] = inputs.back()->get();
+                }
+                const storage out(info.out, info.reduction ? 16 : count, 0);
+                b.out = out.get();
+
+                double baseline = 0.0;
+                for (implementation const& impl : impls) {
+                    const kernel_fn fn = impl.kernels->kernels[k];
+                    if (fn == nullptr) {
+                        continue;
+                    }
+                    const timing t = measure(fn, b, opts.min_seconds);
+                    const double rate = double(count) / t.seconds;
+                    if (impl.isa == nullptr) {
+                        baseline = rate;
+                    }
+                    const result r{ &info, size.name, count, count * bytes, impl.kernels->name, impl.isa, rate,
+                        has_cycle_counter() ? t.cycles / double(count) : -1.0, baseline > 0.0 ? rate / baseline : 0.0 };
+                    std::printf("%-22s %-5s %10zu  %-12s %-7s %10.1f Melem/s", info.name, r.size, r.count, r.implementation, r.isa != nullptr ? r.isa : "-",
+                        r.elements_per_second * 1e-6);
+                    if (r.cycles_per_element >= 0.0) {
+                        std::printf(" %8.3f cyc/elem", r.cycles_per_element);
+                    }
+                    std::printf(" %7.2fx\n", r.speedup);
+                    results.push_back(r);
+                }
+            }
+        }
+        return results;
+    }
+
+    bool write_json(std::string const& path, std::vector<size_t> const& caches, std::vector<result> const& results) {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fprintf(file, "{\n  \"host\": {\n");
+        std::fprintf(file, "    \"best_isa\": \"%s\",\n", sw::isa_name(sw::best_supported_isa()));
+        std::fprintf(file, "    \"cycle_counter_hz\": %.6g,\n", cycle_counter_rate());
+        std::fprintf(file, "    \"cache_bytes\": { \"l1\": %zu, \"l2\": %zu, \"l3\": %zu }\n  },\n", caches[0], caches[1], caches[2]);
+        std::fprintf(file, "  \"results\": [");
+        for (size_t i = 0; i < results.size(); ++i) {
+            result const& r = results[i];
+            std::fprintf(file, "%s\n    { \"kernel\": \"%s\", \"group\": \"%s\", \"size\": \"%s\", \"elements\": %zu, \"bytes\": %zu, ",
+                i == 0 ? "" : ",", r.info->name, r.info->group, r.size, r.count, r.bytes);
+            std::fprintf(file, "\"implementation\": \"%s\", \"isa\": ", r.implementation);
+            if (r.isa != nullptr) {
+                std::fprintf(file, "\"%s\", ", r.isa);
+            }
+            else {
+                std::fprintf(file, "null, ");
+            }
+            std::fprintf(file, "\"elements_per_second\": %.6g, \"cycles_per_element\": ", r.elements_per_second);
+            if (r.cycles_per_element >= 0.0) {
+                std::fprintf(file, "%.6g, ", r.cycles_per_element);
+            }
+            else {
+                std::fprintf(file, "null, ");
+            }
+            std::fprintf(file, "\"speedup_over_scalar\": %.6g }", r.speedup);
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+
+    bool parse(int argc, char** argv, options& opts) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            if (arg == "--json") {
+                opts.json_path = argv[++i];
+            }
+            else if (arg == "--filter") {
+                opts.filter = argv[++i];
+            }
+            else if (arg == "--min-time") {
+                opts.min_seconds = std::atof(argv[++i]) * 1e-3;
+            }
+            else {
+                return false;
+            }
+        }
+        return opts.min_seconds > 0.0;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--json path] [--filter text] [--min-time ms]\n", argv[0]);
+        return 2;
+    }
+    const std::vector<size_t> caches = cache_sizes();
+    const std::vector<result> results = run(opts, size_classes(caches));
+    if (!write_json(opts.json_path, caches, results)) {
+        std::fprintf(stderr, "couldn't write %s\n", opts.json_path.c_str());
+        return 1;
+    }
+    std::printf("%zu results written to %s\n", results.size(), opts.json_path.c_str());
+    return 0;
+}
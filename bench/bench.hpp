@@ -0,0 +1,94 @@
+#pragma once
+#ifndef SIMD_WRAP_BENCH_BENCH_HPP
+#define SIMD_WRAP_BENCH_BENCH_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "dispatch.hpp"
+
+/*
+    Kernels measured by SIMDwrap_bench. kernels.cpp is built once per dispatch
+    level, like src/kernels.cpp, and fills in the suites for its level; the
+    scalar baseline lives in scalar.cpp. Nothing in here may depend on the ISA
+    of the including translation unit.
+*/
+
+namespace sw_bench {
+
+    enum class kernel : size_t {
+        add_f32,
+        mul_add_f32,
+        div_f32,
+        sum_f32,
+        max_f32,
+        dot_f32,
+        sqrt_f32,
+        exp_f32,
+        log_f32,
+        sin_f32,
+        transform_points_f32,
+        convert_f32_i32,
+        convert_f64_f32,
+        convert_f32_f16,
+        count
+    };
+
+    constexpr size_t kernel_count = static_cast<size_t>(kernel::count);
+
+    // element types of the buffers, point is four floats and f16 is sw::half
+    enum class operand : uint8_t {
+        none,
+        f32,
+        f64,
+        i32,
+        f16,
+        point
+    };
+
+    struct kernel_info {
+        const char* name;
+        const char* group;
+        operand in[3];
+        // a reduction writes a single element to out
+        operand out;
+        bool reduction;
+    };
+
+    extern const kernel_info kernel_infos[kernel_count];
+
+    /*
+        count elements of the types in kernel_info, always a multiple of 16 so
+        every kernel works in whole registers. matrix is 16 floats in columns.
+    */
+    struct buffers {
+        const void* in[3];
+        void* out;
+        const float* matrix;
+        size_t count;
+    };
+
+    using kernel_fn = void(*)(buffers const&) noexcept;
+
+    // null where the implementation has no such kernel
+    struct suite {
+        const char* name;
+        std::array<kernel_fn, kernel_count> kernels;
+    };
+
+    struct level_suites {
+        sw::isa level;
+        suite simdwrap;
+        // the old simd::vec4 (SSE4.1) and simd::vec8 (AVX2 and up) classes
+        suite legacy;
+    };
+
+    const suite& scalar_suite() noexcept;
+
+    const level_suites& suites_generic() noexcept;
+    const level_suites& suites_sse41() noexcept;
+    const level_suites& suites_avx2() noexcept;
+    const level_suites& suites_avx512() noexcept;
+
+}
+
+#endif //!SIMD_WRAP_BENCH_BENCH_HPP
@@ -0,0 +1,340 @@
+/*
+    Built once per dispatch level with that levels flags, like src/kernels.cpp,
+    and only the suites_*() function for the level is defined here.
+
+    The legacy kernels are what code written against the old simd::vec4 and
+    simd::vec8 classes compiles down to: one unaligned load, op and store per
+    register, separate multiplies and adds (they have no fma) and horizontal
+    sums through memory. The classes themselves only ever built with MSVC, so
+    their loops are spelled out with the same intrinsics instead. They have no
+    vector exp, log or sin and no half storage, and don't exist below SSE4.1.
+*/
+#include "convert.hpp"
+#include "half.hpp"
+#include "matrix.hpp"
+#include "reductions.hpp"
+#include "transform.hpp"
+#include "vector_functions.hpp"
+#include "bench.hpp"
+
+namespace sw_bench {
+
+    namespace {
+
+        template<typename T>
+        sw::span<const T> input(buffers const& b, size_t index, size_t count) noexcept {
+            return sw::span<const T>(static_cast<const T*>(b.in[index]), count);
+        }
+
+        template<typename T>
+        sw::span<T> output(buffers const& b, size_t count) noexcept {
+            return sw::span<T>(static_cast<T*>(b.out), count);
+        }
+
+        // SIMDwrap, through the bulk functions at the native length of the level
+
+        void add_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), input<float>(b, 1, b.count), output<float>(b, b.count),
+                [](auto const& x, auto const& y) { return x + y; });
+        }
+
+        void mul_add_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), input<float>(b, 1, b.count), input<float>(b, 2, b.count), output<float>(b, b.count),
+                [](auto const& x, auto const& y, auto const& z) { return x * y + z; });
+        }
+
+        void div_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), input<float>(b, 1, b.count), output<float>(b, b.count),
+                [](auto const& x, auto const& y) { return x / y; });
+        }
+
+        void sum_f32(buffers const& b) noexcept {
+            *static_cast<float*>(b.out) = sw::reduce_add(input<float>(b, 0, b.count));
+        }
+
+        void max_f32(buffers const& b) noexcept {
+            *static_cast<float*>(b.out) = sw::reduce_max(input<float>(b, 0, b.count));
+        }
+
+        void dot_f32(buffers const& b) noexcept {
+            *static_cast<float*>(b.out) = sw::dot(input<float>(b, 0, b.count), input<float>(b, 1, b.count));
+        }
+
+        void sqrt_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), output<float>(b, b.count), [](auto const& x) { return sw::sqrt(x); });
+        }
+
+        void exp_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), output<float>(b, b.count), [](auto const& x) { return sw::exp(x); });
+        }
+
+        void log_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), output<float>(b, b.count), [](auto const& x) { return sw::log(x); });
+        }
+
+        void sin_f32(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), output<float>(b, b.count), [](auto const& x) { return sw::sin(x); });
+        }
+
+        void transform_points_f32(buffers const& b) noexcept {
+            sw::mat4<float> m;
+            for (size_t j = 0; j < 4; ++j) {
+                m.column(j) = sw::vector<float, 4>::load_unaligned(b.matrix + j * 4);
+            }
+            sw::transform_points(m, input<sw::vector<float, 4>>(b, 0, b.count), output<sw::vector<float, 4>>(b, b.count));
+        }
+
+        void convert_f32_i32(buffers const& b) noexcept {
+            sw::convert(input<float>(b, 0, b.count), output<int32_t>(b, b.count));
+        }
+
+        void convert_f64_f32(buffers const& b) noexcept {
+            sw::convert(input<double>(b, 0, b.count), output<float>(b, b.count));
+        }
+
+        void convert_f32_f16(buffers const& b) noexcept {
+            sw::transform(input<float>(b, 0, b.count), output<sw::half>(b, b.count), [](auto const& x) { return x; });
+        }
+
+        constexpr suite simdwrap_suite{ "simdwrap", {
+            &add_f32,
+            &mul_add_f32,
+            &div_f32,
+            &sum_f32,
+            &max_f32,
+            &dot_f32,
+            &sqrt_f32,
+            &exp_f32,
+            &log_f32,
+            &sin_f32,
+            &transform_points_f32,
+            &convert_f32_i32,
+            &convert_f64_f32,
+            &convert_f32_f16
+        } };
+
+#if SW_ISA_LEVEL >= 1
+        // simd::vec4
+        struct vec4_ops {
+            using reg = __m128;
+            constexpr static size_t width = 4;
+            static reg load(const float* ptr) noexcept { return _mm_loadu_ps(ptr); }
+            static void store(float* ptr, reg v) noexcept { _mm_storeu_ps(ptr, v); }
+            static reg zero() noexcept { return _mm_setzero_ps(); }
+            static reg add(reg a, reg b) noexcept { return _mm_add_ps(a, b); }
+            static reg mul(reg a, reg b) noexcept { return _mm_mul_ps(a, b); }
+            static reg div(reg a, reg b) noexcept { return _mm_div_ps(a, b); }
+            static reg max(reg a, reg b) noexcept { return _mm_max_ps(a, b); }
+            static reg sqrt(reg a) noexcept { return _mm_sqrt_ps(a); }
+            static void to_int(const float* in, int32_t* out) noexcept {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtps_epi32(_mm_loadu_ps(in)));
+            }
+            static void to_float(const double* in, float* out) noexcept {
+                _mm_storeu_ps(out, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in)), _mm_cvtpd_ps(_mm_loadu_pd(in + 2))));
+            }
+            // one point per register, its lanes splatted against the columns
+            static void transform_points(const float* m, const float* in, float* out, size_t count) noexcept {
+                const reg c0 = load(m), c1 = load(m + 4), c2 = load(m + 8), c3 = load(m + 12);
+                for (size_t i = 0; i < count; ++i) {
+                    const reg p = load(in + i * 4);
+                    reg r = mul(c0, _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)));
+                    r = add(r, mul(c1, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));
+                    r = add(r, mul(c2, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+                    r = add(r, mul(c3, _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3))));
+                    store(out + i * 4, r);
+                }
+            }
+        };
+#endif
+
+#if SW_ISA_LEVEL >= 2
+        // simd::vec8, the widest of the old classes, so AVX-512 runs it as well
+        struct vec8_ops {
+            using reg = __m256;
+            constexpr static size_t width = 8;
+            static reg load(const float* ptr) noexcept { return _mm256_loadu_ps(ptr); }
+            static void store(float* ptr, reg v) noexcept { _mm256_storeu_ps(ptr, v); }
+            static reg zero() noexcept { return _mm256_setzero_ps(); }
+            static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+            static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+            static reg div(reg a, reg b) noexcept { return _mm256_div_ps(a, b); }
+            static reg max(reg a, reg b) noexcept { return _mm256_max_ps(a, b); }
+            static reg sqrt(reg a) noexcept { return _mm256_sqrt_ps(a); }
+            static void to_int(const float* in, int32_t* out) noexcept {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtps_epi32(_mm256_loadu_ps(in)));
+            }
+            static void to_float(const double* in, float* out) noexcept {
+                _mm_storeu_ps(out, _mm256_cvtpd_ps(_mm256_loadu_pd(in)));
+                _mm_storeu_ps(out + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(in + 4)));
+            }
+            // two points per register against the columns repeated in both halves
+            static void transform_points(const float* m, const float* in, float* out, size_t count) noexcept {
+                const reg c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+                const reg c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+                const reg c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+                const reg c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+                for (size_t i = 0; i < count; i += 2) {
+                    const reg p = load(in + i * 4);
+                    reg r = mul(c0, _mm256_permute_ps(p, _MM_SHUFFLE(0, 0, 0, 0)));
+                    r = add(r, mul(c1, _mm256_permute_ps(p, _MM_SHUFFLE(1, 1, 1, 1))));
+                    r = add(r, mul(c2, _mm256_permute_ps(p, _MM_SHUFFLE(2, 2, 2, 2))));
+                    r = add(r, mul(c3, _mm256_permute_ps(p, _MM_SHUFFLE(3, 3, 3, 3))));
+                    store(out + i * 4, r);
+                }
+            }
+        };
+#endif
+
+#if SW_ISA_LEVEL >= 1
+        // counts are whole registers, see buffers
+        template<typename Ops>
+        struct legacy {
+            using reg = typename Ops::reg;
+            constexpr static size_t width = Ops::width;
+
+            static float horizontal_sum(reg v) noexcept {
+                alignas(32) float lanes[width];
+                Ops::store(lanes, v);
+                float sum = 0.0f;
+                for (size_t i = 0; i < width; ++i) {
+                    sum += lanes[i];
+                }
+                return sum;
+            }
+
+            static void add_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                const float* y = static_cast<const float*>(b.in[1]);
+                float* out = static_cast<float*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::store(out + i, Ops::add(Ops::load(x + i), Ops::load(y + i)));
+                }
+            }
+
+            static void mul_add_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                const float* y = static_cast<const float*>(b.in[1]);
+                const float* z = static_cast<const float*>(b.in[2]);
+                float* out = static_cast<float*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::store(out + i, Ops::add(Ops::mul(Ops::load(x + i), Ops::load(y + i)), Ops::load(z + i)));
+                }
+            }
+
+            static void div_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                const float* y = static_cast<const float*>(b.in[1]);
+                float* out = static_cast<float*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::store(out + i, Ops::div(Ops::load(x + i), Ops::load(y + i)));
+                }
+            }
+
+            static void sum_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                reg acc = Ops::zero();
+                for (size_t i = 0; i < b.count; i += width) {
+                    acc = Ops::add(acc, Ops::load(x + i));
+                }
+                *static_cast<float*>(b.out) = horizontal_sum(acc);
+            }
+
+            static void max_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                reg acc = Ops::load(x);
+                for (size_t i = width; i < b.count; i += width) {
+                    acc = Ops::max(acc, Ops::load(x + i));
+                }
+                alignas(32) float lanes[width];
+                Ops::store(lanes, acc);
+                float result = lanes[0];
+                for (size_t i = 1; i < width; ++i) {
+                    result = lanes[i] > result ? lanes[i] : result;
+                }
+                *static_cast<float*>(b.out) = result;
+            }
+
+            static void dot_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                const float* y = static_cast<const float*>(b.in[1]);
+                reg acc = Ops::zero();
+                for (size_t i = 0; i < b.count; i += width) {
+                    acc = Ops::add(acc, Ops::mul(Ops::load(x + i), Ops::load(y + i)));
+                }
+                *static_cast<float*>(b.out) = horizontal_sum(acc);
+            }
+
+            static void sqrt_f32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                float* out = static_cast<float*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::store(out + i, Ops::sqrt(Ops::load(x + i)));
+                }
+            }
+
+            static void transform_points_f32(buffers const& b) noexcept {
+                Ops::transform_points(b.matrix, static_cast<const float*>(b.in[0]), static_cast<float*>(b.out), b.count);
+            }
+
+            static void convert_f32_i32(buffers const& b) noexcept {
+                const float* x = static_cast<const float*>(b.in[0]);
+                int32_t* out = static_cast<int32_t*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::to_int(x + i, out + i);
+                }
+            }
+
+            static void convert_f64_f32(buffers const& b) noexcept {
+                const double* x = static_cast<const double*>(b.in[0]);
+                float* out = static_cast<float*>(b.out);
+                for (size_t i = 0; i < b.count; i += width) {
+                    Ops::to_float(x + i, out + i);
+                }
+            }
+
+            static suite make(const char* name) noexcept {
+                return suite{ name, {
+                    &add_f32,
+                    &mul_add_f32,
+                    &div_f32,
+                    &sum_f32,
+                    &max_f32,
+                    &dot_f32,
+                    &sqrt_f32,
+                    nullptr,
+                    nullptr,
+                    nullptr,
+                    &transform_points_f32,
+                    &convert_f32_i32,
+                    &convert_f64_f32,
+                    nullptr
+                } };
+            }
+        };
+#endif
+
+    }
+
+#if SW_ISA_LEVEL == 3
+    const level_suites& suites_avx512() noexcept {
+        static const level_suites result{ sw::compiled_isa, simdwrap_suite, legacy<vec8_ops>::make("legacy_vec8") };
+        return result;
+    }
+#elif SW_ISA_LEVEL == 2
+    const level_suites& suites_avx2() noexcept {
+        static const level_suites result{ sw::compiled_isa, simdwrap_suite, legacy<vec8_ops>::make("legacy_vec8") };
+        return result;
+    }
+#elif SW_ISA_LEVEL == 1
+    const level_suites& suites_sse41() noexcept {
+        static const level_suites result{ sw::compiled_isa, simdwrap_suite, legacy<vec4_ops>::make("legacy_vec4") };
+        return result;
+    }
+#else
+    const level_suites& suites_generic() noexcept {
+        static const level_suites result{ sw::compiled_isa, simdwrap_suite, suite{ "legacy", {} } };
+        return result;
+    }
+#endif
+
+}
@@ -0,0 +1,164 @@
+/*
+    Plain loops over the same buffers as the vector kernels, built without
+    auto-vectorization (see CMakeLists.txt) so the numbers are one element at
+    a time. sw::half's scalar conversions are plain C++ as well.
+*/
+#include <algorithm>
+#include <cmath>
+#include "half.hpp"
+#include "bench.hpp"
+
+namespace sw_bench {
+
+    namespace {
+
+        template<typename T>
+        const T* input(buffers const& b, size_t index) noexcept {
+            return static_cast<const T*>(b.in[index]);
+        }
+
+        template<typename T>
+        T* output(buffers const& b) noexcept {
+            return static_cast<T*>(b.out);
+        }
+
+        void add_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            const float* y = input<float>(b, 1);
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = x[i] + y[i];
+            }
+        }
+
+        void mul_add_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            const float* y = input<float>(b, 1);
+            const float* z = input<float>(b, 2);
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = x[i] * y[i] + z[i];
+            }
+        }
+
+        void div_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            const float* y = input<float>(b, 1);
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = x[i] / y[i];
+            }
+        }
+
+        void sum_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            float sum = 0.0f;
+            for (size_t i = 0; i < b.count; ++i) {
+                sum += x[i];
+            }
+            *output<float>(b) = sum;
+        }
+
+        void max_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            float result = x[0];
+            for (size_t i = 1; i < b.count; ++i) {
+                result = std::max(result, x[i]);
+            }
+            *output<float>(b) = result;
+        }
+
+        void dot_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            const float* y = input<float>(b, 1);
+            float sum = 0.0f;
+            for (size_t i = 0; i < b.count; ++i) {
+                sum += x[i] * y[i];
+            }
+            *output<float>(b) = sum;
+        }
+
+        template<float(*Fn)(float)>
+        void unary_f32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = Fn(x[i]);
+            }
+        }
+
+        float sqrt_of(float x) noexcept {
+            return std::sqrt(x);
+        }
+
+        float exp_of(float x) noexcept {
+            return std::exp(x);
+        }
+
+        float log_of(float x) noexcept {
+            return std::log(x);
+        }
+
+        float sin_of(float x) noexcept {
+            return std::sin(x);
+        }
+
+        void transform_points_f32(buffers const& b) noexcept {
+            const float* points = input<float>(b, 0);
+            const float* m = b.matrix;
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                const float* p = points + i * 4;
+                for (size_t row = 0; row < 4; ++row) {
+                    out[i * 4 + row] = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row] * p[3];
+                }
+            }
+        }
+
+        void convert_f32_i32(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            int32_t* out = output<int32_t>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = int32_t(std::nearbyint(x[i]));
+            }
+        }
+
+        void convert_f64_f32(buffers const& b) noexcept {
+            const double* x = input<double>(b, 0);
+            float* out = output<float>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = float(x[i]);
+            }
+        }
+
+        void convert_f32_f16(buffers const& b) noexcept {
+            const float* x = input<float>(b, 0);
+            sw::half* out = output<sw::half>(b);
+            for (size_t i = 0; i < b.count; ++i) {
+                out[i] = sw::half(x[i]);
+            }
+        }
+
+    }
+
+    const suite& scalar_suite() noexcept {
+        static const suite result{ "scalar", {
+            &add_f32,
+            &mul_add_f32,
+            &div_f32,
+            &sum_f32,
+            &max_f32,
+            &dot_f32,
+            &unary_f32<&sqrt_of>,
+            &unary_f32<&exp_of>,
+            &unary_f32<&log_of>,
+            &unary_f32<&sin_of>,
+            &transform_points_f32,
+            &convert_f32_i32,
+            &convert_f64_f32,
+            &convert_f32_f16
+        } };
+        return result;
+    }
+
+}
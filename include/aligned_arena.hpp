@@ -0,0 +1,184 @@
+#pragma once
+#ifndef SIMD_WRAP_ALIGNED_ARENA_HPP
+#define SIMD_WRAP_ALIGNED_ARENA_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "detail/simd_traits.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            Bump allocator for short-lived SIMD scratch memory. Allocations are
+            carved out of large chunks taken from an upstream resource, freeing
+            single allocations is a no-op, and reset() rewinds the whole arena in
+            O(1) while keeping the chunks around for the next round (e.g. frame).
+
+            It is a std::pmr::memory_resource, so it can back soa_array, pmr
+            containers or anything else taking a resource. Not thread safe: use
+            one arena per thread.
+        */
+        class aligned_arena : public std::pmr::memory_resource {
+        public:
+            constexpr static size_t default_chunk_size = 64 * 1024;
+
+            explicit aligned_arena(size_t chunk_size = default_chunk_size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+            aligned_arena(aligned_arena const&) = delete;
+            aligned_arena& operator=(aligned_arena const&) = delete;
+            ~aligned_arena() override;
+
+            // room for count elements, aligned and padded for vector<T, LEN>
+            template<typename T, size_t LEN = native_length<T>>
+            T* allocate_array(size_t count);
+
+            // makes everything allocated so far invalid, keeps the chunks
+            void reset() noexcept;
+            // hands every chunk back upstream
+            void release() noexcept;
+
+            size_t bytes_allocated() const noexcept;
+            size_t bytes_reserved() const noexcept;
+            std::pmr::memory_resource* upstream_resource() const noexcept;
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+        private:
+            // sits at the start of every chunk
+            struct chunk {
+                chunk* next;
+                size_t size;
+            };
+            constexpr static size_t chunk_alignment = 64;
+            constexpr static size_t header_size = (sizeof(chunk) + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+
+            void* allocate_from(chunk* from, size_t bytes, size_t alignment) noexcept;
+            void use_chunk(chunk* next) noexcept;
+
+            std::pmr::memory_resource* upstream;
+            size_t chunk_size;
+            chunk* first = nullptr;
+            chunk* current = nullptr;
+            uintptr_t cursor = 0;
+            uintptr_t limit = 0;
+            // bytes handed out in the chunks before current
+            size_t filled = 0;
+        };
+
+        inline aligned_arena::aligned_arena(size_t chunk_size_, std::pmr::memory_resource* upstream_) noexcept :
+            upstream(upstream_), chunk_size(chunk_size_ < header_size * 2 ? header_size * 2 : chunk_size_) {}
+
+        inline aligned_arena::~aligned_arena() {
+            release();
+        }
+
+        template<typename T, size_t LEN>
+        inline T* aligned_arena::allocate_array(size_t count) {
+            constexpr size_t register_entries = simd_traits<T, LEN>::num_entries;
+            const size_t padded = (count + register_entries - 1) / register_entries * register_entries;
+            return static_cast<T*>(allocate(padded * sizeof(T), vectorized_alignment<T, LEN>));
+        }
+
+        inline void aligned_arena::reset() noexcept {
+            filled = 0;
+            current = nullptr;
+            cursor = 0;
+            limit = 0;
+            if (first != nullptr) {
+                use_chunk(first);
+            }
+        }
+
+        inline void aligned_arena::release() noexcept {
+            chunk* iter = first;
+            while (iter != nullptr) {
+                chunk* next = iter->next;
+                upstream->deallocate(iter, iter->size, chunk_alignment);
+                iter = next;
+            }
+            first = nullptr;
+            current = nullptr;
+            cursor = 0;
+            limit = 0;
+            filled = 0;
+        }
+
+        inline size_t aligned_arena::bytes_allocated() const noexcept {
+            return current == nullptr ? 0 : filled + (cursor - (reinterpret_cast<uintptr_t>(current) + header_size));
+        }
+
+        inline size_t aligned_arena::bytes_reserved() const noexcept {
+            size_t result = 0;
+            for (chunk* iter = first; iter != nullptr; iter = iter->next) {
+                result += iter->size;
+            }
+            return result;
+        }
+
+        inline std::pmr::memory_resource* aligned_arena::upstream_resource() const noexcept {
+            return upstream;
+        }
+
+        inline void* aligned_arena::do_allocate(size_t bytes, size_t alignment) {
+            if (void* result = allocate_from(current, bytes, alignment)) {
+                return result;
+            }
+            // chunks left over from before the last reset() get reused first
+            chunk* prev = current;
+            chunk* next = current == nullptr ? first : current->next;
+            const size_t needed = header_size + bytes + (alignment > chunk_alignment ? alignment : 0);
+            if (next == nullptr || next->size < needed) {
+                const size_t size = needed > chunk_size ? needed : chunk_size;
+                chunk* fresh = static_cast<chunk*>(upstream->allocate(size, chunk_alignment));
+                fresh->size = size;
+                fresh->next = next;
+                if (prev == nullptr) {
+                    first = fresh;
+                }
+                else {
+                    prev->next = fresh;
+                }
+                next = fresh;
+            }
+            if (current != nullptr) {
+                filled += cursor - (reinterpret_cast<uintptr_t>(current) + header_size);
+            }
+            use_chunk(next);
+            return allocate_from(current, bytes, alignment);
+        }
+
+        inline void aligned_arena::do_deallocate(void*, size_t, size_t) {
+            // monotonic: memory comes back on reset() or release()
+        }
+
+        inline bool aligned_arena::do_is_equal(std::pmr::memory_resource const& other) const noexcept {
+            return this == &other;
+        }
+
+        inline void* aligned_arena::allocate_from(chunk* from, size_t bytes, size_t alignment) noexcept {
+            if (from == nullptr) {
+                return nullptr;
+            }
+            const uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            if (aligned > limit || limit - aligned < bytes) {
+                return nullptr;
+            }
+            cursor = aligned + bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        inline void aligned_arena::use_chunk(chunk* next) noexcept {
+            current = next;
+            cursor = reinterpret_cast<uintptr_t>(next) + header_size;
+            limit = reinterpret_cast<uintptr_t>(next) + next->size;
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_ALIGNED_ARENA_HPP
@@ -0,0 +1,476 @@
+#pragma once
+#ifndef SIMD_WRAP_CONVERT_HPP
+#define SIMD_WRAP_CONVERT_HPP
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "transform.hpp"
+
+namespace sw {
+
+    /*
+        How conversions to integers round: nearest is ties to even, the rest
+        are floor, ceil and truncation. They don't depend on the rounding mode
+        in MXCSR. Float results (double to float, int64 to double) always round
+        to nearest.
+    */
+    enum class rounding {
+        nearest,
+        down,
+        up,
+        toward_zero
+    };
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            /*
+                Reinterprets a register as one of another width: the low bits
+                of a wider one, or a narrower one zero extended. For the
+                conversions that change the number of bytes per lane.
+            */
+            template<typename To, typename From>
+            To resize_register(From a) noexcept {
+                using from_int = int_register_t<From>;
+                using to_int = int_register_t<To>;
+                const from_int bits = bit_cast_register<from_int>(a);
+                to_int resized;
+                if constexpr (sizeof(From) == sizeof(To)) {
+                    resized = bit_cast_register<to_int>(bits);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (sizeof(From) == 16 && sizeof(To) == 32) {
+                    resized = _mm256_zextsi128_si256(bits);
+                }
+                else if constexpr (sizeof(From) == 16) {
+                    resized = _mm512_zextsi128_si512(bits);
+                }
+                else if constexpr (sizeof(From) == 32 && sizeof(To) == 64) {
+                    resized = _mm512_zextsi256_si512(bits);
+                }
+                else if constexpr (sizeof(From) == 32) {
+                    resized = _mm256_castsi256_si128(bits);
+                }
+                else if constexpr (sizeof(To) == 32) {
+                    resized = _mm512_castsi512_si256(bits);
+                }
+                else {
+                    resized = _mm512_castsi512_si128(bits);
+                }
+#endif
+                return bit_cast_register<To>(resized);
+            }
+
+#if !defined(SW_GENERIC_VECTORS)
+            template<rounding MODE>
+            constexpr int rounding_immediate = (MODE == rounding::nearest ? _MM_FROUND_TO_NEAREST_INT :
+                MODE == rounding::down ? _MM_FROUND_TO_NEG_INF : MODE == rounding::up ? _MM_FROUND_TO_POS_INF : _MM_FROUND_TO_ZERO) | _MM_FROUND_NO_EXC;
+#endif
+
+            // float lanes rounded to integral values
+            template<typename T, size_t LEN, rounding MODE>
+            vector_type_t<T, LEN> round_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    for (size_t i = 0; i < simd_traits<T, LEN>::num_entries; ++i) {
+                        if constexpr (MODE == rounding::nearest) {
+                            a[i] = round_even_val(a[i]);
+                        }
+                        else if constexpr (MODE == rounding::down) {
+                            a[i] = std::floor(a[i]);
+                        }
+                        else if constexpr (MODE == rounding::up) {
+                            a[i] = std::ceil(a[i]);
+                        }
+                        else {
+                            a[i] = std::trunc(a[i]);
+                        }
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                constexpr int mode = rounding_immediate<MODE>;
+                if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_round_ps(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_round_pd(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_round_ps(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_round_pd(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_roundscale_ps(a, mode);
+                }
+                else {
+                    return _mm512_roundscale_pd(a, mode);
+                }
+#endif
+            }
+
+#if !defined(SW_GENERIC_VECTORS)
+            /*
+                int64 to double without AVX-512DQ, exact up to the final rounding:
+                the upper and lower 32 bits are put under the mantissas of two
+                large powers of two, which are then subtracted back out.
+            */
+            template<typename Register>
+            auto int64_to_double_vals(Register a) noexcept {
+                if constexpr (std::is_same_v<Register, __m256i>) {
+                    const __m256i low = _mm256_blend_epi32(_mm256_set1_epi64x(0x4330000000000000), a, 0x55);
+                    const __m256i high = _mm256_xor_si256(_mm256_srli_epi64(a, 32), _mm256_set1_epi64x(0x4530000080000000));
+                    const __m256d upper = _mm256_sub_pd(_mm256_castsi256_pd(high), _mm256_castsi256_pd(_mm256_set1_epi64x(0x4530000080100000)));
+                    return _mm256_add_pd(upper, _mm256_castsi256_pd(low));
+                }
+                else {
+                    const __m128i low = _mm_blend_epi16(_mm_set1_epi64x(0x4330000000000000), a, 0x33);
+                    const __m128i high = _mm_xor_si128(_mm_srli_epi64(a, 32), _mm_set1_epi64x(0x4530000080000000));
+                    const __m128d upper = _mm_sub_pd(_mm_castsi128_pd(high), _mm_castsi128_pd(_mm_set1_epi64x(0x4530000080100000)));
+                    return _mm_add_pd(upper, _mm_castsi128_pd(low));
+                }
+            }
+
+            /*
+                Integral doubles to int64 without AVX-512DQ. The magic number add
+                is only exact below 2^51, so |a| is split into its upper and lower
+                32 bits as doubles first, each converted on its own and put back
+                together before the sign is applied. NaN and |a| >= 2^63 give the
+                most negative value, like cvttpd2qq.
+            */
+            template<typename Register>
+            auto double_to_int64_vals(Register a) noexcept {
+                constexpr double magic = 4503599627370496.0; // 2^52, both halves are below 2^32
+                constexpr double two_32 = 4294967296.0;
+                constexpr double two_63 = 9223372036854775808.0;
+                if constexpr (std::is_same_v<Register, __m256d>) {
+                    const __m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+                    const __m256d high = _mm256_round_pd(_mm256_mul_pd(magnitude, _mm256_set1_pd(1.0 / two_32)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+                    const __m256d low = _mm256_sub_pd(magnitude, _mm256_mul_pd(high, _mm256_set1_pd(two_32)));
+                    const __m256i magic_bits = _mm256_castpd_si256(_mm256_set1_pd(magic));
+                    const __m256i high_bits = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(high, _mm256_set1_pd(magic))), magic_bits);
+                    const __m256i low_bits = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(low, _mm256_set1_pd(magic))), magic_bits);
+                    const __m256i unsigned_result = _mm256_add_epi64(_mm256_slli_epi64(high_bits, 32), low_bits);
+                    const __m256i negative = _mm256_castpd_si256(_mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_LT_OQ));
+                    const __m256i result = _mm256_sub_epi64(_mm256_xor_si256(unsigned_result, negative), negative);
+                    const __m256d out_of_range = _mm256_cmp_pd(magnitude, _mm256_set1_pd(two_63), _CMP_NLT_UQ);
+                    return _mm256_blendv_epi8(result, _mm256_set1_epi64x(std::numeric_limits<int64_t>::min()), _mm256_castpd_si256(out_of_range));
+                }
+                else {
+                    const __m128d magnitude = _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+                    const __m128d high = _mm_round_pd(_mm_mul_pd(magnitude, _mm_set1_pd(1.0 / two_32)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+                    const __m128d low = _mm_sub_pd(magnitude, _mm_mul_pd(high, _mm_set1_pd(two_32)));
+                    const __m128i magic_bits = _mm_castpd_si128(_mm_set1_pd(magic));
+                    const __m128i high_bits = _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(high, _mm_set1_pd(magic))), magic_bits);
+                    const __m128i low_bits = _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(low, _mm_set1_pd(magic))), magic_bits);
+                    const __m128i unsigned_result = _mm_add_epi64(_mm_slli_epi64(high_bits, 32), low_bits);
+                    const __m128i negative = _mm_castpd_si128(_mm_cmplt_pd(a, _mm_setzero_pd()));
+                    const __m128i result = _mm_sub_epi64(_mm_xor_si128(unsigned_result, negative), negative);
+                    const __m128d out_of_range = _mm_cmpnlt_pd(magnitude, _mm_set1_pd(two_63));
+                    return _mm_blendv_epi8(result, _mm_set1_epi64x(std::numeric_limits<int64_t>::min()), _mm_castpd_si128(out_of_range));
+                }
+            }
+#endif
+
+            template<typename T>
+            constexpr bool is_convertible_lane_v = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>;
+
+            /*
+                Lane i of the result is lane i of a converted, the registers on
+                either side are whatever LEN lanes of the type take. Floats to
+                integers are rounded with MODE first and then truncated, lanes
+                out of the integer range give the most negative value (the x86
+                "integer indefinite"). int64 to int32 keeps the low bits.
+            */
+            template<typename From, typename To, size_t LEN, rounding MODE>
+            vector_type_t<To, LEN> convert_vals(vector_type_t<From, LEN> a) noexcept {
+                using source_type = vector_type_t<From, LEN>;
+                using result_type = vector_type_t<To, LEN>;
+                static_assert(is_convertible_lane_v<From> && is_convertible_lane_v<To>, "Conversions are implemented between float, double, int32_t and int64_t lanes.");
+                constexpr bool rounds = std::is_floating_point_v<From> && std::is_integral_v<To> && MODE != rounding::toward_zero;
+                if constexpr (std::is_same_v<From, To>) {
+                    return a;
+                }
+                else if constexpr (rounds) {
+                    // truncating what is already integral rounds with MODE
+                    return convert_vals<From, To, LEN, rounding::toward_zero>(round_vals<From, LEN, MODE>(a));
+                }
+                else if constexpr (USE_GENERIC_VECTORS) {
+                    // lane by lane, out of range lanes set to the x86 result instead of being undefined
+                    result_type result{};
+                    for (size_t i = 0; i < LEN; ++i) {
+                        if constexpr (std::is_floating_point_v<From> && std::is_integral_v<To>) {
+                            constexpr From lowest = From(std::numeric_limits<To>::min());
+                            result[i] = a[i] >= lowest && a[i] < -lowest ? To(a[i]) : std::numeric_limits<To>::min();
+                        }
+                        else {
+                            result[i] = To(a[i]);
+                        }
+                    }
+                    return result;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<From, float> && std::is_same_v<To, int32_t>) {
+                    if constexpr (std::is_same_v<source_type, __m512>) {
+                        return _mm512_cvttps_epi32(a);
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256>) {
+                        return _mm256_cvttps_epi32(a);
+                    }
+                    else {
+                        return _mm_cvttps_epi32(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int32_t> && std::is_same_v<To, float>) {
+                    if constexpr (std::is_same_v<source_type, __m512i>) {
+                        return _mm512_cvtepi32_ps(a);
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256i>) {
+                        return _mm256_cvtepi32_ps(a);
+                    }
+                    else {
+                        return _mm_cvtepi32_ps(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<From, float> && std::is_same_v<To, double>) {
+                    if constexpr (std::is_same_v<result_type, __m512d>) {
+                        return _mm512_cvtps_pd(resize_register<__m256>(a));
+                    }
+                    else if constexpr (std::is_same_v<result_type, __m256d>) {
+                        return _mm256_cvtps_pd(resize_register<__m128>(a));
+                    }
+                    else {
+                        return _mm_cvtps_pd(resize_register<__m128>(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int32_t> && std::is_same_v<To, double>) {
+                    if constexpr (std::is_same_v<result_type, __m512d>) {
+                        return _mm512_cvtepi32_pd(resize_register<__m256i>(a));
+                    }
+                    else if constexpr (std::is_same_v<result_type, __m256d>) {
+                        return _mm256_cvtepi32_pd(resize_register<__m128i>(a));
+                    }
+                    else {
+                        return _mm_cvtepi32_pd(resize_register<__m128i>(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int32_t> && std::is_same_v<To, int64_t>) {
+                    if constexpr (std::is_same_v<result_type, __m512i>) {
+                        return _mm512_cvtepi32_epi64(resize_register<__m256i>(a));
+                    }
+                    else if constexpr (std::is_same_v<result_type, __m256i>) {
+                        return _mm256_cvtepi32_epi64(resize_register<__m128i>(a));
+                    }
+                    else {
+                        return _mm_cvtepi32_epi64(resize_register<__m128i>(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, double> && std::is_same_v<To, float>) {
+                    if constexpr (std::is_same_v<source_type, __m512d>) {
+                        return resize_register<result_type>(_mm512_cvtpd_ps(a));
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256d>) {
+                        return resize_register<result_type>(_mm256_cvtpd_ps(a));
+                    }
+                    else {
+                        return resize_register<result_type>(_mm_cvtpd_ps(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, double> && std::is_same_v<To, int32_t>) {
+                    if constexpr (std::is_same_v<source_type, __m512d>) {
+                        return resize_register<result_type>(_mm512_cvttpd_epi32(a));
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256d>) {
+                        return resize_register<result_type>(_mm256_cvttpd_epi32(a));
+                    }
+                    else {
+                        return resize_register<result_type>(_mm_cvttpd_epi32(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int64_t> && std::is_same_v<To, int32_t>) {
+                    if constexpr (std::is_same_v<source_type, __m512i>) {
+                        return resize_register<result_type>(_mm512_cvtepi64_epi32(a));
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS && std::is_same_v<source_type, __m256i>) {
+                        return resize_register<result_type>(_mm256_cvtepi64_epi32(a));
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256i>) {
+                        const __m256i even = _mm256_permutevar8x32_epi32(a, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+                        return resize_register<result_type>(_mm256_castsi256_si128(even));
+                    }
+                    else {
+                        return resize_register<result_type>(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 2, 0)));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int64_t> && std::is_same_v<To, double>) {
+                    if constexpr (std::is_same_v<source_type, __m512i>) {
+                        return _mm512_cvtepi64_pd(a);
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS && std::is_same_v<source_type, __m256i>) {
+                        return _mm256_cvtepi64_pd(a);
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS) {
+                        return _mm_cvtepi64_pd(a);
+                    }
+                    else {
+                        return int64_to_double_vals(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<From, double> && std::is_same_v<To, int64_t>) {
+                    if constexpr (std::is_same_v<source_type, __m512d>) {
+                        return _mm512_cvttpd_epi64(a);
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS && std::is_same_v<source_type, __m256d>) {
+                        return _mm256_cvttpd_epi64(a);
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS) {
+                        return _mm_cvttpd_epi64(a);
+                    }
+                    else {
+                        // the split into halves needs a to be integral already
+                        return double_to_int64_vals(round_vals<double, LEN, rounding::toward_zero>(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int64_t> && std::is_same_v<To, float> && USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<source_type, __m512i>) {
+                        return resize_register<result_type>(_mm512_cvtepi64_ps(a));
+                    }
+                    else if constexpr (std::is_same_v<source_type, __m256i>) {
+                        return resize_register<result_type>(_mm256_cvtepi64_ps(a));
+                    }
+                    else {
+                        return resize_register<result_type>(_mm_cvtepi64_ps(a));
+                    }
+                }
+                else if constexpr (std::is_same_v<From, int64_t> && std::is_same_v<To, float>) {
+                    // rounds twice past 2^53, where float only has every 2^30th integer anyway
+                    return convert_vals<double, float, LEN, MODE>(convert_vals<int64_t, double, LEN, MODE>(a));
+                }
+                else {
+                    // float to int64, exact through double
+                    return convert_vals<double, To, LEN, MODE>(convert_vals<From, double, LEN, MODE>(a));
+                }
+#endif
+            }
+
+        }
+
+        /*
+            Lane-wise conversion to a vector of To with the same number of lanes,
+            between float, double, int32_t and int64_t. The register may change
+            width, 4 floats in 128 bits become 4 doubles in 256. See rounding for
+            how floats become integers; NaN and out of range lanes give the most
+            negative integer.
+        */
+        template<typename To, rounding MODE = rounding::nearest, typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        vector<To, EXPR::length> convert(EXPR const& v) noexcept {
+            using value_type = typename EXPR::value_type;
+            return vector<To, EXPR::length>(detail::convert_vals<value_type, To, EXPR::length, MODE>(v()));
+        }
+
+        // The first LEN / 2 lanes of a full register, in a register half as wide
+        template<typename T, size_t LEN>
+        vector<T, LEN / 2> low_half(vector<T, LEN> const& v) noexcept {
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0 && LEN % 2 == 0, "low_half works on whole registers.");
+            return vector<T, LEN / 2>(detail::resize_register<detail::vector_type_t<T, LEN / 2>>(v()));
+        }
+
+        template<typename T, size_t LEN>
+        vector<T, LEN / 2> high_half(vector<T, LEN> const& v) noexcept {
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0 && LEN % 2 == 0, "high_half works on whole registers.");
+            using int_type = detail::int_register_t<detail::vector_type_t<T, LEN>>;
+            const int_type bits = detail::bit_cast_register<int_type>(v());
+            using half_type = detail::int_register_t<detail::vector_type_t<T, LEN / 2>>;
+            half_type upper;
+            if constexpr (USE_GENERIC_VECTORS) {
+                upper = half_type{};
+                for (size_t i = 0; i < LEN / 2; ++i) {
+                    upper[i] = bits[LEN / 2 + i];
+                }
+            }
+#if !defined(SW_GENERIC_VECTORS)
+            else if constexpr (std::is_same_v<int_type, __m512i>) {
+                upper = _mm512_extracti64x4_epi64(bits, 1);
+            }
+            else if constexpr (std::is_same_v<int_type, __m256i>) {
+                upper = _mm256_extracti128_si256(bits, 1);
+            }
+            else {
+                upper = _mm_unpackhi_epi64(bits, _mm_setzero_si128());
+            }
+#endif
+            return vector<T, LEN / 2>(detail::bit_cast_register<detail::vector_type_t<T, LEN / 2>>(upper));
+        }
+
+        // The lanes of a followed by those of b, both whole registers or half of a 128 bit one
+        template<typename T, size_t LEN>
+        vector<T, LEN * 2> combine(vector<T, LEN> const& a, vector<T, LEN> const& b) noexcept {
+            using int_type = detail::int_register_t<detail::vector_type_t<T, LEN>>;
+            using result_type = detail::vector_type_t<T, LEN * 2>;
+            static_assert(sizeof(T) * LEN * 2 == sizeof(result_type), "combine needs two halves of a register.");
+            const int_type low = detail::bit_cast_register<int_type>(a());
+            const int_type high = detail::bit_cast_register<int_type>(b());
+            using both_type = detail::int_register_t<result_type>;
+            both_type both;
+            if constexpr (USE_GENERIC_VECTORS) {
+                both = both_type{};
+                for (size_t i = 0; i < LEN; ++i) {
+                    both[i] = low[i];
+                    both[LEN + i] = high[i];
+                }
+            }
+#if !defined(SW_GENERIC_VECTORS)
+            else if constexpr (sizeof(result_type) == 64) {
+                both = _mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1);
+            }
+            else if constexpr (sizeof(result_type) == 32) {
+                both = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+            }
+            else {
+                both = _mm_unpacklo_epi64(low, high);
+            }
+#endif
+            return vector<T, LEN * 2>(detail::bit_cast_register<result_type>(both));
+        }
+
+        /*
+            Converts two vectors and puts the results together, for conversions
+            to a narrower type: two registers of 4 doubles give one of 8 floats.
+            Going the other way, convert low_half and high_half separately.
+        */
+        template<typename To, rounding MODE = rounding::nearest, typename T, size_t LEN>
+        vector<To, LEN * 2> convert(vector<T, LEN> const& a, vector<T, LEN> const& b) noexcept {
+            return combine(convert<To, MODE>(a), convert<To, MODE>(b));
+        }
+
+        /*
+            out[i] = in[i] converted as above, for whole columns. Works a register
+            of the wider of the two types at a time.
+        */
+        template<rounding MODE = rounding::nearest, typename I0, typename To>
+        void convert(span<I0> in, span<To> out) noexcept {
+            using From = std::remove_const_t<I0>;
+            constexpr size_t lanes = std::min(native_length<From>, native_length<To>);
+            assert(in.size() >= out.size());
+            const From* src = in.data();
+            To* dst = out.data();
+            const size_t count = out.size();
+            size_t i = 0;
+            for (; i + 2 * lanes <= count; i += 2 * lanes) {
+                convert<To, MODE>(vector<From, lanes>::load_unaligned(src + i)).store_unaligned(dst + i);
+                convert<To, MODE>(vector<From, lanes>::load_unaligned(src + i + lanes)).store_unaligned(dst + i + lanes);
+            }
+            for (; i < count; i += lanes) {
+                convert<To, MODE>(vector<From, lanes>::load_partial(src + i, count - i)).store_partial(dst + i, count - i);
+            }
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_CONVERT_HPP
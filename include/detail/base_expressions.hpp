@@ -3,94 +3,245 @@
 #define SIMD_WRAP_EXPRESSION_TEMPLATES_BASE_EXPRESSIONS_HPP
 #include <cstddef>
 #include <cstdint>
-#include <immintrin.h>
+#include <utility>
 #include "expr_helpers.hpp"
 #include "simd_traits.hpp"
 namespace sw {
 
-    namespace detail {
+    inline namespace SW_ISA_NAMESPACE {
 
-        template<typename T, size_t LEN>
-        decltype(auto) broadcast_val(T val) noexcept {
-            using vector_type = typename simd_traits<T, LEN>::vector_type;
-            if constexpr (!std::is_same_v<platform_type, arm_platform_tag>) {
-                if constexpr (std::is_same_v<vector_type, __m128>) {
-                    return _mm_set1_ps(val);
-                }
-                else if constexpr (std::is_same_v<vector_type, __m128d>) {
-                    return _mm_set1_pd(val);
-                }
-                else if constexpr (std::is_same_v<vector_type, __m256>) {
-                    return _mm256_set1_ps(val);
-                }
-                else if constexpr (std::is_same_v<vector_type, __m256d>) {
-                    return _mm256_set1_pd(val);
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            decltype(auto) broadcast_val(T val) noexcept {
+                using vector_type = typename simd_traits<T, LEN>::vector_type;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // scalars on one side of a vector operation get splat. Subtracting
+                    // zero keeps -0.0, adding it would turn that into +0.0
+                    return val - vector_type{};
                 }
-                else if constexpr (std::is_integral_v<T>) {
-                    // have to do this as integer register types support many type-lengths
-                    // will have to cast from unsigned types, as these only accept signed
-                    if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
-                        if constexpr (LEN > 16 && USE_AVX_INTRINSICS) {
-                            return _mm256_set1_epi8(static_cast<char>(val));
-                        }
-                        else {
-                            static_assert(LEN <= 16, "Length of integer vector is greater than supported on platform.");
-                            return _mm_set1_epi8(static_cast<char>(val));
-                        }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_set1_ps(val);
                     }
-                    else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) { 
-                        if constexpr (LEN > 8 && USE_AVX_INTRINSICS) {
-                            return _mm256_set1_epi16(static_cast<short>(val));
-                        }
-                        else {
-                            static_assert(LEN <= 8, "Length of integer vector is greater than supported on platform.");
-                            return _mm_set1_epi16(static_cast<short>(val));
-                        }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_set1_pd(val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_set1_ps(val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_set1_pd(val);
                     }
-                    else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) {
-                        if constexpr (LEN > 4 && USE_AVX_INTRINSICS) {
-                            return _mm256_set1_epi32(static_cast<int>(val));
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_set1_ps(val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                        return _mm512_set1_pd(val);
+                    }
+                    else if constexpr (std::is_integral_v<T>) {
+                        // have to do this as integer register types support many type-lengths
+                        // will have to cast from unsigned types, as these only accept signed
+                        if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
+                            if constexpr (LEN > 32 && USE_AVX512_INTRINSICS) {
+                                return _mm512_set1_epi8(static_cast<char>(val));
+                            }
+                            else if constexpr (LEN > 16 && USE_AVX_INTRINSICS) {
+                                return _mm256_set1_epi8(static_cast<char>(val));
+                            }
+                            else {
+                                static_assert(LEN <= 16, "Length of integer vector is greater than supported on platform.");
+                                return _mm_set1_epi8(static_cast<char>(val));
+                            }
                         }
-                        else {
-                            static_assert(LEN <= 4, "Length of integer vector is greater than supported on platform.");
-                            return _mm_set1_epi32(static_cast<int>(val));
+                        else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) { 
+                            if constexpr (LEN > 16 && USE_AVX512_INTRINSICS) {
+                                return _mm512_set1_epi16(static_cast<short>(val));
+                            }
+                            else if constexpr (LEN > 8 && USE_AVX_INTRINSICS) {
+                                return _mm256_set1_epi16(static_cast<short>(val));
+                            }
+                            else {
+                                static_assert(LEN <= 8, "Length of integer vector is greater than supported on platform.");
+                                return _mm_set1_epi16(static_cast<short>(val));
+                            }
                         }
-                    }
-                    else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
-                        if constexpr (LEN > 2 && USE_AVX_INTRINSICS) {
-                            return _mm256_set1_epi64x(static_cast<long long>(val));
+                        else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) {
+                            if constexpr (LEN > 8 && USE_AVX512_INTRINSICS) {
+                                return _mm512_set1_epi32(static_cast<int>(val));
+                            }
+                            else if constexpr (LEN > 4 && USE_AVX_INTRINSICS) {
+                                return _mm256_set1_epi32(static_cast<int>(val));
+                            }
+                            else {
+                                static_assert(LEN <= 4, "Length of integer vector is greater than supported on platform.");
+                                return _mm_set1_epi32(static_cast<int>(val));
+                            }
                         }
-                        else {
-                            static_assert(LEN <= 2, "Length of integer vector is greater than supported on platform.");
-                            return _mm_set1_epi64x(static_cast<long long>(val));
+                        else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
+                            if constexpr (LEN > 4 && USE_AVX512_INTRINSICS) {
+                                return _mm512_set1_epi64(static_cast<long long>(val));
+                            }
+                            else if constexpr (LEN > 2 && USE_AVX_INTRINSICS) {
+                                return _mm256_set1_epi64x(static_cast<long long>(val));
+                            }
+                            else {
+                                static_assert(LEN <= 2, "Length of integer vector is greater than supported on platform.");
+                                return _mm_set1_epi64x(static_cast<long long>(val));
+                            }
                         }
                     }
                 }
+#endif
             }
-            else {
-                static_assert(false, "ARM intrinsics not currently supported.");
-                // need to implement ARM intrinsics
+
+            // reinterprets the bits of a register as another register type of the same width
+            template<typename To, typename From>
+            To bit_cast_register(From val) noexcept {
+                static_assert(sizeof(To) == sizeof(From), "Can only reinterpret registers of the same width.");
+                if constexpr (std::is_same_v<To, From>) {
+                    return val;
+                }
+                else if constexpr (USE_GENERIC_VECTORS) {
+                    // casts between vectors of the same size keep the bits
+                    return (To)val;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (sizeof(From) == 16) {
+                    __m128i bits;
+                    if constexpr (std::is_same_v<From, __m128>) {
+                        bits = _mm_castps_si128(val);
+                    }
+                    else if constexpr (std::is_same_v<From, __m128d>) {
+                        bits = _mm_castpd_si128(val);
+                    }
+                    else {
+                        bits = val;
+                    }
+                    if constexpr (std::is_same_v<To, __m128>) {
+                        return _mm_castsi128_ps(bits);
+                    }
+                    else if constexpr (std::is_same_v<To, __m128d>) {
+                        return _mm_castsi128_pd(bits);
+                    }
+                    else {
+                        return bits;
+                    }
+                }
+                else if constexpr (sizeof(From) == 32) {
+                    __m256i bits;
+                    if constexpr (std::is_same_v<From, __m256>) {
+                        bits = _mm256_castps_si256(val);
+                    }
+                    else if constexpr (std::is_same_v<From, __m256d>) {
+                        bits = _mm256_castpd_si256(val);
+                    }
+                    else {
+                        bits = val;
+                    }
+                    if constexpr (std::is_same_v<To, __m256>) {
+                        return _mm256_castsi256_ps(bits);
+                    }
+                    else if constexpr (std::is_same_v<To, __m256d>) {
+                        return _mm256_castsi256_pd(bits);
+                    }
+                    else {
+                        return bits;
+                    }
+                }
+                else {
+                    __m512i bits;
+                    if constexpr (std::is_same_v<From, __m512>) {
+                        bits = _mm512_castps_si512(val);
+                    }
+                    else if constexpr (std::is_same_v<From, __m512d>) {
+                        bits = _mm512_castpd_si512(val);
+                    }
+                    else {
+                        bits = val;
+                    }
+                    if constexpr (std::is_same_v<To, __m512>) {
+                        return _mm512_castsi512_ps(bits);
+                    }
+                    else if constexpr (std::is_same_v<To, __m512d>) {
+                        return _mm512_castsi512_pd(bits);
+                    }
+                    else {
+                        return bits;
+                    }
+                }
+#endif
             }
+
+            /*
+                Lanes of a where the lane of m is all ones, of b where it is zero.
+                m is what comparing two generic registers gives, a vector of
+                signed integers as wide as the lanes.
+            */
+            template<typename Register, typename Mask>
+            Register generic_blend(Mask m, Register a, Register b) noexcept {
+                return (Register)(((Mask)a & m) | ((Mask)b & ~m));
+            }
+
         }
 
-    }
+        /*
+            Stores a scalar value, then when evaluated
+            returns the appropriate vector type for the 
+            current template parameters - this vector
+            has all it's entries set to the scalar value
+        */
+        template<typename T, size_t LEN>
+        struct broadcast_expression {
+            static_assert(is_simd_compatible<T,LEN>, "Given template parameters cannot generate a valid vector type.");
+            using value_type = T;
+            constexpr static size_t length = LEN;
+            T value;
+        public:
+            broadcast_expression(T val) noexcept : value(std::move(val)) {}
+            typename simd_traits<T,LEN>::vector_type operator()() const noexcept {
+                return detail::broadcast_val<T,LEN>(value);
+            }
+        };
+
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            struct is_expression_node<broadcast_expression<T, LEN>> : std::true_type {};
+
+            /*
+                Turns one side of a binary expression into a node: nodes pass
+                through, scalars become a broadcast_expression matching the
+                value type and length of the other side.
+            */
+            template<typename OP, typename OTHER, bool = std::is_arithmetic_v<OP>>
+            struct operand_node {
+                using type = OP;
+            };
+
+            template<typename OP, typename OTHER>
+            struct operand_node<OP, OTHER, true> {
+                using type = broadcast_expression<typename OTHER::value_type, OTHER::length>;
+            };
+
+            template<typename OP, typename OTHER>
+            using operand_node_t = typename operand_node<std::remove_cv_t<std::remove_reference_t<OP>>,
+                std::remove_cv_t<std::remove_reference_t<OTHER>>>::type;
+
+            template<typename OTHER, typename OP>
+            decltype(auto) as_operand(OP const& operand) noexcept {
+                if constexpr (std::is_arithmetic_v<OP>) {
+                    return operand_node_t<OP, OTHER>(static_cast<typename OTHER::value_type>(operand));
+                }
+                else {
+                    return (operand);
+                }
+            }
 
-    /*
-        Stores a scalar value, then when evaluated
-        returns the appropriate vector type for the 
-        current template parameters - this vector
-        has all it's entries set to the scalar value
-    */
-    template<typename T, size_t LEN>
-    struct broadcast_expression {
-        static_assert(is_simd_compatible<T,LEN>, "Given template parameters cannot generate a valid vector type.");
-        T value;
-    public:
-        broadcast_expression(T val) noexcept : value(std::move(val)) {}
-        typename simd_traits<T,LEN>::vector_type operator()() const noexcept {
-            return detail::broadcast_val<T,LEN>(value);
         }
-    };
+
+    }
 
 }
 
@@ -5,24 +5,727 @@
 
 namespace sw {
 
-    namespace detail {
+    inline namespace SW_ISA_NAMESPACE {
 
-    }
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            using vector_type_t = typename simd_traits<T, LEN>::vector_type;
+
+            template<typename T, size_t LEN>
+            decltype(auto) add_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return a + b;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_add_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_add_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_add_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_add_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_add_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_add_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm512_add_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm512_add_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm512_add_epi32(a, b);
+                    }
+                    else {
+                        return _mm512_add_epi64(a, b);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm256_add_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm256_add_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm256_add_epi32(a, b);
+                    }
+                    else {
+                        return _mm256_add_epi64(a, b);
+                    }
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m128i>, "No addition for this vector type.");
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm_add_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm_add_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm_add_epi32(a, b);
+                    }
+                    else {
+                        return _mm_add_epi64(a, b);
+                    }
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            decltype(auto) sub_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return a - b;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_sub_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_sub_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_sub_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_sub_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_sub_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_sub_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm512_sub_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm512_sub_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm512_sub_epi32(a, b);
+                    }
+                    else {
+                        return _mm512_sub_epi64(a, b);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm256_sub_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm256_sub_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm256_sub_epi32(a, b);
+                    }
+                    else {
+                        return _mm256_sub_epi64(a, b);
+                    }
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m128i>, "No subtraction for this vector type.");
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm_sub_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm_sub_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm_sub_epi32(a, b);
+                    }
+                    else {
+                        return _mm_sub_epi64(a, b);
+                    }
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            decltype(auto) mul_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return a * b;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_mul_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_mul_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_mul_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_mul_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_mul_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_mul_pd(a, b);
+                }
+                else if constexpr (sizeof(T) == 8 && !USE_AVX512_INTRINSICS) {
+                    // low 64 bits from three 32 x 32 -> 64 bit products: lo * lo + ((lo * hi + hi * lo) << 32)
+                    if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+                    }
+                    else {
+                        const __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+                        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+                    }
+                }
+                else {
+                    // 8 bit lanes have no multiply at all, 64 bit ones only with AVX-512DQ
+                    static_assert(sizeof(T) != 1, "No multiplication for this integer vector type.");
+                    if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 8) {
+                            return _mm512_mullo_epi64(a, b);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm512_mullo_epi16(a, b);
+                        }
+                        else {
+                            return _mm512_mullo_epi32(a, b);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 8) {
+                            return _mm256_mullo_epi64(a, b);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm256_mullo_epi16(a, b);
+                        }
+                        else {
+                            return _mm256_mullo_epi32(a, b);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 8) {
+                            return _mm_mullo_epi64(a, b);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm_mullo_epi16(a, b);
+                        }
+                        else {
+                            return _mm_mullo_epi32(a, b);
+                        }
+                    }
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            decltype(auto) div_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return a / b;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_div_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_div_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_div_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_div_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_div_ps(a, b);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "No division for integer vector types.");
+                    return _mm512_div_pd(a, b);
+                }
+#endif
+            }
+
+            // all bits set in the lanes where a == b, for the integer registers below AVX-512
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> int_equal_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return (vector_type)(a == b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm256_cmpeq_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm256_cmpeq_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm256_cmpeq_epi32(a, b);
+                    }
+                    else {
+                        return _mm256_cmpeq_epi64(a, b);
+                    }
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m128i>, "int_equal_vals is only implemented for 128 and 256 bit integer vectors.");
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm_cmpeq_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm_cmpeq_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm_cmpeq_epi32(a, b);
+                    }
+                    else {
+                        return _mm_cmpeq_epi64(a, b);
+                    }
+                }
+#endif
+            }
+
+            /*
+                All bits set in the lanes where a > b, signed or unsigned after T.
+                There are only signed compares below AVX-512, unsigned lanes get
+                their top bit flipped first. SSE4.1 has no 64 bit compare, that one
+                comes from the sign of b - a with the overflow corrected.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> int_greater_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // unsigned lanes compare as unsigned
+                    return (vector_type)(a > b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_unsigned_v<T>) {
+                    using signed_type = std::make_signed_t<T>;
+                    const vector_type flip = broadcast_val<T, LEN>(T(T(1) << (sizeof(T) * 8 - 1)));
+                    if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        return int_greater_vals<signed_type, LEN>(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip));
+                    }
+                    else {
+                        return int_greater_vals<signed_type, LEN>(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm256_cmpgt_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm256_cmpgt_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm256_cmpgt_epi32(a, b);
+                    }
+                    else {
+                        return _mm256_cmpgt_epi64(a, b);
+                    }
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m128i>, "int_greater_vals is only implemented for 128 and 256 bit integer vectors.");
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm_cmpgt_epi8(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm_cmpgt_epi16(a, b);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm_cmpgt_epi32(a, b);
+                    }
+                    else if constexpr (USE_AVX_INTRINSICS) {
+                        // SSE4.2, which every AVX2 level has
+                        return _mm_cmpgt_epi64(a, b);
+                    }
+                    else {
+                        // b < a: sign of (b - a) ^ ((b ^ a) & ((b - a) ^ b)), Hacker's Delight 2-12
+                        const __m128i difference = _mm_sub_epi64(b, a);
+                        const __m128i less = _mm_xor_si128(difference, _mm_and_si128(_mm_xor_si128(b, a), _mm_xor_si128(difference, b)));
+                        // spread the sign bits over their lanes
+                        return _mm_shuffle_epi32(_mm_srai_epi32(less, 31), _MM_SHUFFLE(3, 3, 1, 1));
+                    }
+                }
+#endif
+            }
 
-    template<typename OP0, typename OP1>
-    struct expression_add {
+            // lane-wise integer min or max
+            template<typename T, size_t LEN, bool MAX>
+            vector_type_t<T, LEN> int_min_max_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return MAX ? generic_blend(a > b, a, b) : generic_blend(a < b, a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (sizeof(T) == 8 && !USE_AVX512_INTRINSICS) {
+                    // no 64 bit min and max before AVX-512, blend on the compare instead
+                    const vector_type greater = int_greater_vals<T, LEN>(a, b);
+                    if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        return MAX ? _mm256_blendv_epi8(b, a, greater) : _mm256_blendv_epi8(a, b, greater);
+                    }
+                    else {
+                        return MAX ? _mm_blendv_epi8(b, a, greater) : _mm_blendv_epi8(a, b, greater);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return MAX ? (is_signed ? _mm512_max_epi8(a, b) : _mm512_max_epu8(a, b)) : (is_signed ? _mm512_min_epi8(a, b) : _mm512_min_epu8(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return MAX ? (is_signed ? _mm512_max_epi16(a, b) : _mm512_max_epu16(a, b)) : (is_signed ? _mm512_min_epi16(a, b) : _mm512_min_epu16(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return MAX ? (is_signed ? _mm512_max_epi32(a, b) : _mm512_max_epu32(a, b)) : (is_signed ? _mm512_min_epi32(a, b) : _mm512_min_epu32(a, b));
+                    }
+                    else {
+                        return MAX ? (is_signed ? _mm512_max_epi64(a, b) : _mm512_max_epu64(a, b)) : (is_signed ? _mm512_min_epi64(a, b) : _mm512_min_epu64(a, b));
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return MAX ? (is_signed ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b)) : (is_signed ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return MAX ? (is_signed ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b)) : (is_signed ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return MAX ? (is_signed ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b)) : (is_signed ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b));
+                    }
+                    else {
+                        return MAX ? (is_signed ? _mm256_max_epi64(a, b) : _mm256_max_epu64(a, b)) : (is_signed ? _mm256_min_epi64(a, b) : _mm256_min_epu64(a, b));
+                    }
+                }
+                else {
+                    if constexpr (sizeof(T) == 1) {
+                        return MAX ? (is_signed ? _mm_max_epi8(a, b) : _mm_max_epu8(a, b)) : (is_signed ? _mm_min_epi8(a, b) : _mm_min_epu8(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return MAX ? (is_signed ? _mm_max_epi16(a, b) : _mm_max_epu16(a, b)) : (is_signed ? _mm_min_epi16(a, b) : _mm_min_epu16(a, b));
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return MAX ? (is_signed ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b)) : (is_signed ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b));
+                    }
+                    else {
+                        return MAX ? (is_signed ? _mm_max_epi64(a, b) : _mm_max_epu64(a, b)) : (is_signed ? _mm_min_epi64(a, b) : _mm_min_epu64(a, b));
+                    }
+                }
+#endif
+            }
+
+            // lane-wise min, returning b when either lane is NaN (like the underlying instructions)
+            template<typename T, size_t LEN>
+            decltype(auto) min_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return generic_blend(a < b, a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_min_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_min_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_min_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_min_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_min_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_min_pd(a, b);
+                }
+                else {
+                    return int_min_max_vals<T, LEN, false>(a, b);
+                }
+#endif
+            }
+
+            // lane-wise max, same NaN behaviour as min_vals
+            template<typename T, size_t LEN>
+            decltype(auto) max_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return generic_blend(a > b, a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_max_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_max_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_max_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_max_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_max_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_max_pd(a, b);
+                }
+                else {
+                    return int_min_max_vals<T, LEN, true>(a, b);
+                }
+#endif
+            }
+
+            /*
+                Fused multiply-add helpers for the FMA contraction below. Only the
+                floating point registers have these, and only from AVX2 up.
+            */
+            template<typename T, size_t LEN>
+            decltype(auto) fmadd_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN> c) noexcept {
+#if !defined(SW_GENERIC_VECTORS)
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_fmadd_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_fmadd_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_fmadd_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_fmadd_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_fmadd_ps(a, b, c);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "No fused multiply-add for this vector type.");
+                    return _mm512_fmadd_pd(a, b, c);
+                }
+#endif
+            }
 
-        using operand_0_ref_type = typename detail::expr_node_traits<OP0>::reference_type;
-        using operand_1_ref_type = typename detail::expr_node_traits<OP1>::reference_type;
+            // a * b - c
+            template<typename T, size_t LEN>
+            decltype(auto) fmsub_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN> c) noexcept {
+#if !defined(SW_GENERIC_VECTORS)
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_fmsub_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_fmsub_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_fmsub_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_fmsub_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_fmsub_ps(a, b, c);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "No fused multiply-subtract for this vector type.");
+                    return _mm512_fmsub_pd(a, b, c);
+                }
+#endif
+            }
 
-        expression_add(OP0& operand_0, OP1& operand_1) noexcept : operand0(operand_0), 
-            operand1(operand_1) {}
-        decltype(auto) operator()() noexcept {
-            if constexpr (std::is_arithmetic_v<OP0> || std::is_arithmetic_v<OP1>) {
-                // need to add broadcast operator
+            // c - a * b
+            template<typename T, size_t LEN>
+            decltype(auto) fnmadd_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN> c) noexcept {
+#if !defined(SW_GENERIC_VECTORS)
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_fnmadd_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_fnmadd_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_fnmadd_ps(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_fnmadd_pd(a, b, c);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_fnmadd_ps(a, b, c);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "No fused negated multiply-add for this vector type.");
+                    return _mm512_fnmadd_pd(a, b, c);
+                }
+#endif
             }
+
+            /*
+                Shared state of the binary nodes: both operands have to agree on
+                value type and length, scalars have been broadcast before they get here.
+            */
+            template<typename OP0, typename OP1>
+            struct binary_expression_base {
+                static_assert(std::is_same_v<typename OP0::value_type, typename OP1::value_type>, "Operands of a binary expression must have the same value type.");
+                static_assert(OP0::length == OP1::length, "Operands of a binary expression must have the same length.");
+                using value_type = typename OP0::value_type;
+                constexpr static size_t length = OP0::length;
+                using vector_type = vector_type_t<value_type, length>;
+                using operand_0_ref_type = typename expr_node_traits<OP0>::reference_type;
+                using operand_1_ref_type = typename expr_node_traits<OP1>::reference_type;
+
+                binary_expression_base(OP0 const& operand_0, OP1 const& operand_1) noexcept : operand0(operand_0),
+                    operand1(operand_1) {}
+
+                operand_0_ref_type operand0;
+                operand_1_ref_type operand1;
+            };
+
         }
-    };
+
+        template<typename OP0, typename OP1>
+        struct expression_mul : detail::binary_expression_base<OP0, OP1> {
+            using base_type = detail::binary_expression_base<OP0, OP1>;
+            using base_type::base_type;
+            typename base_type::vector_type operator()() const noexcept {
+                return detail::mul_vals<typename base_type::value_type, base_type::length>(this->operand0(), this->operand1());
+            }
+        };
+
+        namespace detail {
+
+            template<typename T>
+            struct is_mul_node : std::false_type {};
+
+            template<typename OP0, typename OP1>
+            struct is_mul_node<expression_mul<OP0, OP1>> : std::true_type {};
+
+            // a mul node feeding an add/sub gets fused, when the registers support it
+            template<typename NODE, typename T>
+            constexpr bool is_contractible_v = CONTRACT_FMA && std::is_floating_point_v<T> && is_mul_node<NODE>::value;
+
+        }
+
+        /*
+            expression_add and expression_sub look for an expression_mul operand
+            at compile time and evaluate the pair as a single FMA instruction:
+            a*b + c -> fmadd, c + a*b -> fmadd, a*b - c -> fmsub, c - a*b -> fnmadd.
+            The product isn't rounded before the add, so results can differ from
+            the unfused form in the last bit (they're more accurate).
+        */
+        template<typename OP0, typename OP1>
+        struct expression_add : detail::binary_expression_base<OP0, OP1> {
+            using base_type = detail::binary_expression_base<OP0, OP1>;
+            using base_type::base_type;
+            typename base_type::vector_type operator()() const noexcept {
+                using value_type = typename base_type::value_type;
+                constexpr size_t length = base_type::length;
+                if constexpr (detail::is_contractible_v<OP0, value_type>) {
+                    return detail::fmadd_vals<value_type, length>(this->operand0.operand0(), this->operand0.operand1(), this->operand1());
+                }
+                else if constexpr (detail::is_contractible_v<OP1, value_type>) {
+                    return detail::fmadd_vals<value_type, length>(this->operand1.operand0(), this->operand1.operand1(), this->operand0());
+                }
+                else {
+                    return detail::add_vals<value_type, length>(this->operand0(), this->operand1());
+                }
+            }
+        };
+
+        template<typename OP0, typename OP1>
+        struct expression_sub : detail::binary_expression_base<OP0, OP1> {
+            using base_type = detail::binary_expression_base<OP0, OP1>;
+            using base_type::base_type;
+            typename base_type::vector_type operator()() const noexcept {
+                using value_type = typename base_type::value_type;
+                constexpr size_t length = base_type::length;
+                if constexpr (detail::is_contractible_v<OP0, value_type>) {
+                    return detail::fmsub_vals<value_type, length>(this->operand0.operand0(), this->operand0.operand1(), this->operand1());
+                }
+                else if constexpr (detail::is_contractible_v<OP1, value_type>) {
+                    return detail::fnmadd_vals<value_type, length>(this->operand1.operand0(), this->operand1.operand1(), this->operand0());
+                }
+                else {
+                    return detail::sub_vals<value_type, length>(this->operand0(), this->operand1());
+                }
+            }
+        };
+
+        template<typename OP0, typename OP1>
+        struct expression_div : detail::binary_expression_base<OP0, OP1> {
+            using base_type = detail::binary_expression_base<OP0, OP1>;
+            using base_type::base_type;
+            typename base_type::vector_type operator()() const noexcept {
+                return detail::div_vals<typename base_type::value_type, base_type::length>(this->operand0(), this->operand1());
+            }
+        };
+
+        namespace detail {
+
+            template<typename OP0, typename OP1>
+            struct is_expression_node<expression_mul<OP0, OP1>> : std::true_type {};
+            template<typename OP0, typename OP1>
+            struct is_expression_node<expression_add<OP0, OP1>> : std::true_type {};
+            template<typename OP0, typename OP1>
+            struct is_expression_node<expression_sub<OP0, OP1>> : std::true_type {};
+            template<typename OP0, typename OP1>
+            struct is_expression_node<expression_div<OP0, OP1>> : std::true_type {};
+
+            // the node type (or the scalar) on the other side of a binary operator
+            template<typename OP0, typename OP1>
+            using other_operand_t = std::conditional_t<is_expression_node_v<OP0>, OP0, OP1>;
+
+        }
+
+        /*
+            Operators only build the tree, nothing is computed until a node is
+            assigned to (or used to construct) a vector. Scalars on either side
+            get broadcast to the other operand's type.
+        */
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator+(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            using other_type = detail::other_operand_t<OP0, OP1>;
+            return expression_add<detail::operand_node_t<OP0, other_type>, detail::operand_node_t<OP1, other_type>>(
+                detail::as_operand<other_type>(operand_0), detail::as_operand<other_type>(operand_1));
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator-(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            using other_type = detail::other_operand_t<OP0, OP1>;
+            return expression_sub<detail::operand_node_t<OP0, other_type>, detail::operand_node_t<OP1, other_type>>(
+                detail::as_operand<other_type>(operand_0), detail::as_operand<other_type>(operand_1));
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator*(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            using other_type = detail::other_operand_t<OP0, OP1>;
+            return expression_mul<detail::operand_node_t<OP0, other_type>, detail::operand_node_t<OP1, other_type>>(
+                detail::as_operand<other_type>(operand_0), detail::as_operand<other_type>(operand_1));
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator/(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            using other_type = detail::other_operand_t<OP0, OP1>;
+            return expression_div<detail::operand_node_t<OP0, other_type>, detail::operand_node_t<OP1, other_type>>(
+                detail::as_operand<other_type>(operand_0), detail::as_operand<other_type>(operand_1));
+        }
+
+    }
 
 }
 
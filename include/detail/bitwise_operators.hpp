@@ -0,0 +1,464 @@
+#pragma once
+#ifndef SIMD_WRAP_DETAIL_BITWISE_OPERATORS_HPP
+#define SIMD_WRAP_DETAIL_BITWISE_OPERATORS_HPP
+#include <cmath>
+#include <limits>
+#include "compare_operators.hpp"
+
+/*
+    Bit level building blocks for the math functions: logic on floating point
+    registers, rounding, and integer arithmetic on the bits of a floating point
+    register (one int32 lane per float, one int64 lane per double).
+*/
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            template<typename Register>
+            struct int_register_proxy {
+                constexpr static auto get_type() noexcept {
+                    if constexpr (USE_GENERIC_VECTORS) {
+                        // integer registers already are their own bits, unsigned lanes included
+                        if constexpr (std::is_floating_point_v<generic_lane_t<Register>>) {
+                            return generic_mask_t<Register>();
+                        }
+                        else {
+                            return Register();
+                        }
+                    }
+#if !defined(SW_GENERIC_VECTORS)
+                    else if constexpr (sizeof(Register) == 16) {
+                        return __m128i();
+                    }
+                    else if constexpr (sizeof(Register) == 32) {
+                        return __m256i();
+                    }
+                    else {
+                        return __m512i();
+                    }
+#endif
+                }
+                using type = decltype(get_type());
+            };
+
+            template<typename Register>
+            using int_register_t = typename int_register_proxy<Register>::type;
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> and_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // the operators only exist for integer vectors, floats go through their bits
+                    using bits = generic_mask_t<vector_type>;
+                    const bits x = (bits)a;
+                    const bits y = (bits)b;
+                    return (vector_type)(x & y);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_and_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_and_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_and_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_and_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_and_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_and_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_and_si512(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_and_si256(a, b);
+                }
+                else {
+                    return _mm_and_si128(a, b);
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> or_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using bits = generic_mask_t<vector_type>;
+                    const bits x = (bits)a;
+                    const bits y = (bits)b;
+                    return (vector_type)(x | y);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_or_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_or_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_or_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_or_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_or_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_or_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_or_si512(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_or_si256(a, b);
+                }
+                else {
+                    return _mm_or_si128(a, b);
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> xor_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using bits = generic_mask_t<vector_type>;
+                    const bits x = (bits)a;
+                    const bits y = (bits)b;
+                    return (vector_type)(x ^ y);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_xor_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_xor_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_xor_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_xor_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_xor_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_xor_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_xor_si512(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_xor_si256(a, b);
+                }
+                else {
+                    return _mm_xor_si128(a, b);
+                }
+#endif
+            }
+
+            // ~a & b, like the instruction
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> andnot_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using bits = generic_mask_t<vector_type>;
+                    const bits x = (bits)a;
+                    const bits y = (bits)b;
+                    return (vector_type)(~x & y);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_andnot_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_andnot_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_andnot_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_andnot_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_andnot_ps(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return _mm512_andnot_pd(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_andnot_si512(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_andnot_si256(a, b);
+                }
+                else {
+                    return _mm_andnot_si128(a, b);
+                }
+#endif
+            }
+
+            // floats clear the sign bit, integers negate (and INT_MIN stays INT_MIN, like the instructions)
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> abs_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (std::is_floating_point_v<T>) {
+                    return andnot_vals<T, LEN>(broadcast_val<T, LEN>(T(-0.0)), a);
+                }
+                else if constexpr (std::is_unsigned_v<T>) {
+                    return a;
+                }
+                else if constexpr (USE_GENERIC_VECTORS) {
+                    return generic_blend(a < 0, -a, a);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (sizeof(T) == 8 && !USE_AVX512_INTRINSICS) {
+                    const vector_type zero{};
+                    return select_vals<T, LEN>(int_greater_vals<T, LEN>(zero, a), sub_vals<T, LEN>(zero, a), a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm512_abs_epi8(a);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm512_abs_epi16(a);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm512_abs_epi32(a);
+                    }
+                    else {
+                        return _mm512_abs_epi64(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm256_abs_epi8(a);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm256_abs_epi16(a);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm256_abs_epi32(a);
+                    }
+                    else {
+                        return _mm256_abs_epi64(a);
+                    }
+                }
+                else {
+                    if constexpr (sizeof(T) == 1) {
+                        return _mm_abs_epi8(a);
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        return _mm_abs_epi16(a);
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        return _mm_abs_epi32(a);
+                    }
+                    else {
+                        return _mm_abs_epi64(a);
+                    }
+                }
+#endif
+            }
+
+            // just the sign bits of a
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> sign_vals(vector_type_t<T, LEN> a) noexcept {
+                return and_vals<T, LEN>(broadcast_val<T, LEN>(T(-0.0)), a);
+            }
+
+            /*
+                Scalar ties to even that ignores fesetround, unlike std::nearbyint.
+                remainder(x, 1) is exact and always rounds the quotient to even.
+                From 1 / epsilon up every value is integral already, that also lets
+                inf and NaN through untouched.
+            */
+            template<typename T>
+            T round_even_val(T x) noexcept {
+                if (!(std::abs(x) < T(1) / std::numeric_limits<T>::epsilon())) {
+                    return x;
+                }
+                // copysign keeps -0.0 for -0.5 and the like
+                return std::copysign(x - std::remainder(x, T(1)), x);
+            }
+
+            // to the nearest integer, ties to even
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> round_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        a[i] = round_even_val(a[i]);
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                constexpr int mode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+                if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_round_ps(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_round_pd(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_round_ps(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_round_pd(a, mode);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_roundscale_ps(a, mode);
+                }
+                else {
+                    return _mm512_roundscale_pd(a, mode);
+                }
+#endif
+            }
+
+            // fused where the level has fma, otherwise a * b + c with two roundings
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> mul_add_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN> c) noexcept {
+                if constexpr (USE_FMA_INTRINSICS) {
+                    return fmadd_vals<T, LEN>(a, b, c);
+                }
+                else {
+                    return add_vals<T, LEN>(mul_vals<T, LEN>(a, b), c);
+                }
+            }
+
+            // c - a * b
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> neg_mul_add_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN> c) noexcept {
+                if constexpr (USE_FMA_INTRINSICS) {
+                    return fnmadd_vals<T, LEN>(a, b, c);
+                }
+                else {
+                    return sub_vals<T, LEN>(c, mul_vals<T, LEN>(a, b));
+                }
+            }
+
+            // Horner scheme, coefficients from the highest power down
+            template<typename T, size_t LEN, typename... Coefficients>
+            vector_type_t<T, LEN> polynomial_vals(vector_type_t<T, LEN> x, T highest, Coefficients... rest) noexcept {
+                vector_type_t<T, LEN> result = broadcast_val<T, LEN>(highest);
+                ((result = mul_add_vals<T, LEN>(result, x, broadcast_val<T, LEN>(rest))), ...);
+                return result;
+            }
+
+            template<typename T, size_t LEN>
+            int_register_t<vector_type_t<T, LEN>> as_int_bits(vector_type_t<T, LEN> a) noexcept {
+                return bit_cast_register<int_register_t<vector_type_t<T, LEN>>>(a);
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> from_int_bits(int_register_t<vector_type_t<T, LEN>> a) noexcept {
+                return bit_cast_register<vector_type_t<T, LEN>>(a);
+            }
+
+            // integer add on the lanes of T's width
+            template<typename T, typename IntRegister>
+            IntRegister int_lanes_add(IntRegister a, IntRegister b) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return a + b;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<IntRegister, __m128i>) {
+                    return sizeof(T) == 4 ? _mm_add_epi32(a, b) : _mm_add_epi64(a, b);
+                }
+                else if constexpr (std::is_same_v<IntRegister, __m256i>) {
+                    return sizeof(T) == 4 ? _mm256_add_epi32(a, b) : _mm256_add_epi64(a, b);
+                }
+                else {
+                    return sizeof(T) == 4 ? _mm512_add_epi32(a, b) : _mm512_add_epi64(a, b);
+                }
+#endif
+            }
+
+            template<int SHIFT, typename T, typename IntRegister>
+            IntRegister int_lanes_shift_left(IntRegister a) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // unsigned, bits shifted into the sign would overflow a signed lane
+                    using unsigned_register = generic_register_t<std::make_unsigned_t<generic_lane_t<IntRegister>>>;
+                    return (IntRegister)((unsigned_register)a << SHIFT);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<IntRegister, __m128i>) {
+                    return sizeof(T) == 4 ? _mm_slli_epi32(a, SHIFT) : _mm_slli_epi64(a, SHIFT);
+                }
+                else if constexpr (std::is_same_v<IntRegister, __m256i>) {
+                    return sizeof(T) == 4 ? _mm256_slli_epi32(a, SHIFT) : _mm256_slli_epi64(a, SHIFT);
+                }
+                else {
+                    return sizeof(T) == 4 ? _mm512_slli_epi32(a, SHIFT) : _mm512_slli_epi64(a, SHIFT);
+                }
+#endif
+            }
+
+            // logical, zeroes come in from the top
+            template<int SHIFT, typename T, typename IntRegister>
+            IntRegister int_lanes_shift_right(IntRegister a) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using unsigned_register = generic_register_t<std::make_unsigned_t<generic_lane_t<IntRegister>>>;
+                    return (IntRegister)((unsigned_register)a >> SHIFT);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<IntRegister, __m128i>) {
+                    return sizeof(T) == 4 ? _mm_srli_epi32(a, SHIFT) : _mm_srli_epi64(a, SHIFT);
+                }
+                else if constexpr (std::is_same_v<IntRegister, __m256i>) {
+                    return sizeof(T) == 4 ? _mm256_srli_epi32(a, SHIFT) : _mm256_srli_epi64(a, SHIFT);
+                }
+                else {
+                    return sizeof(T) == 4 ? _mm512_srli_epi32(a, SHIFT) : _mm512_srli_epi64(a, SHIFT);
+                }
+#endif
+            }
+
+            // mask of the lanes whose sign bit is set, in the levels mask representation
+            template<typename T, size_t LEN>
+            mask_type_t<T, LEN> sign_bit_mask(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (!USE_AVX512_INTRINSICS) {
+                    // blendv only looks at the sign bit anyway
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_movepi32_mask(_mm_castps_si128(a));
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_movepi64_mask(_mm_castpd_si128(a));
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_movepi32_mask(_mm256_castps_si256(a));
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_movepi64_mask(_mm256_castpd_si256(a));
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_movepi32_mask(_mm512_castps_si512(a));
+                }
+                else {
+                    return _mm512_movepi64_mask(_mm512_castpd_si512(a));
+                }
+#endif
+            }
+
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_DETAIL_BITWISE_OPERATORS_HPP
@@ -0,0 +1,426 @@
+#pragma once
+#ifndef SIMD_WRAP_EXPRESSION_TEMPLATE_COMPARE_OPERATORS_HPP
+#define SIMD_WRAP_EXPRESSION_TEMPLATE_COMPARE_OPERATORS_HPP
+#include <cstring>
+#include "binary_operators.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            using mask_type_t = typename simd_traits<T, LEN>::mask_type;
+
+            enum class compare_op {
+                eq,
+                neq,
+                lt,
+                le,
+                gt,
+                ge
+            };
+
+#if !defined(SW_GENERIC_VECTORS)
+            // predicates for the AVX style cmp instructions: ordered and quiet,
+            // except for neq which is true for NaN like the scalar != is
+            constexpr int compare_predicate(compare_op op) noexcept {
+                switch (op) {
+                case compare_op::eq:
+                    return _CMP_EQ_OQ;
+                case compare_op::neq:
+                    return _CMP_NEQ_UQ;
+                case compare_op::lt:
+                    return _CMP_LT_OQ;
+                case compare_op::le:
+                    return _CMP_LE_OQ;
+                case compare_op::gt:
+                    return _CMP_GT_OQ;
+                default:
+                    return _CMP_GE_OQ;
+                }
+            }
+
+            // SSE4.1 only has a separate instruction per predicate
+            template<compare_op OP, typename Register>
+            Register sse_compare(Register a, Register b) noexcept {
+                if constexpr (std::is_same_v<Register, __m128>) {
+                    if constexpr (OP == compare_op::eq) {
+                        return _mm_cmpeq_ps(a, b);
+                    }
+                    else if constexpr (OP == compare_op::neq) {
+                        return _mm_cmpneq_ps(a, b);
+                    }
+                    else if constexpr (OP == compare_op::lt) {
+                        return _mm_cmplt_ps(a, b);
+                    }
+                    else if constexpr (OP == compare_op::le) {
+                        return _mm_cmple_ps(a, b);
+                    }
+                    else if constexpr (OP == compare_op::gt) {
+                        return _mm_cmpgt_ps(a, b);
+                    }
+                    else {
+                        return _mm_cmpge_ps(a, b);
+                    }
+                }
+                else {
+                    if constexpr (OP == compare_op::eq) {
+                        return _mm_cmpeq_pd(a, b);
+                    }
+                    else if constexpr (OP == compare_op::neq) {
+                        return _mm_cmpneq_pd(a, b);
+                    }
+                    else if constexpr (OP == compare_op::lt) {
+                        return _mm_cmplt_pd(a, b);
+                    }
+                    else if constexpr (OP == compare_op::le) {
+                        return _mm_cmple_pd(a, b);
+                    }
+                    else if constexpr (OP == compare_op::gt) {
+                        return _mm_cmpgt_pd(a, b);
+                    }
+                    else {
+                        return _mm_cmpge_pd(a, b);
+                    }
+                }
+            }
+#endif
+
+            // vector extension operators, all ones in the lanes where a OP b holds
+            template<compare_op OP, typename Register>
+            generic_mask_t<Register> generic_compare(Register a, Register b) noexcept {
+                if constexpr (OP == compare_op::eq) {
+                    return a == b;
+                }
+                else if constexpr (OP == compare_op::neq) {
+                    return a != b;
+                }
+                else if constexpr (OP == compare_op::lt) {
+                    return a < b;
+                }
+                else if constexpr (OP == compare_op::le) {
+                    return a <= b;
+                }
+                else if constexpr (OP == compare_op::gt) {
+                    return a > b;
+                }
+                else {
+                    return a >= b;
+                }
+            }
+
+#if !defined(SW_GENERIC_VECTORS)
+            constexpr int int_compare_predicate(compare_op op) noexcept {
+                switch (op) {
+                case compare_op::eq:
+                    return _MM_CMPINT_EQ;
+                case compare_op::neq:
+                    return _MM_CMPINT_NE;
+                case compare_op::lt:
+                    return _MM_CMPINT_LT;
+                case compare_op::le:
+                    return _MM_CMPINT_LE;
+                case compare_op::gt:
+                    return _MM_CMPINT_NLE;
+                default:
+                    return _MM_CMPINT_NLT;
+                }
+            }
+#endif
+
+            // integer lanes, signed or unsigned after T
+            template<typename T, size_t LEN, compare_op OP>
+            mask_type_t<T, LEN> int_compare_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return (vector_type)generic_compare<OP>(a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    constexpr int predicate = int_compare_predicate(OP);
+                    constexpr bool is_signed = std::is_signed_v<T>;
+                    if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return is_signed ? _mm512_cmp_epi8_mask(a, b, predicate) : _mm512_cmp_epu8_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return is_signed ? _mm512_cmp_epi16_mask(a, b, predicate) : _mm512_cmp_epu16_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return is_signed ? _mm512_cmp_epi32_mask(a, b, predicate) : _mm512_cmp_epu32_mask(a, b, predicate);
+                        }
+                        else {
+                            return is_signed ? _mm512_cmp_epi64_mask(a, b, predicate) : _mm512_cmp_epu64_mask(a, b, predicate);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return is_signed ? _mm256_cmp_epi8_mask(a, b, predicate) : _mm256_cmp_epu8_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return is_signed ? _mm256_cmp_epi16_mask(a, b, predicate) : _mm256_cmp_epu16_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return is_signed ? _mm256_cmp_epi32_mask(a, b, predicate) : _mm256_cmp_epu32_mask(a, b, predicate);
+                        }
+                        else {
+                            return is_signed ? _mm256_cmp_epi64_mask(a, b, predicate) : _mm256_cmp_epu64_mask(a, b, predicate);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 1) {
+                            return is_signed ? _mm_cmp_epi8_mask(a, b, predicate) : _mm_cmp_epu8_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return is_signed ? _mm_cmp_epi16_mask(a, b, predicate) : _mm_cmp_epu16_mask(a, b, predicate);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return is_signed ? _mm_cmp_epi32_mask(a, b, predicate) : _mm_cmp_epu32_mask(a, b, predicate);
+                        }
+                        else {
+                            return is_signed ? _mm_cmp_epi64_mask(a, b, predicate) : _mm_cmp_epu64_mask(a, b, predicate);
+                        }
+                    }
+                }
+                else {
+                    // only equal and greater exist, the rest swaps the operands or inverts
+                    const vector_type ones = broadcast_val<T, LEN>(T(~T(0)));
+                    const auto invert = [&ones](vector_type val) {
+                        if constexpr (std::is_same_v<vector_type, __m256i>) {
+                            return _mm256_xor_si256(val, ones);
+                        }
+                        else {
+                            return _mm_xor_si128(val, ones);
+                        }
+                    };
+                    if constexpr (OP == compare_op::eq) {
+                        return int_equal_vals<T, LEN>(a, b);
+                    }
+                    else if constexpr (OP == compare_op::neq) {
+                        return invert(int_equal_vals<T, LEN>(a, b));
+                    }
+                    else if constexpr (OP == compare_op::lt) {
+                        return int_greater_vals<T, LEN>(b, a);
+                    }
+                    else if constexpr (OP == compare_op::le) {
+                        return invert(int_greater_vals<T, LEN>(a, b));
+                    }
+                    else if constexpr (OP == compare_op::gt) {
+                        return int_greater_vals<T, LEN>(a, b);
+                    }
+                    else {
+                        return invert(int_greater_vals<T, LEN>(b, a));
+                    }
+                }
+#endif
+            }
+
+            /*
+                Lane-wise comparison, returning the mask type of the vector: a
+                k-register on AVX-512, an all-ones/all-zeros lane vector below.
+            */
+            template<typename T, size_t LEN, compare_op OP>
+            mask_type_t<T, LEN> compare_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // NaN lanes compare unequal and unordered, like the scalar operators
+                    return (vector_type)generic_compare<OP>(a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                constexpr int predicate = compare_predicate(OP);
+                if constexpr (std::is_integral_v<T>) {
+                    return int_compare_vals<T, LEN, OP>(a, b);
+                }
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_cmp_ps_mask(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_cmp_pd_mask(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_cmp_ps_mask(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_cmp_pd_mask(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_cmp_ps_mask(a, b, predicate);
+                    }
+                    else {
+                        return _mm512_cmp_pd_mask(a, b, predicate);
+                    }
+                }
+                else if constexpr (USE_AVX_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_cmp_ps(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_cmp_pd(a, b, predicate);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_cmp_ps(a, b, predicate);
+                    }
+                    else {
+                        return _mm256_cmp_pd(a, b, predicate);
+                    }
+                }
+                else {
+                    // the immediate form of cmpps is AVX only
+                    return sse_compare<OP>(a, b);
+                }
+#endif
+            }
+
+            /*
+                Mask with the first count lanes active, the building block for tail
+                handling. Vector masks are cut out of a row of set bytes followed
+                by a row of clear ones, which works for any lane size.
+            */
+            template<typename T, size_t LEN>
+            mask_type_t<T, LEN> lane_mask(size_t count) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                using mask_type = mask_type_t<T, LEN>;
+                constexpr size_t lanes = simd_traits<T, LEN>::num_entries;
+                count = count < lanes ? count : lanes;
+                if constexpr (std::is_integral_v<mask_type>) {
+                    return count >= 64 ? static_cast<mask_type>(~uint64_t(0)) : static_cast<mask_type>((uint64_t(1) << count) - 1);
+                }
+                else {
+                    alignas(32) static constexpr int8_t window[64] = {
+                        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+                    };
+                    const int8_t* start = window + 32 - count * sizeof(T);
+                    if constexpr (USE_GENERIC_VECTORS) {
+                        vector_type result;
+                        std::memcpy(&result, start, sizeof(result));
+                        return result;
+                    }
+#if !defined(SW_GENERIC_VECTORS)
+                    else if constexpr (sizeof(vector_type) == 32) {
+                        return bit_cast_register<vector_type>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(start)));
+                    }
+                    else {
+                        return bit_cast_register<vector_type>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(start)));
+                    }
+#endif
+                }
+            }
+
+            // per lane: mask set ? a : b
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> select_vals(mask_type_t<T, LEN> mask, vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // only the top bit of each mask lane counts, like blendv
+                    return generic_blend((generic_mask_t<vector_type>)mask < 0, a, b);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    // mask_blend takes the second operand where the bit is set
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_mask_blend_ps(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_mask_blend_pd(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_mask_blend_ps(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_mask_blend_pd(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_mask_blend_ps(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                        return _mm512_mask_blend_pd(mask, b, a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm512_mask_blend_epi8(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm512_mask_blend_epi16(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm512_mask_blend_epi32(mask, b, a);
+                        }
+                        else {
+                            return _mm512_mask_blend_epi64(mask, b, a);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm256_mask_blend_epi8(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm256_mask_blend_epi16(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm256_mask_blend_epi32(mask, b, a);
+                        }
+                        else {
+                            return _mm256_mask_blend_epi64(mask, b, a);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm_mask_blend_epi8(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm_mask_blend_epi16(mask, b, a);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm_mask_blend_epi32(mask, b, a);
+                        }
+                        else {
+                            return _mm_mask_blend_epi64(mask, b, a);
+                        }
+                    }
+                }
+                else {
+                    // blendv picks the second operand where the lane's top bit is set
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_blendv_ps(b, a, mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_blendv_pd(b, a, mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_blendv_ps(b, a, mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_blendv_pd(b, a, mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        return _mm256_blendv_epi8(b, a, mask);
+                    }
+                    else {
+                        return _mm_blendv_epi8(b, a, mask);
+                    }
+                }
+#endif
+            }
+
+            // replaces the lanes past LEN with the given value, e.g. the identity of a reduction
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> fill_padding(vector_type_t<T, LEN> val, T fill) noexcept {
+                if constexpr (simd_traits<T, LEN>::remainder_entries == 0) {
+                    return val;
+                }
+                else {
+                    return select_vals<T, LEN>(lane_mask<T, LEN>(LEN), val, broadcast_val<T, LEN>(fill));
+                }
+            }
+
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_EXPRESSION_TEMPLATE_COMPARE_OPERATORS_HPP
@@ -3,26 +3,53 @@
 #define SIMD_WRAP_EXPRESSION_TEMPLATE_HELPERS_HPP
 /*
     Following select how to refer to an expression template node,
-    choosing by-value for scalars and by reference for the rest.
+    choosing by-value for scalars and intermediate nodes (cheap to copy,
+    and usually temporaries) and by reference for vectors.
 */
+#include <cstddef>
+#include <type_traits>
+#include "simd_traits.hpp"
 
 namespace sw {
 
-    namespace detail {
+    inline namespace SW_ISA_NAMESPACE {
 
-        template<typename T>
-        class scalar;
+        template<typename T, size_t LEN>
+        struct vector;
 
-        template<typename T>
-        struct expr_node_traits {
-            using reference_type = T const&;
-        };
+        namespace detail {
 
-        template<typename T>
-        struct expr_node_traits<scalar<T>> {
-            static_assert(std::is_arithmetic_v<T>, "expr_node_traits for scalar instantiated with non-arithmetic type!");
-            using reference_type = scalar<T>;
-        };
+            template<typename T>
+            struct expr_node_traits {
+                using reference_type = T;
+            };
+
+            template<typename T, size_t LEN>
+            struct expr_node_traits<vector<T, LEN>> {
+                using reference_type = vector<T, LEN> const&;
+            };
+
+            /*
+                Anything that can sit in an expression tree: has value_type and
+                length members and an operator()() returning the evaluated register.
+                Specialized next to each node type.
+            */
+            template<typename T>
+            struct is_expression_node : std::false_type {};
+
+            template<typename T, size_t LEN>
+            struct is_expression_node<vector<T, LEN>> : std::true_type {};
+
+            template<typename T>
+            constexpr bool is_expression_node_v = is_expression_node<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+            // at least one side has to be a node, the other may be a plain scalar
+            template<typename OP0, typename OP1>
+            constexpr bool is_binary_operand_pair_v = (is_expression_node_v<OP0> && is_expression_node_v<OP1>) ||
+                (is_expression_node_v<OP0> && std::is_arithmetic_v<OP1>) ||
+                (std::is_arithmetic_v<OP0> && is_expression_node_v<OP1>);
+
+        }
 
     }
 
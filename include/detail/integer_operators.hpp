@@ -0,0 +1,478 @@
+#pragma once
+#ifndef SIMD_WRAP_DETAIL_INTEGER_OPERATORS_HPP
+#define SIMD_WRAP_DETAIL_INTEGER_OPERATORS_HPP
+#include <limits>
+#include "bitwise_operators.hpp"
+
+/*
+    Integer only building blocks: the high half of a lane-wise multiply,
+    shifts by a count that's only known at runtime (one count for all lanes),
+    and the saturating 8 and 16 bit arithmetic fixed point code is built on.
+*/
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            /*
+                Upper half of the double width product, signed or unsigned after T.
+                16 bit lanes have an instruction for it. 32 bit lanes multiply the
+                even and the odd lanes into 64 bit products separately and put the
+                upper halves back together.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> mulhi_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) == 2 || sizeof(T) == 4, "mulhi is only implemented for 16 and 32 bit lanes.");
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using wide_type = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        a[i] = T((wide_type(a[i]) * wide_type(b[i])) >> (sizeof(T) * 8));
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (sizeof(T) == 2) {
+                    if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        return is_signed ? _mm512_mulhi_epi16(a, b) : _mm512_mulhi_epu16(a, b);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        return is_signed ? _mm256_mulhi_epi16(a, b) : _mm256_mulhi_epu16(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm_mulhi_epi16(a, b) : _mm_mulhi_epu16(a, b);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    const __m512i even = is_signed ? _mm512_mul_epi32(a, b) : _mm512_mul_epu32(a, b);
+                    const __m512i a_odd = _mm512_srli_epi64(a, 32);
+                    const __m512i b_odd = _mm512_srli_epi64(b, 32);
+                    const __m512i odd = is_signed ? _mm512_mul_epi32(a_odd, b_odd) : _mm512_mul_epu32(a_odd, b_odd);
+                    return _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    const __m256i even = is_signed ? _mm256_mul_epi32(a, b) : _mm256_mul_epu32(a, b);
+                    const __m256i a_odd = _mm256_srli_epi64(a, 32);
+                    const __m256i b_odd = _mm256_srli_epi64(b, 32);
+                    const __m256i odd = is_signed ? _mm256_mul_epi32(a_odd, b_odd) : _mm256_mul_epu32(a_odd, b_odd);
+                    return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+                }
+                else {
+                    const __m128i even = is_signed ? _mm_mul_epi32(a, b) : _mm_mul_epu32(a, b);
+                    const __m128i a_odd = _mm_srli_epi64(a, 32);
+                    const __m128i b_odd = _mm_srli_epi64(b, 32);
+                    const __m128i odd = is_signed ? _mm_mul_epi32(a_odd, b_odd) : _mm_mul_epu32(a_odd, b_odd);
+                    // blend_epi16 works in 16 bit steps, 0xCC is the upper 32 bits of each 64
+                    return _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+                }
+#endif
+            }
+
+            // counts of the lane width and above clear the lanes
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> shift_left_vals(vector_type_t<T, LEN> a, int count) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) != 1, "There are no shifts for 8 bit lanes.");
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // shifting by the lane width or more is undefined for the operators,
+                    // and so is shifting into the sign of a signed lane
+                    using unsigned_register = generic_register_t<std::make_unsigned_t<T>>;
+                    return count < int(sizeof(T) * 8) ? vector_type((unsigned_register)a << count) : vector_type{};
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    const __m128i shift = _mm_cvtsi32_si128(count);
+                    if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 2) {
+                            return _mm512_sll_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm512_sll_epi32(a, shift);
+                        }
+                        else {
+                            return _mm512_sll_epi64(a, shift);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 2) {
+                            return _mm256_sll_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm256_sll_epi32(a, shift);
+                        }
+                        else {
+                            return _mm256_sll_epi64(a, shift);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 2) {
+                            return _mm_sll_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm_sll_epi32(a, shift);
+                        }
+                        else {
+                            return _mm_sll_epi64(a, shift);
+                        }
+                    }
+                }
+#endif
+            }
+
+            /*
+                Arithmetic for signed T, logical for unsigned. Large counts fill the
+                lanes with their sign bit or zero. The 64 bit arithmetic shift is
+                AVX-512 only, below it ors the shifted sign back in on top.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> shift_right_vals(vector_type_t<T, LEN> a, int count) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) != 1, "There are no shifts for 8 bit lanes.");
+                if constexpr (USE_GENERIC_VECTORS) {
+                    if constexpr (std::is_signed_v<T>) {
+                        return a >> (count < int(sizeof(T) * 8) ? count : int(sizeof(T) * 8) - 1);
+                    }
+                    else {
+                        return count < int(sizeof(T) * 8) ? vector_type(a >> count) : vector_type{};
+                    }
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    const __m128i shift = _mm_cvtsi32_si128(count);
+                    if constexpr (std::is_signed_v<T> && sizeof(T) == 8 && !USE_AVX512_INTRINSICS) {
+                        using unsigned_type = std::make_unsigned_t<T>;
+                        count = count < 63 ? count : 63;
+                        const vector_type sign = int_greater_vals<T, LEN>(vector_type{}, a);
+                        const vector_type shifted = shift_right_vals<unsigned_type, LEN>(a, count);
+                        // a shift by 64 leaves nothing of the sign for counts of 0
+                        const vector_type fill = shift_left_vals<unsigned_type, LEN>(sign, 64 - count);
+                        if constexpr (std::is_same_v<vector_type, __m256i>) {
+                            return _mm256_or_si256(shifted, fill);
+                        }
+                        else {
+                            return _mm_or_si128(shifted, fill);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 2) {
+                            return std::is_signed_v<T> ? _mm512_sra_epi16(a, shift) : _mm512_srl_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return std::is_signed_v<T> ? _mm512_sra_epi32(a, shift) : _mm512_srl_epi32(a, shift);
+                        }
+                        else {
+                            return std::is_signed_v<T> ? _mm512_sra_epi64(a, shift) : _mm512_srl_epi64(a, shift);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 2) {
+                            return std::is_signed_v<T> ? _mm256_sra_epi16(a, shift) : _mm256_srl_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return std::is_signed_v<T> ? _mm256_sra_epi32(a, shift) : _mm256_srl_epi32(a, shift);
+                        }
+                        else if constexpr (std::is_signed_v<T>) {
+                            return _mm256_sra_epi64(a, shift);
+                        }
+                        else {
+                            return _mm256_srl_epi64(a, shift);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 2) {
+                            return std::is_signed_v<T> ? _mm_sra_epi16(a, shift) : _mm_srl_epi16(a, shift);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return std::is_signed_v<T> ? _mm_sra_epi32(a, shift) : _mm_srl_epi32(a, shift);
+                        }
+                        else if constexpr (std::is_signed_v<T>) {
+                            return _mm_sra_epi64(a, shift);
+                        }
+                        else {
+                            return _mm_srl_epi64(a, shift);
+                        }
+                    }
+                }
+#endif
+            }
+
+            // the lane type widen_vals produces
+            template<typename T>
+            using widened_t = std::conditional_t<sizeof(T) == 1, std::conditional_t<std::is_signed_v<T>, int16_t, uint16_t>,
+                std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>>;
+
+            // a + b clamped to the range of T, 8 and 16 bit lanes
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> adds_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) <= 2, "Saturating arithmetic is only implemented for 8 and 16 bit lanes.");
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using wide_type = std::conditional_t<is_signed, int32_t, uint32_t>;
+                    constexpr wide_type lowest = std::numeric_limits<T>::min();
+                    constexpr wide_type highest = std::numeric_limits<T>::max();
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        const wide_type x = wide_type(a[i]);
+                        const wide_type y = wide_type(b[i]);
+                        const wide_type sum = x + y;
+                        a[i] = T(is_signed ? (sum < lowest ? lowest : sum > highest ? highest : sum) : (sum > highest ? highest : sum));
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm512_adds_epi8(a, b) : _mm512_adds_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm512_adds_epi16(a, b) : _mm512_adds_epu16(a, b);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm256_adds_epi8(a, b) : _mm256_adds_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm256_adds_epi16(a, b) : _mm256_adds_epu16(a, b);
+                    }
+                }
+                else {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm_adds_epi8(a, b) : _mm_adds_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm_adds_epi16(a, b) : _mm_adds_epu16(a, b);
+                    }
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> subs_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) <= 2, "Saturating arithmetic is only implemented for 8 and 16 bit lanes.");
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using wide_type = std::conditional_t<is_signed, int32_t, uint32_t>;
+                    constexpr wide_type lowest = std::numeric_limits<T>::min();
+                    constexpr wide_type highest = std::numeric_limits<T>::max();
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        const wide_type x = wide_type(a[i]);
+                        const wide_type y = wide_type(b[i]);
+                        const wide_type difference = x - y;
+                        a[i] = T(is_signed ? (difference < lowest ? lowest : difference > highest ? highest : difference) : (x < y ? 0 : difference));
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm512_subs_epi8(a, b) : _mm512_subs_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm512_subs_epi16(a, b) : _mm512_subs_epu16(a, b);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm256_subs_epi8(a, b) : _mm256_subs_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm256_subs_epi16(a, b) : _mm256_subs_epu16(a, b);
+                    }
+                }
+                else {
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm_subs_epi8(a, b) : _mm_subs_epu8(a, b);
+                    }
+                    else {
+                        return is_signed ? _mm_subs_epi16(a, b) : _mm_subs_epu16(a, b);
+                    }
+                }
+#endif
+            }
+
+            /*
+                (a * b + 2^14) >> 15 on int16 lanes, the rounded Q15 product. The
+                only product that doesn't fit, -1 * -1, comes out as -32768.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> mulhrs_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(std::is_same_v<T, int16_t>, "mulhrs is only implemented for int16_t lanes.");
+                if constexpr (USE_GENERIC_VECTORS) {
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        a[i] = T((int32_t(a[i]) * int32_t(b[i]) + (1 << 14)) >> 15);
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_mulhrs_epi16(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_mulhrs_epi16(a, b);
+                }
+                else {
+                    return _mm_mulhrs_epi16(a, b);
+                }
+#endif
+            }
+
+            /*
+                (a + b + 1) >> 1 without overflow. There are only unsigned
+                instructions, signed lanes are moved into their range and back
+                by flipping the sign bit.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> avg_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) <= 2, "avg is only implemented for 8 and 16 bit lanes.");
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using wide_type = std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>;
+                    for (size_t i = 0; i < sizeof(vector_type) / sizeof(T); ++i) {
+                        a[i] = T((wide_type(a[i]) + wide_type(b[i]) + 1) >> 1);
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_signed_v<T>) {
+                    using unsigned_type = std::make_unsigned_t<T>;
+                    const vector_type flip = broadcast_val<T, LEN>(std::numeric_limits<T>::min());
+                    const vector_type average = avg_vals<unsigned_type, LEN>(xor_vals<T, LEN>(a, flip), xor_vals<T, LEN>(b, flip));
+                    return xor_vals<T, LEN>(average, flip);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return sizeof(T) == 1 ? _mm512_avg_epu8(a, b) : _mm512_avg_epu16(a, b);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return sizeof(T) == 1 ? _mm256_avg_epu8(a, b) : _mm256_avg_epu16(a, b);
+                }
+                else {
+                    return sizeof(T) == 1 ? _mm_avg_epu8(a, b) : _mm_avg_epu16(a, b);
+                }
+#endif
+            }
+
+            /*
+                Narrows the lanes of a, then b, into To with saturation, in lane
+                order. The pack instructions work per 128 bit lane, wider registers
+                get their 64 bit blocks put back in order. They treat the input
+                as signed, unsigned input is clamped to the output range first.
+            */
+            template<typename To, typename T, size_t LEN>
+            vector_type_t<To, LEN * 2> pack_saturate_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(std::is_integral_v<To> && sizeof(To) * 2 == sizeof(T) && sizeof(T) <= 4, "pack_saturate narrows 16 bit lanes to 8 and 32 bit lanes to 16.");
+                static_assert(std::is_signed_v<T> || std::is_unsigned_v<To>, "Unsigned lanes only pack into unsigned ones.");
+                if constexpr (std::is_unsigned_v<T>) {
+                    const vector_type highest = broadcast_val<T, LEN>(T(std::numeric_limits<To>::max()));
+                    a = int_min_max_vals<T, LEN, false>(a, highest);
+                    b = int_min_max_vals<T, LEN, false>(b, highest);
+                }
+                constexpr bool to_signed = std::is_signed_v<To>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    constexpr size_t lanes = sizeof(vector_type) / sizeof(T);
+                    const auto narrow = [](T x) {
+                        constexpr T lowest = T(std::numeric_limits<To>::min());
+                        constexpr T highest = T(std::numeric_limits<To>::max());
+                        return To(x < lowest ? lowest : x > highest ? highest : x);
+                    };
+                    vector_type_t<To, LEN * 2> packed;
+                    for (size_t i = 0; i < lanes; ++i) {
+                        packed[i] = narrow(a[i]);
+                        packed[lanes + i] = narrow(b[i]);
+                    }
+                    return packed;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    __m512i packed;
+                    if constexpr (sizeof(T) == 2) {
+                        packed = to_signed ? _mm512_packs_epi16(a, b) : _mm512_packus_epi16(a, b);
+                    }
+                    else {
+                        packed = to_signed ? _mm512_packs_epi32(a, b) : _mm512_packus_epi32(a, b);
+                    }
+                    return _mm512_permutexvar_epi64(_mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7), packed);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    __m256i packed;
+                    if constexpr (sizeof(T) == 2) {
+                        packed = to_signed ? _mm256_packs_epi16(a, b) : _mm256_packus_epi16(a, b);
+                    }
+                    else {
+                        packed = to_signed ? _mm256_packs_epi32(a, b) : _mm256_packus_epi32(a, b);
+                    }
+                    return _mm256_permute4x64_epi64(packed, 0xD8);
+                }
+                else {
+                    if constexpr (sizeof(T) == 2) {
+                        return to_signed ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b);
+                    }
+                    else {
+                        return to_signed ? _mm_packs_epi32(a, b) : _mm_packus_epi32(a, b);
+                    }
+                }
+#endif
+            }
+
+            /*
+                Sign or zero extends the lower (HIGH = false) or upper half of
+                the lanes into lanes twice as wide, the inverse of pack_saturate.
+                The result fills a register of the same size.
+            */
+            template<typename T, size_t LEN, bool HIGH>
+            vector_type_t<widened_t<T>, LEN / 2> widen_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                static_assert(sizeof(T) <= 2, "widen is only implemented for 8 and 16 bit lanes.");
+                constexpr bool is_signed = std::is_signed_v<T>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    constexpr size_t lanes = sizeof(vector_type) / sizeof(T) / 2;
+                    vector_type_t<widened_t<T>, LEN / 2> wide;
+                    for (size_t i = 0; i < lanes; ++i) {
+                        wide[i] = widened_t<T>(a[HIGH ? lanes + i : i]);
+                    }
+                    return wide;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    const __m256i half = HIGH ? _mm512_extracti64x4_epi64(a, 1) : _mm512_castsi512_si256(a);
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm512_cvtepi8_epi16(half) : _mm512_cvtepu8_epi16(half);
+                    }
+                    else {
+                        return is_signed ? _mm512_cvtepi16_epi32(half) : _mm512_cvtepu16_epi32(half);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    const __m128i half = HIGH ? _mm256_extracti128_si256(a, 1) : _mm256_castsi256_si128(a);
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm256_cvtepi8_epi16(half) : _mm256_cvtepu8_epi16(half);
+                    }
+                    else {
+                        return is_signed ? _mm256_cvtepi16_epi32(half) : _mm256_cvtepu16_epi32(half);
+                    }
+                }
+                else {
+                    const __m128i half = HIGH ? _mm_srli_si128(a, 8) : a;
+                    if constexpr (sizeof(T) == 1) {
+                        return is_signed ? _mm_cvtepi8_epi16(half) : _mm_cvtepu8_epi16(half);
+                    }
+                    else {
+                        return is_signed ? _mm_cvtepi16_epi32(half) : _mm_cvtepu16_epi32(half);
+                    }
+                }
+#endif
+            }
+
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_DETAIL_INTEGER_OPERATORS_HPP
@@ -0,0 +1,345 @@
+#pragma once
+#ifndef SIMD_WRAP_DETAIL_LOAD_STORE_HPP
+#define SIMD_WRAP_DETAIL_LOAD_STORE_HPP
+#include <cstdint>
+#include <cstring>
+#include "compare_operators.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // ALIGNED requires ptr to sit on simd_traits<T, LEN>::alignment
+            template<typename T, size_t LEN, bool ALIGNED = false>
+            vector_type_t<T, LEN> load_vals(const T* ptr) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    vector_type result;
+                    std::memcpy(&result, ptr, sizeof(result));
+                    return result;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return ALIGNED ? _mm_load_ps(ptr) : _mm_loadu_ps(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return ALIGNED ? _mm_load_pd(ptr) : _mm_loadu_pd(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return ALIGNED ? _mm256_load_ps(ptr) : _mm256_loadu_ps(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return ALIGNED ? _mm256_load_pd(ptr) : _mm256_loadu_pd(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return ALIGNED ? _mm512_load_ps(ptr) : _mm512_loadu_ps(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    return ALIGNED ? _mm512_load_pd(ptr) : _mm512_loadu_pd(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return ALIGNED ? _mm512_load_si512(ptr) : _mm512_loadu_si512(ptr);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    const __m256i* src = reinterpret_cast<const __m256i*>(ptr);
+                    return ALIGNED ? _mm256_load_si256(src) : _mm256_loadu_si256(src);
+                }
+                else {
+                    const __m128i* src = reinterpret_cast<const __m128i*>(ptr);
+                    return ALIGNED ? _mm_load_si128(src) : _mm_loadu_si128(src);
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN, bool ALIGNED = false>
+            void store_vals(T* ptr, vector_type_t<T, LEN> val) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    std::memcpy(ptr, &val, sizeof(val));
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    ALIGNED ? _mm_store_ps(ptr, val) : _mm_storeu_ps(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    ALIGNED ? _mm_store_pd(ptr, val) : _mm_storeu_pd(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    ALIGNED ? _mm256_store_ps(ptr, val) : _mm256_storeu_ps(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    ALIGNED ? _mm256_store_pd(ptr, val) : _mm256_storeu_pd(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    ALIGNED ? _mm512_store_ps(ptr, val) : _mm512_storeu_ps(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                    ALIGNED ? _mm512_store_pd(ptr, val) : _mm512_storeu_pd(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    ALIGNED ? _mm512_store_si512(ptr, val) : _mm512_storeu_si512(ptr, val);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    __m256i* dst = reinterpret_cast<__m256i*>(ptr);
+                    ALIGNED ? _mm256_store_si256(dst, val) : _mm256_storeu_si256(dst, val);
+                }
+                else {
+                    __m128i* dst = reinterpret_cast<__m128i*>(ptr);
+                    ALIGNED ? _mm_store_si128(dst, val) : _mm_storeu_si128(dst, val);
+                }
+#endif
+            }
+
+            // the partial loads and stores of registers without masked instructions, through a buffer on the stack
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> buffered_load_vals(const T* ptr, size_t count) noexcept {
+                alignas(vector_type_t<T, LEN>) T buffer[simd_traits<T, LEN>::num_entries] = {};
+                std::memcpy(buffer, ptr, count * sizeof(T));
+                return load_vals<T, LEN>(buffer);
+            }
+
+            template<typename T, size_t LEN>
+            void buffered_store_vals(T* ptr, vector_type_t<T, LEN> val, size_t count) noexcept {
+                alignas(vector_type_t<T, LEN>) T buffer[simd_traits<T, LEN>::num_entries];
+                store_vals<T, LEN>(buffer, val);
+                std::memcpy(ptr, buffer, count * sizeof(T));
+            }
+
+            /*
+                Loads the first count elements and zeroes the rest of the register,
+                without touching memory past ptr + count. AVX-512 masks every element
+                type, AVX2 only 32 and 64 bit lanes, everything else goes through a
+                small buffer on the stack.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> masked_load_vals(const T* ptr, size_t count) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                constexpr size_t lanes = simd_traits<T, LEN>::num_entries;
+                if (count >= lanes) {
+                    return load_vals<T, LEN>(ptr);
+                }
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return buffered_load_vals<T, LEN>(ptr, count);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                const auto mask = lane_mask<T, LEN>(count);
+                if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_maskz_loadu_ps(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_maskz_loadu_pd(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_maskz_loadu_ps(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_maskz_loadu_pd(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_maskz_loadu_ps(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                        return _mm512_maskz_loadu_pd(mask, ptr);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm512_maskz_loadu_epi8(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm512_maskz_loadu_epi16(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm512_maskz_loadu_epi32(mask, ptr);
+                        }
+                        else {
+                            return _mm512_maskz_loadu_epi64(mask, ptr);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm256_maskz_loadu_epi8(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm256_maskz_loadu_epi16(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm256_maskz_loadu_epi32(mask, ptr);
+                        }
+                        else {
+                            return _mm256_maskz_loadu_epi64(mask, ptr);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 1) {
+                            return _mm_maskz_loadu_epi8(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            return _mm_maskz_loadu_epi16(mask, ptr);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            return _mm_maskz_loadu_epi32(mask, ptr);
+                        }
+                        else {
+                            return _mm_maskz_loadu_epi64(mask, ptr);
+                        }
+                    }
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m128>) {
+                    return _mm_maskload_ps(ptr, _mm_castps_si128(mask));
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m128d>) {
+                    return _mm_maskload_pd(ptr, _mm_castpd_si128(mask));
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m256>) {
+                    return _mm256_maskload_ps(ptr, _mm256_castps_si256(mask));
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_maskload_pd(ptr, _mm256_castpd_si256(mask));
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_integral_v<T> && sizeof(T) == 4 && sizeof(vector_type) == 32) {
+                    return _mm256_maskload_epi32(reinterpret_cast<const int*>(ptr), mask);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_integral_v<T> && sizeof(T) == 8 && sizeof(vector_type) == 32) {
+                    return _mm256_maskload_epi64(reinterpret_cast<const long long*>(ptr), mask);
+                }
+                else {
+                    (void)mask;
+                    return buffered_load_vals<T, LEN>(ptr, count);
+                }
+#endif
+            }
+
+            // stores the first count lanes, leaving the memory past ptr + count alone
+            template<typename T, size_t LEN>
+            void masked_store_vals(T* ptr, vector_type_t<T, LEN> val, size_t count) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                constexpr size_t lanes = simd_traits<T, LEN>::num_entries;
+                if (count >= lanes) {
+                    store_vals<T, LEN>(ptr, val);
+                    return;
+                }
+                if constexpr (USE_GENERIC_VECTORS) {
+                    buffered_store_vals<T, LEN>(ptr, val, count);
+                    return;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                const auto mask = lane_mask<T, LEN>(count);
+                if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        _mm_mask_storeu_ps(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        _mm_mask_storeu_pd(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        _mm256_mask_storeu_ps(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        _mm256_mask_storeu_pd(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        _mm512_mask_storeu_ps(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512d>) {
+                        _mm512_mask_storeu_pd(ptr, mask, val);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            _mm512_mask_storeu_epi8(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            _mm512_mask_storeu_epi16(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            _mm512_mask_storeu_epi32(ptr, mask, val);
+                        }
+                        else {
+                            _mm512_mask_storeu_epi64(ptr, mask, val);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        if constexpr (sizeof(T) == 1) {
+                            _mm256_mask_storeu_epi8(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            _mm256_mask_storeu_epi16(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            _mm256_mask_storeu_epi32(ptr, mask, val);
+                        }
+                        else {
+                            _mm256_mask_storeu_epi64(ptr, mask, val);
+                        }
+                    }
+                    else {
+                        if constexpr (sizeof(T) == 1) {
+                            _mm_mask_storeu_epi8(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 2) {
+                            _mm_mask_storeu_epi16(ptr, mask, val);
+                        }
+                        else if constexpr (sizeof(T) == 4) {
+                            _mm_mask_storeu_epi32(ptr, mask, val);
+                        }
+                        else {
+                            _mm_mask_storeu_epi64(ptr, mask, val);
+                        }
+                    }
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m128>) {
+                    _mm_maskstore_ps(ptr, _mm_castps_si128(mask), val);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m128d>) {
+                    _mm_maskstore_pd(ptr, _mm_castpd_si128(mask), val);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m256>) {
+                    _mm256_maskstore_ps(ptr, _mm256_castps_si256(mask), val);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<vector_type, __m256d>) {
+                    _mm256_maskstore_pd(ptr, _mm256_castpd_si256(mask), val);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_integral_v<T> && sizeof(T) == 4 && sizeof(vector_type) == 32) {
+                    _mm256_maskstore_epi32(reinterpret_cast<int*>(ptr), mask, val);
+                }
+                else if constexpr (USE_AVX_INTRINSICS && std::is_integral_v<T> && sizeof(T) == 8 && sizeof(vector_type) == 32) {
+                    _mm256_maskstore_epi64(reinterpret_cast<long long*>(ptr), mask, val);
+                }
+                else {
+                    (void)mask;
+                    buffered_store_vals<T, LEN>(ptr, val, count);
+                }
+#endif
+            }
+
+        }
+
+        template<typename T, size_t LEN>
+        bool is_aligned(const T* ptr) noexcept {
+            return reinterpret_cast<uintptr_t>(ptr) % simd_traits<T, LEN>::alignment == 0;
+        }
+
+        /*
+            Number of leading elements to handle separately so that ptr + result
+            lands on simd_traits<T, LEN>::alignment, clamped to count. Pointers
+            that aren't even aligned to sizeof(T) can never get there and give 0,
+            callers then stay on unaligned accesses.
+        */
+        template<typename T, size_t LEN>
+        size_t peel_count(const T* ptr, size_t count) noexcept {
+            constexpr size_t alignment = simd_traits<T, LEN>::alignment;
+            const size_t misalignment = reinterpret_cast<uintptr_t>(ptr) % alignment;
+            if (misalignment == 0 || misalignment % sizeof(T) != 0) {
+                return 0;
+            }
+            const size_t head = (alignment - misalignment) / sizeof(T);
+            return head < count ? head : count;
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_DETAIL_LOAD_STORE_HPP
@@ -4,7 +4,74 @@
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
+#include <utility>
+
+/*
+    Platform and instruction set are taken from the compilers target macros
+    instead of being fixed here. A translation unit built with -mavx2 -mfma
+    gets AVX2 vectors, one built with -msse4.1 gets SSE vectors. That lets the
+    dispatch library compile the same kernels several times (see src/kernels.cpp)
+    and pick one at runtime with detect_cpu_features()/active_isa().
+*/
+#if defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64) || defined(_M_ARM)
+#define SW_PLATFORM_ARM 1
+#elif defined(__x86_64__) || defined(_M_X64)
+#define SW_PLATFORM_X64 1
+#else
+#define SW_PLATFORM_X86 1
+#endif
+
+#ifndef SW_ISA_LEVEL
+#if defined(SW_PLATFORM_ARM) || defined(SW_FORCE_GENERIC)
+#define SW_ISA_LEVEL 0
+#elif defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__) && defined(__FMA__)
+#define SW_ISA_LEVEL 3
+#elif defined(__AVX2__) && defined(__FMA__)
+#define SW_ISA_LEVEL 2
+#elif defined(__SSE4_1__) || defined(__AVX__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+// MSVC has no switch or macro for SSE4.1, so x64 builds there are assumed to have it
+#define SW_ISA_LEVEL 1
+#else
+#define SW_ISA_LEVEL 0
+#endif
+#endif
+
+// every ISA level gets its own inline namespace, so that instantiations and
+// inline functions from translation units built for different levels never
+// collide at link time. Plain classes with inline members go in it as well,
+// only the dispatch and thread pool types shared between levels stay outside.
+#if SW_ISA_LEVEL == 3
+#define SW_ISA_NAMESPACE isa_avx512
+#elif SW_ISA_LEVEL == 2
+#define SW_ISA_NAMESPACE isa_avx2
+#elif SW_ISA_LEVEL == 1
+#define SW_ISA_NAMESPACE isa_sse41
+#else
+#define SW_ISA_NAMESPACE isa_generic
+#endif
+
+/*
+    Level 0 is the generic backend: GCC/Clang vector extensions instead of
+    intrinsics, which the compiler lowers to whatever the target has (NEON,
+    SSE2, or scalar code). Every target without one of the x86 levels gets
+    it, x86 builds can ask for it with SW_FORCE_GENERIC to test it.
+*/
+#if SW_ISA_LEVEL == 0
+#if !defined(__GNUC__)
+#error "SIMDwrap's generic backend needs the GCC/Clang vector extensions, on x86 build with -msse4.1 or newer (the SIMDwrap target adds it)."
+#endif
+#define SW_GENERIC_VECTORS 1
+#endif
+
+/*
+    Other targets have no immintrin.h, so nothing outside it may name an x86
+    type or intrinsic either, not even in an if constexpr branch that gets
+    discarded. Those branches sit behind #if !defined(SW_GENERIC_VECTORS)
+    after the generic one, the same goes for helpers only x86 code calls.
+*/
+#if !defined(SW_PLATFORM_ARM)
 #include <immintrin.h>
+#endif
 
 namespace sw {
 
@@ -12,97 +79,261 @@ namespace sw {
     struct x86_platform_tag {};
     struct arm_platform_tag {};
 
-    // will be set by CMake script eventually. will be used
-    // to enable and use NEON types on ARM.
-    using platform_type = x64_platform_tag;
-    // will be set by CMake, eventually. this works for now: AVX is supported on 95% of hardware
-    // with x64 according to steam hardware survey iirc
-    static constexpr bool USE_AVX_INTRINSICS = !std::is_same_v<platform_type, x86_platform_tag> 
-        && !std::is_same_v<platform_type, arm_platform_tag>;
+    /*
+        Instruction set levels the dispatch layer knows about, ordered so that
+        a higher level implies support for everything below it.
+    */
+    enum class isa : uint32_t {
+        generic = 0,
+        sse41 = 1,
+        avx2 = 2,
+        avx512 = 3
+    };
 
-    namespace detail {
+    inline namespace SW_ISA_NAMESPACE {
 
-        template<typename T, size_t LEN>
-        struct vector_type_proxy {
-            constexpr static auto get_type() noexcept {
-                if constexpr (!std::is_same_v<platform_type, arm_platform_tag>) {
-                    if constexpr (std::is_same_v<T, float> && LEN <= 4) {
-                        return __m128();
-                    }
-                    else if constexpr (std::is_same_v<T, double> && LEN <= 2) {
-                        return __m128d();
+        // the generic backend sits behind arm_platform_tag, x86 builds at level 0 get it too
+#if defined(SW_PLATFORM_ARM) || defined(SW_GENERIC_VECTORS)
+        using platform_type = arm_platform_tag;
+#elif defined(SW_PLATFORM_X64)
+        using platform_type = x64_platform_tag;
+#else
+        using platform_type = x86_platform_tag;
+#endif
+        // ISA level the current translation unit is being compiled for
+        static constexpr isa compiled_isa = static_cast<isa>(SW_ISA_LEVEL);
+        static constexpr bool USE_GENERIC_VECTORS = std::is_same_v<platform_type, arm_platform_tag>;
+        static constexpr bool USE_AVX_INTRINSICS = compiled_isa >= isa::avx2;
+        // AVX-512 F/BW/DQ/VL: 512 bit registers plus k-register masks for every width
+        static constexpr bool USE_AVX512_INTRINSICS = compiled_isa >= isa::avx512;
+        static constexpr bool USE_FMA_INTRINSICS = compiled_isa >= isa::avx2;
+        // expression trees fuse a*b+c into one FMA. Define SW_DISABLE_FMA_CONTRACTION
+        // (and build with -ffp-contract=off on gcc) for unfused arithmetic.
+#if defined(SW_DISABLE_FMA_CONTRACTION)
+        static constexpr bool CONTRACT_FMA = false;
+#else
+        static constexpr bool CONTRACT_FMA = USE_FMA_INTRINSICS;
+#endif
+        // gather from AVX2 up and scatter with AVX-512 use the instructions. Define
+        // SW_EMULATE_GATHER where they are slow (AMD before Zen 4, Intel with the GDS
+        // microcode mitigation) to move lane by lane instead.
+#if defined(SW_EMULATE_GATHER)
+        static constexpr bool USE_HARDWARE_GATHER = false;
+#else
+        static constexpr bool USE_HARDWARE_GATHER = USE_AVX_INTRINSICS;
+#endif
+
+        namespace detail {
+
+            template<typename T>
+            constexpr bool dependent_false = false;
+
+            // 16 byte vector of T for the generic backend, the width of NEON and SSE
+            template<typename T>
+            struct generic_register;
+
+#if defined(SW_GENERIC_VECTORS)
+#define SW_GENERIC_REGISTER(T) \
+            template<> \
+            struct generic_register<T> { \
+                typedef T type __attribute__((vector_size(16))); \
+            }
+
+            SW_GENERIC_REGISTER(float);
+            SW_GENERIC_REGISTER(double);
+            SW_GENERIC_REGISTER(int8_t);
+            SW_GENERIC_REGISTER(uint8_t);
+            SW_GENERIC_REGISTER(int16_t);
+            SW_GENERIC_REGISTER(uint16_t);
+            SW_GENERIC_REGISTER(int32_t);
+            SW_GENERIC_REGISTER(uint32_t);
+            SW_GENERIC_REGISTER(int64_t);
+            SW_GENERIC_REGISTER(uint64_t);
+#undef SW_GENERIC_REGISTER
+#endif
+
+            template<typename T>
+            using generic_register_t = typename generic_register<T>::type;
+
+            // the lane types generic_register has a vector for
+            template<typename T>
+            constexpr bool is_generic_lane_v = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t> ||
+                std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+                std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>;
+
+            // element type of a generic register
+            template<typename Register>
+            using generic_lane_t = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<Register>()[0])>>;
+
+            template<size_t BYTES>
+            using sized_int_t = std::conditional_t<BYTES == 1, int8_t, std::conditional_t<BYTES == 2, int16_t, std::conditional_t<BYTES == 4, int32_t, int64_t>>>;
+
+            // signed integer lanes as wide as those of Register, the type comparing two of them gives
+            template<typename Register>
+            using generic_mask_t = generic_register_t<sized_int_t<sizeof(generic_lane_t<Register>)>>;
+
+            template<typename T, size_t LEN>
+            struct vector_type_proxy {
+                constexpr static auto get_type() noexcept {
+                    if constexpr (std::is_same_v<platform_type, arm_platform_tag>) {
+                        if constexpr (is_generic_lane_v<T> && LEN * sizeof(T) <= 16) {
+                            return generic_register_t<T>();
+                        }
+                        else {
+                            return T();
+                        }
                     }
-                    else if constexpr (USE_AVX_INTRINSICS && std::is_floating_point_v<T>) {
-                        if constexpr (std::is_same_v<T, double> && LEN <= 4 && LEN > 2) {
+#if !defined(SW_GENERIC_VECTORS)
+                    else {
+                        if constexpr (std::is_same_v<T, float> && LEN <= 4) {
+                            return __m128();
+                        }
+                        else if constexpr (std::is_same_v<T, double> && LEN <= 2) {
+                            return __m128d();
+                        }
+                        else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<T, double> && LEN <= 4) {
                             return __m256d();
                         }
-                        else if constexpr (std::is_same_v<T, float> && LEN <= 8 && LEN > 4) {
+                        else if constexpr (USE_AVX_INTRINSICS && std::is_same_v<T, float> && LEN <= 8) {
                             return __m256();
                         }
-                    }
-                    else if constexpr (std::is_integral_v<T>) {// will have to cast from unsigned types, as these only accept signed
-                    if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
-                        if constexpr (LEN > 16 && USE_AVX_INTRINSICS) {
-                            return __m256i();
-                        }
-                        else {
-                            static_assert(LEN <= 16, "Length of integer vector is greater than supported on platform.");
-                            return __m128i();
+                        else if constexpr (USE_AVX512_INTRINSICS && std::is_same_v<T, double> && LEN <= 8) {
+                            return __m512d();
                         }
+                        else if constexpr (USE_AVX512_INTRINSICS && std::is_same_v<T, float> && LEN <= 16) {
+                            return __m512();
                         }
-                        else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) { 
-                            if constexpr (LEN > 8 && USE_AVX_INTRINSICS) {
-                                return __m256i();
+                        else if constexpr (std::is_integral_v<T>) {
+                            // will have to cast from unsigned types, as these only accept signed
+                            if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
+                                if constexpr (LEN > 32 && USE_AVX512_INTRINSICS) {
+                                    static_assert(LEN <= 64, "Length of integer vector is greater than supported on platform.");
+                                    return __m512i();
+                                }
+                                else if constexpr (LEN > 16 && USE_AVX_INTRINSICS) {
+                                    static_assert(LEN <= 32 || USE_AVX512_INTRINSICS, "Length of integer vector is greater than supported on platform.");
+                                    return __m256i();
+                                }
+                                else {
+                                    static_assert(LEN <= 16, "Length of integer vector is greater than supported on platform.");
+                                    return __m128i();
+                                }
                             }
-                            else {
-                                static_assert(LEN <= 8, "Length of integer vector is greater than supported on platform.");
-                                return __m128i();
+                            else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) {
+                                if constexpr (LEN > 16 && USE_AVX512_INTRINSICS) {
+                                    static_assert(LEN <= 32, "Length of integer vector is greater than supported on platform.");
+                                    return __m512i();
+                                }
+                                else if constexpr (LEN > 8 && USE_AVX_INTRINSICS) {
+                                    static_assert(LEN <= 16 || USE_AVX512_INTRINSICS, "Length of integer vector is greater than supported on platform.");
+                                    return __m256i();
+                                }
+                                else {
+                                    static_assert(LEN <= 8, "Length of integer vector is greater than supported on platform.");
+                                    return __m128i();
+                                }
                             }
-                        }
-                        else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) {
-                            if constexpr (LEN > 4 && USE_AVX_INTRINSICS) {
-                                return __m128i();
+                            else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) {
+                                if constexpr (LEN > 8 && USE_AVX512_INTRINSICS) {
+                                    static_assert(LEN <= 16, "Length of integer vector is greater than supported on platform.");
+                                    return __m512i();
+                                }
+                                else if constexpr (LEN > 4 && USE_AVX_INTRINSICS) {
+                                    static_assert(LEN <= 8 || USE_AVX512_INTRINSICS, "Length of integer vector is greater than supported on platform.");
+                                    return __m256i();
+                                }
+                                else {
+                                    static_assert(LEN <= 4, "Length of integer vector is greater than supported on platform.");
+                                    return __m128i();
+                                }
                             }
-                            else {
-                                static_assert(LEN <= 4, "Length of integer vector is greater than supported on platform.");
-                                return _mm_set1_epi32(static_cast<int>(val));
-                            }
-                        }
-                        else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
-                            if constexpr (LEN > 2 && USE_AVX_INTRINSICS) {
-                                return __m256i();
+                            else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
+                                if constexpr (LEN > 4 && USE_AVX512_INTRINSICS) {
+                                    static_assert(LEN <= 8, "Length of integer vector is greater than supported on platform.");
+                                    return __m512i();
+                                }
+                                else if constexpr (LEN > 2 && USE_AVX_INTRINSICS) {
+                                    static_assert(LEN <= 4 || USE_AVX512_INTRINSICS, "Length of integer vector is greater than supported on platform.");
+                                    return __m256i();
+                                }
+                                else {
+                                    static_assert(LEN <= 2, "Length of integer vector is greater than supported on platform.");
+                                    return __m128i();
+                                }
                             }
                             else {
-                                static_assert(LEN <= 2, "Length of integer vector is greater than supported on platform.");
-                                return __m128i();
+                                return T();
                             }
                         }
+                        else {
+                            // no register wide enough for this combination at the compiled ISA level
+                            return T();
+                        }
                     }
+#endif
                 }
-                else {
-                    // need to add ARM case here.
-                    return T();
+                using type = decltype(get_type());
+            };
+
+            /*
+                Type produced by comparisons and used for lane masking. With AVX-512
+                that's a k-register with one bit per lane, for every register width
+                (VL gives masked instructions down to 128 bits). Below that it's
+                the vector type itself, with all bits of a lane set or clear.
+            */
+            template<typename T, size_t LEN>
+            struct mask_type_proxy {
+                constexpr static auto get_type() noexcept {
+                    using vector_type = typename vector_type_proxy<T, LEN>::type;
+                    if constexpr (!USE_AVX512_INTRINSICS || std::is_same_v<vector_type, T>) {
+                        return vector_type();
+                    }
+#if !defined(SW_GENERIC_VECTORS)
+                    else {
+                        constexpr size_t lanes = sizeof(vector_type) / sizeof(T);
+                        if constexpr (lanes <= 8) {
+                            return __mmask8();
+                        }
+                        else if constexpr (lanes <= 16) {
+                            return __mmask16();
+                        }
+                        else if constexpr (lanes <= 32) {
+                            return __mmask32();
+                        }
+                        else {
+                            return __mmask64();
+                        }
+                    }
+#endif
                 }
-            }
-            using type = decltype(get_type());
-        };
+                using type = decltype(get_type());
+            };
 
-    }
+        }
 
-    template<typename T, size_t LEN>
-    constexpr bool is_simd_compatible = !std::is_same_v<T, detail::vector_type_proxy<T, LEN>::type >> ;
+        template<typename T, size_t LEN>
+        constexpr bool is_simd_compatible = !std::is_same_v<T, typename detail::vector_type_proxy<T, LEN>::type>;
 
-    template<typename T, size_t LEN>
-    constexpr size_t vectorized_alignment = alignof(detail::vector_type_proxy<T, LEN>::type);
+        template<typename T, size_t LEN>
+        constexpr size_t vectorized_alignment = alignof(typename detail::vector_type_proxy<T, LEN>::type);
 
-    template<typename T, size_t LEN>
-    struct simd_traits {
-        using vector_type = detail::vector_type_proxy<T, LEN>::type;
-        using value_type = T;
-        constexpr static size_t num_entries = sizeof(vector_type) / sizeof(T);
-        constexpr static size_t remainder_entries = num_entries % LEN;
-        constexpr static size_t alignment = vectorized_alignment<T, LEN>;
-    };
+        template<typename T, size_t LEN>
+        struct simd_traits {
+            using vector_type = typename detail::vector_type_proxy<T, LEN>::type;
+            using mask_type = typename detail::mask_type_proxy<T, LEN>::type;
+            using value_type = T;
+            constexpr static size_t num_entries = sizeof(vector_type) / sizeof(T);
+            // lanes of the register beyond LEN, which loads, stores and reductions mask off
+            constexpr static size_t remainder_entries = num_entries - LEN;
+            constexpr static size_t alignment = vectorized_alignment<T, LEN>;
+        };
+
+        // lanes in the widest register available for T at the compiled level,
+        // what bulk kernels should use for their steady state
+        template<typename T>
+        constexpr size_t native_length = USE_AVX512_INTRINSICS ? 64 / sizeof(T) : (USE_AVX_INTRINSICS ? 32 / sizeof(T) : 16 / sizeof(T));
+
+    }
 
 }
 #endif //!SIMD_WRAP_SIMD_TRAITS_HPP
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef SIMD_WRAP_EXPRESSION_TEMPLATE_UNARY_OPERATORS_HPP
+#define SIMD_WRAP_EXPRESSION_TEMPLATE_UNARY_OPERATORS_HPP
+#include "binary_operators.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            decltype(auto) negate_val(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // flips the sign bit of floats as well
+                    return -a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_floating_point_v<T>) {
+                    // flipping the sign bit keeps -0.0 and NaN payloads intact, unlike 0 - a
+                    const vector_type sign_mask = broadcast_val<T, LEN>(T(-0.0));
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_xor_ps(a, sign_mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_xor_pd(a, sign_mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_xor_ps(a, sign_mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_xor_pd(a, sign_mask);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_xor_ps(a, sign_mask);
+                    }
+                    else {
+                        return _mm512_xor_pd(a, sign_mask);
+                    }
+                }
+                else {
+                    return sub_vals<T, LEN>(vector_type_t<T, LEN>{}, a);
+                }
+#endif
+            }
+
+        }
+
+        template<typename OP>
+        struct expression_negate {
+            using value_type = typename OP::value_type;
+            constexpr static size_t length = OP::length;
+            using vector_type = detail::vector_type_t<value_type, length>;
+            using operand_ref_type = typename detail::expr_node_traits<OP>::reference_type;
+
+            expression_negate(OP const& operand_) noexcept : operand(operand_) {}
+            vector_type operator()() const noexcept {
+                return detail::negate_val<value_type, length>(operand());
+            }
+
+            operand_ref_type operand;
+        };
+
+        namespace detail {
+
+            template<typename OP>
+            struct is_expression_node<expression_negate<OP>> : std::true_type {};
+
+        }
+
+        template<typename OP, typename = std::enable_if_t<detail::is_expression_node_v<OP>>>
+        auto operator-(OP const& operand) noexcept {
+            return expression_negate<OP>(operand);
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_EXPRESSION_TEMPLATE_UNARY_OPERATORS_HPP
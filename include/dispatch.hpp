@@ -0,0 +1,57 @@
+#pragma once
+#ifndef SIMD_WRAP_DISPATCH_HPP
+#define SIMD_WRAP_DISPATCH_HPP
+#include "detail/simd_traits.hpp"
+
+/*
+    Runtime selection of the instruction set used by the precompiled bulk
+    kernels (see kernels.hpp). The host is probed once, on first use, and the
+    kernels get bound to the best level that was both compiled in and is
+    supported by the CPU and OS. Header-only code keeps using whatever level
+    the including translation unit was compiled for (compiled_isa).
+*/
+
+namespace sw {
+
+    struct cpu_features {
+        bool sse41 = false;
+        bool popcnt = false;
+        // the AVX bits are only set if the OS also saves the wider register state
+        bool avx = false;
+        bool avx2 = false;
+        bool fma = false;
+        bool f16c = false;
+        bool bmi2 = false;
+        bool avx512f = false;
+        bool avx512bw = false;
+        bool avx512dq = false;
+        bool avx512vl = false;
+    };
+
+    // Reads CPUID/XGETBV the first time it is called, then returns the cached result
+    const cpu_features& detect_cpu_features() noexcept;
+
+    // Highest isa level the host can run. Doesn't consider what was compiled in.
+    isa best_supported_isa() noexcept;
+
+    // Highest level a CPU with these features can run: every instruction the
+    // level is compiled for (SIMDWRAP_ISA_FLAGS_* in CMakeLists.txt) has to be there
+    isa best_supported_isa(cpu_features const& features) noexcept;
+
+    bool is_supported(isa level) noexcept;
+
+    // Level the dispatched kernels are currently bound to
+    isa active_isa() noexcept;
+
+    // Rebinds the dispatched kernels to the given level, e.g. for testing or
+    // to work around a slow AVX-512 frequency transition. Returns false and
+    // leaves the binding alone if the host can't run that level or no kernels
+    // were built for it.
+    bool set_active_isa(isa level) noexcept;
+
+    // Short lowercase name, meant for logging
+    const char* isa_name(isa level) noexcept;
+
+}
+
+#endif //!SIMD_WRAP_DISPATCH_HPP
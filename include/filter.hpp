@@ -0,0 +1,71 @@
+#pragma once
+#ifndef SIMD_WRAP_FILTER_HPP
+#define SIMD_WRAP_FILTER_HPP
+#include <cassert>
+#include "mask.hpp"
+#include "transform.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            /*
+                Stream compaction: every full register stores all of its lanes at
+                the current end of the output and then moves the end on by the
+                number of kept lanes, so there's no branch on the data. Writes
+                stay at or before the block being read, which makes filtering in
+                place safe. The tail is masked to the elements left.
+            */
+            template<typename T, size_t LEN, typename K, typename Pred>
+            size_t filter_spans(Pred& pred, const K* keys, const T* in, T* out, size_t count) {
+                static_assert(simd_traits<T, LEN>::remainder_entries == 0, "Bulk functions work on whole registers, LEN has to fill one.");
+                static_assert(sizeof(K) == sizeof(T), "Keys and values of a filter need lanes of the same width.");
+                size_t written = 0;
+                size_t i = 0;
+                for (; i + LEN <= count; i += LEN) {
+                    const mask<K, LEN> keep = pred(vector<K, LEN>::load_unaligned(keys + i));
+                    written += compress_store_vals<T, LEN, true>(out + written, vector<T, LEN>::load_unaligned(in + i)(), keep.bits());
+                }
+                if (i < count) {
+                    const mask<K, LEN> keep = pred(vector<K, LEN>::load_partial(keys + i, count - i)) & mask<K, LEN>::first(count - i);
+                    written += compress_store_vals<T, LEN>(out + written, vector<T, LEN>::load_partial(in + i, count - i)(), keep.bits());
+                }
+                return written;
+            }
+
+        }
+
+        /*
+            Copies the elements of in for which pred returns a set lane to the
+            front of out, keeping their order, and returns how many there were.
+            pred gets a vector<T, LEN> const& and returns a mask<T, LEN>, e.g.
+
+                size_t n = sw::filter(sw::span(a), sw::span(out), [](auto const& x) { return x > 0.5f; });
+
+            out needs room for all of in (it may be in itself), elements past
+            the returned count are left in an unspecified state.
+        */
+        template<size_t LEN = 0, typename I0, typename T, typename Pred>
+        size_t filter(span<I0> in, span<T> out, Pred pred) {
+            static_assert(std::is_same_v<std::remove_const_t<I0>, T>, "Input and output of a filter have to share their element type.");
+            assert(out.size() >= in.size());
+            const T* data = in.data();
+            return detail::filter_spans<T, detail::bulk_length<T, LEN>>(pred, data, data, out.data(), in.size());
+        }
+
+        // The elements of values where pred holds for the key at the same index, e.g. the rows of one column selected by another
+        template<size_t LEN = 0, typename I0, typename I1, typename T, typename Pred>
+        size_t filter(span<I0> keys, span<I1> values, span<T> out, Pred pred) {
+            static_assert(std::is_same_v<std::remove_const_t<I1>, T>, "Values and output of a filter have to share their element type.");
+            assert(values.size() >= keys.size() && out.size() >= keys.size());
+            return detail::filter_spans<T, detail::bulk_length<T, LEN>>(pred, static_cast<const std::remove_const_t<I0>*>(keys.data()),
+                static_cast<const T*>(values.data()), out.data(), keys.size());
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_FILTER_HPP
@@ -0,0 +1,133 @@
+#pragma once
+#ifndef SIMD_WRAP_FIXED_POINT_HPP
+#define SIMD_WRAP_FIXED_POINT_HPP
+#include <cstdint>
+#include <limits>
+#include "integer_functions.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // Q15 product with the one overflow, -1 * -1, clamped to the largest value
+            template<size_t LEN>
+            vector_type_t<int16_t, LEN> q15_mul_vals(vector_type_t<int16_t, LEN> a, vector_type_t<int16_t, LEN> b) noexcept {
+                const auto product = mulhrs_vals<int16_t, LEN>(a, b);
+                const auto overflow = compare_vals<int16_t, LEN, compare_op::eq>(product, broadcast_val<int16_t, LEN>(std::numeric_limits<int16_t>::min()));
+                return select_vals<int16_t, LEN>(overflow, broadcast_val<int16_t, LEN>(std::numeric_limits<int16_t>::max()), product);
+            }
+
+            /*
+                There is no 8 bit multiply. Both halves are widened to 16 bits and
+                b moved up by 8, so the >> 15 of mulhrs rounds off 7 bits, then
+                they are packed back with saturation.
+            */
+            template<size_t LEN>
+            vector_type_t<int8_t, LEN> q7_mul_vals(vector_type_t<int8_t, LEN> a, vector_type_t<int8_t, LEN> b) noexcept {
+                constexpr size_t half = simd_traits<int8_t, LEN>::num_entries / 2;
+                const auto low = mulhrs_vals<int16_t, half>(widen_vals<int8_t, LEN, false>(a), shift_left_vals<int16_t, half>(widen_vals<int8_t, LEN, false>(b), 8));
+                const auto high = mulhrs_vals<int16_t, half>(widen_vals<int8_t, LEN, true>(a), shift_left_vals<int16_t, half>(widen_vals<int8_t, LEN, true>(b), 8));
+                return pack_saturate_vals<int8_t, int16_t, half>(low, high);
+            }
+
+        }
+
+        /*
+            Signed fractions in [-1, 1) as int16_t (Q15) or int8_t (Q7) lanes:
+            the raw value is the number times 2^15 or 2^7. Twice or four times
+            the lanes of a float register, for audio and image code that fits
+            the precision. All arithmetic saturates instead of wrapping, and
+            products are rounded to nearest.
+        */
+        template<typename T, size_t LEN>
+        class fixed_point {
+        public:
+            static_assert(std::is_same_v<T, int16_t> || std::is_same_v<T, int8_t>, "fixed_point is Q15 on int16_t or Q7 on int8_t lanes.");
+            using value_type = T;
+            using vector_type = vector<T, LEN>;
+            constexpr static size_t length = LEN;
+            constexpr static int fraction_bits = int(sizeof(T) * 8) - 1;
+
+            // nearest raw value of x, clamped to the representable range
+            static constexpr T to_raw(float x) noexcept {
+                const float scaled = x * float(1 << fraction_bits);
+                if (scaled >= float(std::numeric_limits<T>::max())) {
+                    return std::numeric_limits<T>::max();
+                }
+                if (scaled <= float(std::numeric_limits<T>::min())) {
+                    return std::numeric_limits<T>::min();
+                }
+                return T(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+            }
+
+            static constexpr float to_float(T raw) noexcept {
+                return float(raw) / float(1 << fraction_bits);
+            }
+
+            fixed_point() noexcept = default;
+            // value in every lane
+            explicit fixed_point(float value) noexcept : data(to_raw(value)) {}
+            explicit fixed_point(vector_type const& raw_values) noexcept : data(raw_values) {}
+
+            // raw values, ptr needs no alignment. Lanes past count are zero
+            static fixed_point load(const T* ptr, size_t count = LEN) noexcept {
+                return fixed_point(vector_type::load_partial(ptr, count));
+            }
+
+            void store(T* ptr, size_t count = LEN) const noexcept {
+                data.store_partial(ptr, count);
+            }
+
+            vector_type const& raw() const noexcept {
+                return data;
+            }
+
+        private:
+            vector_type data;
+        };
+
+        template<size_t LEN = native_length<int16_t>>
+        using q15 = fixed_point<int16_t, LEN>;
+
+        template<size_t LEN = native_length<int8_t>>
+        using q7 = fixed_point<int8_t, LEN>;
+
+        template<typename T, size_t LEN>
+        fixed_point<T, LEN> operator+(fixed_point<T, LEN> const& a, fixed_point<T, LEN> const& b) noexcept {
+            return fixed_point<T, LEN>(adds(a.raw(), b.raw()));
+        }
+
+        template<typename T, size_t LEN>
+        fixed_point<T, LEN> operator-(fixed_point<T, LEN> const& a, fixed_point<T, LEN> const& b) noexcept {
+            return fixed_point<T, LEN>(subs(a.raw(), b.raw()));
+        }
+
+        // -(-1) saturates to the largest value
+        template<typename T, size_t LEN>
+        fixed_point<T, LEN> operator-(fixed_point<T, LEN> const& a) noexcept {
+            return fixed_point<T, LEN>(subs(vector<T, LEN>(), a.raw()));
+        }
+
+        template<typename T, size_t LEN>
+        fixed_point<T, LEN> operator*(fixed_point<T, LEN> const& a, fixed_point<T, LEN> const& b) noexcept {
+            if constexpr (std::is_same_v<T, int16_t>) {
+                return fixed_point<T, LEN>(vector<T, LEN>(detail::q15_mul_vals<LEN>(a.raw()(), b.raw()())));
+            }
+            else {
+                return fixed_point<T, LEN>(vector<T, LEN>(detail::q7_mul_vals<LEN>(a.raw()(), b.raw()())));
+            }
+        }
+
+        // (a + b) / 2, rounded up on ties
+        template<typename T, size_t LEN>
+        fixed_point<T, LEN> average(fixed_point<T, LEN> const& a, fixed_point<T, LEN> const& b) noexcept {
+            return fixed_point<T, LEN>(avg(a.raw(), b.raw()));
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_FIXED_POINT_HPP
@@ -0,0 +1,297 @@
+#pragma once
+#ifndef SIMD_WRAP_GATHER_HPP
+#define SIMD_WRAP_GATHER_HPP
+#include <algorithm>
+#include <cassert>
+#include "mask.hpp"
+#include "transform.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            template<typename I>
+            constexpr bool is_gather_index_v = std::is_same_v<I, int32_t> || std::is_same_v<I, int64_t>;
+
+            /*
+                Masked gather with the instructions, always through the integer
+                forms: the lanes are only moved, so floats are gathered as their
+                bits. Lanes with a clear mask keep src and read no memory. AVX2
+                masks are registers, AVX-512 ones k-masks for every width.
+            */
+            template<typename T, size_t LEN, typename I>
+            vector_type_t<T, LEN> hardware_gather_vals(const T* base, vector_type_t<I, LEN> index, mask_type_t<T, LEN> mask, vector_type_t<T, LEN> src) noexcept {
+#if !defined(SW_GENERIC_VECTORS)
+                using int_type = int_register_t<vector_type_t<T, LEN>>;
+                using index_type = vector_type_t<I, LEN>;
+                constexpr int scale = int(sizeof(T));
+                const int_type source = as_int_bits<T, LEN>(src);
+                int_type result;
+                if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (sizeof(T) == 4 && sizeof(I) == 4) {
+                        if constexpr (std::is_same_v<int_type, __m512i>) {
+                            result = _mm512_mask_i32gather_epi32(source, mask, index, base, scale);
+                        }
+                        else if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mmask_i32gather_epi32(source, mask, index, base, scale);
+                        }
+                        else {
+                            result = _mm_mmask_i32gather_epi32(source, mask, index, base, scale);
+                        }
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        // 64 bit indices fill twice the register of the data
+                        if constexpr (std::is_same_v<index_type, __m512i>) {
+                            result = _mm512_mask_i64gather_epi32(source, mask, index, base, scale);
+                        }
+                        else if constexpr (std::is_same_v<index_type, __m256i>) {
+                            result = _mm256_mmask_i64gather_epi32(source, mask, index, base, scale);
+                        }
+                        else {
+                            result = _mm_mmask_i64gather_epi32(source, mask, index, base, scale);
+                        }
+                    }
+                    else if constexpr (sizeof(I) == 4) {
+                        if constexpr (std::is_same_v<int_type, __m512i>) {
+                            result = _mm512_mask_i32gather_epi64(source, mask, index, base, scale);
+                        }
+                        else if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mmask_i32gather_epi64(source, mask, index, base, scale);
+                        }
+                        else {
+                            result = _mm_mmask_i32gather_epi64(source, mask, index, base, scale);
+                        }
+                    }
+                    else {
+                        if constexpr (std::is_same_v<int_type, __m512i>) {
+                            result = _mm512_mask_i64gather_epi64(source, mask, index, base, scale);
+                        }
+                        else if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mmask_i64gather_epi64(source, mask, index, base, scale);
+                        }
+                        else {
+                            result = _mm_mmask_i64gather_epi64(source, mask, index, base, scale);
+                        }
+                    }
+                }
+                else {
+                    const int_type lanes = bit_cast_register<int_type>(mask);
+                    const int* base32 = reinterpret_cast<const int*>(base);
+                    const long long* base64 = reinterpret_cast<const long long*>(base);
+                    if constexpr (sizeof(T) == 4 && sizeof(I) == 4) {
+                        if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mask_i32gather_epi32(source, base32, index, lanes, scale);
+                        }
+                        else {
+                            result = _mm_mask_i32gather_epi32(source, base32, index, lanes, scale);
+                        }
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        if constexpr (std::is_same_v<index_type, __m256i>) {
+                            result = _mm256_mask_i64gather_epi32(source, base32, index, lanes, scale);
+                        }
+                        else {
+                            result = _mm_mask_i64gather_epi32(source, base32, index, lanes, scale);
+                        }
+                    }
+                    else if constexpr (sizeof(I) == 4) {
+                        if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mask_i32gather_epi64(source, base64, index, lanes, scale);
+                        }
+                        else {
+                            result = _mm_mask_i32gather_epi64(source, base64, index, lanes, scale);
+                        }
+                    }
+                    else {
+                        if constexpr (std::is_same_v<int_type, __m256i>) {
+                            result = _mm256_mask_i64gather_epi64(source, base64, index, lanes, scale);
+                        }
+                        else {
+                            result = _mm_mask_i64gather_epi64(source, base64, index, lanes, scale);
+                        }
+                    }
+                }
+                return from_int_bits<T, LEN>(result);
+#endif
+            }
+
+            // AVX-512 only, lanes are written in order so the last of equal indices wins
+            template<typename T, size_t LEN, typename I>
+            void hardware_scatter_vals(T* base, vector_type_t<I, LEN> index, mask_type_t<T, LEN> mask, vector_type_t<T, LEN> val) noexcept {
+#if !defined(SW_GENERIC_VECTORS)
+                using int_type = int_register_t<vector_type_t<T, LEN>>;
+                using index_type = vector_type_t<I, LEN>;
+                constexpr int scale = int(sizeof(T));
+                const int_type values = as_int_bits<T, LEN>(val);
+                if constexpr (sizeof(T) == 4 && sizeof(I) == 4) {
+                    if constexpr (std::is_same_v<int_type, __m512i>) {
+                        _mm512_mask_i32scatter_epi32(base, mask, index, values, scale);
+                    }
+                    else if constexpr (std::is_same_v<int_type, __m256i>) {
+                        _mm256_mask_i32scatter_epi32(base, mask, index, values, scale);
+                    }
+                    else {
+                        _mm_mask_i32scatter_epi32(base, mask, index, values, scale);
+                    }
+                }
+                else if constexpr (sizeof(T) == 4) {
+                    if constexpr (std::is_same_v<index_type, __m512i>) {
+                        _mm512_mask_i64scatter_epi32(base, mask, index, values, scale);
+                    }
+                    else if constexpr (std::is_same_v<index_type, __m256i>) {
+                        _mm256_mask_i64scatter_epi32(base, mask, index, values, scale);
+                    }
+                    else {
+                        _mm_mask_i64scatter_epi32(base, mask, index, values, scale);
+                    }
+                }
+                else if constexpr (sizeof(I) == 4) {
+                    if constexpr (std::is_same_v<int_type, __m512i>) {
+                        _mm512_mask_i32scatter_epi64(base, mask, index, values, scale);
+                    }
+                    else if constexpr (std::is_same_v<int_type, __m256i>) {
+                        _mm256_mask_i32scatter_epi64(base, mask, index, values, scale);
+                    }
+                    else {
+                        _mm_mask_i32scatter_epi64(base, mask, index, values, scale);
+                    }
+                }
+                else {
+                    if constexpr (std::is_same_v<int_type, __m512i>) {
+                        _mm512_mask_i64scatter_epi64(base, mask, index, values, scale);
+                    }
+                    else if constexpr (std::is_same_v<int_type, __m256i>) {
+                        _mm256_mask_i64scatter_epi64(base, mask, index, values, scale);
+                    }
+                    else {
+                        _mm_mask_i64scatter_epi64(base, mask, index, values, scale);
+                    }
+                }
+#endif
+            }
+
+            // one scalar load per selected lane, through the stack
+            template<typename T, size_t LEN, typename I>
+            vector_type_t<T, LEN> emulated_gather_vals(const T* base, vector_type_t<I, LEN> index, uint64_t bits, vector_type_t<T, LEN> src) noexcept {
+                alignas(64) I offsets[simd_traits<I, LEN>::num_entries];
+                alignas(64) T lanes[simd_traits<T, LEN>::num_entries];
+                store_vals<I, LEN, true>(offsets, index);
+                store_vals<T, LEN, true>(lanes, src);
+                for (size_t i = 0; i < LEN; ++i) {
+                    if ((bits >> i) & 1) {
+                        lanes[i] = base[offsets[i]];
+                    }
+                }
+                return load_vals<T, LEN, true>(lanes);
+            }
+
+            template<typename T, size_t LEN, typename I>
+            void emulated_scatter_vals(T* base, vector_type_t<I, LEN> index, uint64_t bits, vector_type_t<T, LEN> val) noexcept {
+                alignas(64) I offsets[simd_traits<I, LEN>::num_entries];
+                alignas(64) T lanes[simd_traits<T, LEN>::num_entries];
+                store_vals<I, LEN, true>(offsets, index);
+                store_vals<T, LEN, true>(lanes, val);
+                for (size_t i = 0; i < LEN; ++i) {
+                    if ((bits >> i) & 1) {
+                        base[offsets[i]] = lanes[i];
+                    }
+                }
+            }
+
+            // lanes per register for the bulk functions, both T and I have to fit
+            template<typename T, typename I, size_t LEN>
+            constexpr size_t indexed_length = LEN == 0 ? std::min(native_length<T>, native_length<I>) : LEN;
+
+        }
+
+        /*
+            Lane i of the result is base[index[i]], for the lanes where m is set;
+            the others keep src and read no memory. Indices are int32_t or int64_t
+            element offsets and may be negative. 8 and 16 bit elements, and every
+            level below AVX2, load lane by lane.
+        */
+        template<typename T, size_t LEN, typename I>
+        vector<T, LEN> gather(const T* base, vector<I, LEN> const& index, mask<T, LEN> const& m, vector<T, LEN> const& src = vector<T, LEN>()) noexcept {
+            static_assert(detail::is_gather_index_v<I>, "Gather indices have to be int32_t or int64_t.");
+            if constexpr (USE_HARDWARE_GATHER && sizeof(T) >= 4) {
+                // comparisons may have set the padding lanes
+                const mask<T, LEN> used = simd_traits<T, LEN>::remainder_entries == 0 ? m : m & mask<T, LEN>(true);
+                return vector<T, LEN>(detail::hardware_gather_vals<T, LEN, I>(base, index(), used(), src()));
+            }
+            else {
+                return vector<T, LEN>(detail::emulated_gather_vals<T, LEN, I>(base, index(), m.bits(), src()));
+            }
+        }
+
+        template<typename T, size_t LEN, typename I>
+        vector<T, LEN> gather(const T* base, vector<I, LEN> const& index) noexcept {
+            return gather(base, index, mask<T, LEN>(true));
+        }
+
+        /*
+            base[index[i]] = v[i] for the lanes where m is set, in lane order, so
+            of several lanes with the same index the last one is stored. Uses
+            the instructions with AVX-512 only.
+        */
+        template<typename T, size_t LEN, typename I>
+        void scatter(T* base, vector<I, LEN> const& index, vector<T, LEN> const& v, mask<T, LEN> const& m) noexcept {
+            static_assert(detail::is_gather_index_v<I>, "Scatter indices have to be int32_t or int64_t.");
+            if constexpr (USE_HARDWARE_GATHER && USE_AVX512_INTRINSICS && sizeof(T) >= 4) {
+                const mask<T, LEN> used = simd_traits<T, LEN>::remainder_entries == 0 ? m : m & mask<T, LEN>(true);
+                detail::hardware_scatter_vals<T, LEN, I>(base, index(), used(), v());
+            }
+            else {
+                detail::emulated_scatter_vals<T, LEN, I>(base, index(), m.bits(), v());
+            }
+        }
+
+        template<typename T, size_t LEN, typename I>
+        void scatter(T* base, vector<I, LEN> const& index, vector<T, LEN> const& v) noexcept {
+            scatter(base, index, v, mask<T, LEN>(true));
+        }
+
+        // out[i] = table[indices[i]], a lookup table applied to a whole array
+        template<size_t LEN = 0, typename I0, typename I1, typename T>
+        void gather(span<I0> table, span<I1> indices, span<T> out) {
+            using I = std::remove_const_t<I1>;
+            constexpr size_t lanes = detail::indexed_length<T, I, LEN>;
+            static_assert(std::is_same_v<std::remove_const_t<I0>, T>, "Table and output of a gather have to share their element type.");
+            assert(indices.size() >= out.size());
+            const T* base = table.data();
+            const I* index = indices.data();
+            const size_t count = out.size();
+            size_t i = 0;
+            for (; i + lanes <= count; i += lanes) {
+                gather(base, vector<I, lanes>::load_unaligned(index + i)).store_unaligned(out.data() + i);
+            }
+            if (i < count) {
+                gather(base, vector<I, lanes>::load_partial(index + i, count - i), mask<T, lanes>::first(count - i)).store_partial(out.data() + i, count - i);
+            }
+        }
+
+        // table[indices[i]] = values[i], in order, so later elements win on equal indices
+        template<size_t LEN = 0, typename I0, typename I1, typename T>
+        void scatter(span<I0> values, span<I1> indices, span<T> table) {
+            using I = std::remove_const_t<I1>;
+            constexpr size_t lanes = detail::indexed_length<T, I, LEN>;
+            static_assert(std::is_same_v<std::remove_const_t<I0>, T>, "Values and table of a scatter have to share their element type.");
+            assert(indices.size() >= values.size());
+            const T* data = values.data();
+            const I* index = indices.data();
+            const size_t count = values.size();
+            size_t i = 0;
+            for (; i + lanes <= count; i += lanes) {
+                scatter(table.data(), vector<I, lanes>::load_unaligned(index + i), vector<T, lanes>::load_unaligned(data + i));
+            }
+            if (i < count) {
+                scatter(table.data(), vector<I, lanes>::load_partial(index + i, count - i), vector<T, lanes>::load_partial(data + i, count - i), mask<T, lanes>::first(count - i));
+            }
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_GATHER_HPP
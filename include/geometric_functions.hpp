@@ -0,0 +1,156 @@
+#pragma once
+#ifndef SIMD_WRAP_GEOMETRIC_FUNCTIONS_HPP
+#define SIMD_WRAP_GEOMETRIC_FUNCTIONS_HPP
+#include <cmath>
+#include "vector_functions.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        // Only the first LEN lanes count, so vector<float, 3> behaves as a 3 component vector
+        template<typename T, size_t LEN>
+        T dot(vector<T, LEN> const& a, vector<T, LEN> const& b) noexcept {
+            return reduce_add(a * b);
+        }
+
+        template<typename T, size_t LEN>
+        T length(vector<T, LEN> const& a) noexcept {
+            static_assert(std::is_floating_point_v<T>, "length requires a floating point vector.");
+            return std::sqrt(dot(a, a));
+        }
+
+        // a / length(a), with the inverse length at the given precision
+        template<precision P = precision::exact, typename T, size_t LEN>
+        vector<T, LEN> normalize(vector<T, LEN> const& a) noexcept {
+            static_assert(std::is_floating_point_v<T>, "normalize requires a floating point vector.");
+            return vector<T, LEN>(a * rsqrt<P>(vector<T, LEN>(dot(a, a))));
+        }
+
+        /*
+            COMPONENTS-wide vectors, LEN of them at a time: one register per
+            component, as they come out of a soa_array block. The functions
+            below work lane by lane across components, so no horizontal
+            operation is involved and every lane result is a full element.
+        */
+        template<typename T, size_t COMPONENTS, size_t LEN = native_length<T>>
+        struct soa_vector {
+            using value_type = T;
+            using vector_type = vector<T, LEN>;
+            constexpr static size_t components = COMPONENTS;
+            constexpr static size_t length = LEN;
+
+            vector_type& operator[](size_t component) noexcept {
+                return values[component];
+            }
+
+            vector_type const& operator[](size_t component) const noexcept {
+                return values[component];
+            }
+
+            // from anything with load(component), like soa_array blocks
+            template<typename Block>
+            static soa_vector load(Block const& block) noexcept {
+                soa_vector result;
+                for (size_t c = 0; c < COMPONENTS; ++c) {
+                    result.values[c] = block.load(c);
+                }
+                return result;
+            }
+
+            template<typename Block>
+            void store(Block const& block) const noexcept {
+                for (size_t c = 0; c < COMPONENTS; ++c) {
+                    block.store(c, values[c]);
+                }
+            }
+
+            vector_type values[COMPONENTS];
+        };
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> operator+(soa_vector<T, COMPONENTS, LEN> const& a, soa_vector<T, COMPONENTS, LEN> const& b) noexcept {
+            soa_vector<T, COMPONENTS, LEN> result;
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                result[c] = a[c] + b[c];
+            }
+            return result;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> operator-(soa_vector<T, COMPONENTS, LEN> const& a, soa_vector<T, COMPONENTS, LEN> const& b) noexcept {
+            soa_vector<T, COMPONENTS, LEN> result;
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                result[c] = a[c] - b[c];
+            }
+            return result;
+        }
+
+        // every component of lane i scaled by lane i of s
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> operator*(soa_vector<T, COMPONENTS, LEN> const& a, vector<T, LEN> const& s) noexcept {
+            soa_vector<T, COMPONENTS, LEN> result;
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                result[c] = a[c] * s;
+            }
+            return result;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        vector<T, LEN> dot(soa_vector<T, COMPONENTS, LEN> const& a, soa_vector<T, COMPONENTS, LEN> const& b) noexcept {
+            vector<T, LEN> result = a[0] * b[0];
+            for (size_t c = 1; c < COMPONENTS; ++c) {
+                result = a[c] * b[c] + result;
+            }
+            return result;
+        }
+
+        template<typename T, size_t LEN>
+        soa_vector<T, 3, LEN> cross(soa_vector<T, 3, LEN> const& a, soa_vector<T, 3, LEN> const& b) noexcept {
+            soa_vector<T, 3, LEN> result;
+            result[0] = a[1] * b[2] - a[2] * b[1];
+            result[1] = a[2] * b[0] - a[0] * b[2];
+            result[2] = a[0] * b[1] - a[1] * b[0];
+            return result;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        vector<T, LEN> length(soa_vector<T, COMPONENTS, LEN> const& a) noexcept {
+            static_assert(std::is_floating_point_v<T>, "length requires a floating point vector.");
+            return sqrt(dot(a, a));
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        vector<T, LEN> distance(soa_vector<T, COMPONENTS, LEN> const& a, soa_vector<T, COMPONENTS, LEN> const& b) noexcept {
+            return length(a - b);
+        }
+
+        // zero length lanes come out as NaN
+        template<precision P = precision::exact, typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> normalize(soa_vector<T, COMPONENTS, LEN> const& a) noexcept {
+            static_assert(std::is_floating_point_v<T>, "normalize requires a floating point vector.");
+            return a * rsqrt<P>(dot(a, a));
+        }
+
+        // incident reflected about the unit normal: i - 2 dot(n, i) n
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> reflect(soa_vector<T, COMPONENTS, LEN> const& incident, soa_vector<T, COMPONENTS, LEN> const& normal) noexcept {
+            const vector<T, LEN> scale = dot(normal, incident) * T(-2);
+            soa_vector<T, COMPONENTS, LEN> result;
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                result[c] = normal[c] * scale + incident[c];
+            }
+            return result;
+        }
+
+        // component of a along onto, which doesn't have to be unit length
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_vector<T, COMPONENTS, LEN> project(soa_vector<T, COMPONENTS, LEN> const& a, soa_vector<T, COMPONENTS, LEN> const& onto) noexcept {
+            return onto * vector<T, LEN>(dot(a, onto) / dot(onto, onto));
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_GEOMETRIC_FUNCTIONS_HPP
@@ -0,0 +1,313 @@
+#pragma once
+#ifndef SIMD_WRAP_HALF_HPP
+#define SIMD_WRAP_HALF_HPP
+#include <cstdint>
+#include <cstring>
+#include "vector.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            IEEE 754 binary16, for storage only: convert to float to compute. Half
+            the bytes of a float per element for buffers that are limited by
+            memory bandwidth, with 11 bits of precision and a range of +-65504.
+            The scalar conversions are plain C++, so they are the same at every
+            ISA level. Rounding is to nearest even, like F16C.
+        */
+        class half {
+        public:
+
+            half() noexcept = default;
+            explicit half(float value) noexcept : data(from_float(value)) {}
+
+            operator float() const noexcept {
+                return to_float(data);
+            }
+
+            static half from_bits(uint16_t bits) noexcept {
+                half result;
+                result.data = bits;
+                return result;
+            }
+
+            uint16_t bits() const noexcept {
+                return data;
+            }
+
+            // Giesen's branchy conversions, subnormals go through the FPU to get rounded
+            static uint16_t from_float(float value) noexcept {
+                uint32_t f = float_bits(value);
+                const uint32_t sign = f & 0x80000000u;
+                f ^= sign;
+                uint32_t result;
+                if (f >= 0x47800000u) {
+                    // too large for a half: infinity, and NaN stays NaN
+                    result = f > 0x7F800000u ? 0x7E00u : 0x7C00u;
+                }
+                else if (f < 0x38800000u) {
+                    // adding 0.5 shifts the mantissa into place and rounds it
+                    result = float_bits(bits_float(f) + 0.5f) - 0x3F000000u;
+                }
+                else {
+                    const uint32_t odd = (f >> 13) & 1;
+                    f += (uint32_t(15 - 127) << 23) + 0xFFFu + odd;
+                    result = f >> 13;
+                }
+                return uint16_t(result | (sign >> 16));
+            }
+
+            static float to_float(uint16_t bits) noexcept {
+                constexpr uint32_t shifted_exponent = 0x7C00u << 13;
+                uint32_t result = (bits & 0x7FFFu) << 13;
+                const uint32_t exponent = result & shifted_exponent;
+                result += uint32_t(127 - 15) << 23;
+                if (exponent == shifted_exponent) {
+                    result += uint32_t(128 - 16) << 23;
+                }
+                else if (exponent == 0) {
+                    // subnormal, renormalized by the FPU
+                    result = float_bits(bits_float(result + (1u << 23)) - bits_float(113u << 23));
+                }
+                return bits_float(result | (uint32_t(bits & 0x8000u) << 16));
+            }
+
+        private:
+
+            static uint32_t float_bits(float value) noexcept {
+                uint32_t result;
+                std::memcpy(&result, &value, sizeof(result));
+                return result;
+            }
+
+            static float bits_float(uint32_t bits) noexcept {
+                float result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result;
+            }
+
+            uint16_t data;
+        };
+
+        static_assert(sizeof(half) == 2, "half has to be two bytes to be loaded as an array of them.");
+
+        namespace detail {
+
+            template<typename S>
+            constexpr bool is_half_v = std::is_same_v<std::remove_const_t<S>, half>;
+
+            // the type elements of S are computed in, float for half
+            template<typename S>
+            using compute_type_t = std::conditional_t<is_half_v<S>, float, std::remove_const_t<S>>;
+
+#if !defined(SW_GENERIC_VECTORS)
+            // half::to_float on four 32 bit lanes holding half bits, for SSE4.1 without F16C
+            inline __m128 half_to_float_vals(__m128i bits) noexcept {
+                const __m128i shifted_exponent = _mm_set1_epi32(0x7C00 << 13);
+                __m128i result = _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7FFF)), 13);
+                const __m128i exponent = _mm_and_si128(result, shifted_exponent);
+                result = _mm_add_epi32(result, _mm_set1_epi32((127 - 15) << 23));
+                const __m128i special = _mm_cmpeq_epi32(exponent, shifted_exponent);
+                result = _mm_add_epi32(result, _mm_and_si128(special, _mm_set1_epi32((128 - 16) << 23)));
+                const __m128 renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(result, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+                result = _mm_blendv_epi8(result, _mm_castps_si128(renormalized), _mm_cmpeq_epi32(exponent, _mm_setzero_si128()));
+                return _mm_castsi128_ps(_mm_or_si128(result, _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x8000)), 16)));
+            }
+
+            // half::from_float on four lanes, the half bits in the low 16 of each 32
+            inline __m128i float_to_half_vals(__m128 value) noexcept {
+                __m128i f = _mm_castps_si128(value);
+                const __m128i sign = _mm_and_si128(f, _mm_set1_epi32(int(0x80000000u)));
+                // without the sign the signed compares order the bits correctly
+                f = _mm_xor_si128(f, sign);
+                const __m128i too_large = _mm_cmpgt_epi32(f, _mm_set1_epi32(0x47800000 - 1));
+                const __m128i is_nan = _mm_cmpgt_epi32(f, _mm_set1_epi32(0x7F800000));
+                const __m128i is_small = _mm_cmplt_epi32(f, _mm_set1_epi32(0x38800000));
+                const __m128i large = _mm_blendv_epi8(_mm_set1_epi32(0x7C00), _mm_set1_epi32(0x7E00), is_nan);
+                const __m128i small = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(f), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3F000000));
+                const __m128i odd = _mm_and_si128(_mm_srli_epi32(f, 13), _mm_set1_epi32(1));
+                const __m128i rebiased = _mm_add_epi32(f, _mm_set1_epi32(int((uint32_t(15 - 127) << 23) + 0xFFFu)));
+                const __m128i normal = _mm_srli_epi32(_mm_add_epi32(rebiased, odd), 13);
+                __m128i result = _mm_blendv_epi8(normal, small, is_small);
+                result = _mm_blendv_epi8(result, large, too_large);
+                return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+            }
+#endif
+
+            // count halves into a float register, F16C from AVX2 up, one at a time for the generic backend
+            template<size_t LEN>
+            vector_type_t<float, LEN> load_f16_vals(const half* ptr, size_t count) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    vector_type_t<float, LEN> result{};
+                    for (size_t i = 0; i < count; ++i) {
+                        result[i] = half::to_float(ptr[i].bits());
+                    }
+                    return result;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    constexpr size_t lanes = simd_traits<float, LEN>::num_entries;
+                    using half_register = std::conditional_t<lanes == 16, __m256i, __m128i>;
+                    half_register raw;
+                    if (count >= lanes) {
+                        if constexpr (lanes == 16) {
+                            raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+                        }
+                        else if constexpr (lanes == 8) {
+                            raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+                        }
+                        else {
+                            raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr));
+                        }
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS) {
+                        const __mmask16 mask = __mmask16((1u << count) - 1);
+                        if constexpr (lanes == 16) {
+                            raw = _mm256_maskz_loadu_epi16(mask, ptr);
+                        }
+                        else {
+                            raw = _mm_maskz_loadu_epi16(__mmask8(mask), ptr);
+                        }
+                    }
+                    else {
+                        alignas(half_register) half buffer[sizeof(half_register) / sizeof(half)] = {};
+                        std::memcpy(buffer, ptr, count * sizeof(half));
+                        std::memcpy(&raw, buffer, sizeof(raw));
+                    }
+                    if constexpr (lanes == 16) {
+                        return _mm512_cvtph_ps(raw);
+                    }
+                    else if constexpr (lanes == 8) {
+                        return _mm256_cvtph_ps(raw);
+                    }
+                    else if constexpr (USE_AVX_INTRINSICS) {
+                        return _mm_cvtph_ps(raw);
+                    }
+                    else {
+                        return half_to_float_vals(_mm_cvtepu16_epi32(raw));
+                    }
+                }
+#endif
+            }
+
+            template<size_t LEN>
+            void store_f16_vals(half* ptr, vector_type_t<float, LEN> val, size_t count) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    for (size_t i = 0; i < count; ++i) {
+                        ptr[i] = half::from_bits(half::from_float(val[i]));
+                    }
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    constexpr size_t lanes = simd_traits<float, LEN>::num_entries;
+                    constexpr int rounding = _MM_FROUND_TO_NEAREST_INT;
+                    using half_register = std::conditional_t<lanes == 16, __m256i, __m128i>;
+                    half_register raw;
+                    if constexpr (lanes == 16) {
+                        raw = _mm512_cvtps_ph(val, rounding);
+                    }
+                    else if constexpr (lanes == 8) {
+                        raw = _mm256_cvtps_ph(val, rounding);
+                    }
+                    else if constexpr (USE_AVX_INTRINSICS) {
+                        raw = _mm_cvtps_ph(val, rounding);
+                    }
+                    else {
+                        const __m128i bits = float_to_half_vals(val);
+                        raw = _mm_packus_epi32(bits, bits);
+                    }
+                    if (count >= lanes) {
+                        if constexpr (lanes == 16) {
+                            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), raw);
+                        }
+                        else if constexpr (lanes == 8) {
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), raw);
+                        }
+                        else {
+                            _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), raw);
+                        }
+                    }
+                    else if constexpr (USE_AVX512_INTRINSICS) {
+                        const __mmask16 mask = __mmask16((1u << count) - 1);
+                        if constexpr (lanes == 16) {
+                            _mm256_mask_storeu_epi16(ptr, mask, raw);
+                        }
+                        else {
+                            _mm_mask_storeu_epi16(ptr, __mmask8(mask), raw);
+                        }
+                    }
+                    else {
+                        // half is only a wrapper around its bits, void* keeps gcc from flagging the copy
+                        std::memcpy(static_cast<void*>(ptr), &raw, count * sizeof(half));
+                    }
+                }
+#endif
+            }
+
+            // element loads and stores of the bulk functions, converting half storage on the way
+            template<typename T, size_t LEN, bool ALIGNED, typename S>
+            vector<T, LEN> load_elements(const S* ptr) noexcept {
+                if constexpr (is_half_v<S>) {
+                    return vector<T, LEN>(load_f16_vals<LEN>(ptr, LEN));
+                }
+                else if constexpr (ALIGNED) {
+                    return vector<T, LEN>::load(ptr);
+                }
+                else {
+                    return vector<T, LEN>::load_unaligned(ptr);
+                }
+            }
+
+            template<typename T, size_t LEN, typename S>
+            vector<T, LEN> load_elements_partial(const S* ptr, size_t count) noexcept {
+                if constexpr (is_half_v<S>) {
+                    return vector<T, LEN>(load_f16_vals<LEN>(ptr, count < LEN ? count : LEN));
+                }
+                else {
+                    return vector<T, LEN>::load_partial(ptr, count);
+                }
+            }
+
+            template<typename T, size_t LEN, bool ALIGNED, typename S>
+            void store_elements(S* ptr, vector<T, LEN> const& val) noexcept {
+                if constexpr (is_half_v<S>) {
+                    store_f16_vals<LEN>(ptr, val(), LEN);
+                }
+                else if constexpr (ALIGNED) {
+                    val.store(ptr);
+                }
+                else {
+                    val.store_unaligned(ptr);
+                }
+            }
+
+            template<typename T, size_t LEN, typename S>
+            void store_elements_partial(S* ptr, vector<T, LEN> const& val, size_t count) noexcept {
+                if constexpr (is_half_v<S>) {
+                    store_f16_vals<LEN>(ptr, val(), count < LEN ? count : LEN);
+                }
+                else {
+                    val.store_partial(ptr, count);
+                }
+            }
+
+        }
+
+        // Reads min(count, LEN) halves into the lanes of a float vector, the rest are zero
+        template<size_t LEN>
+        vector<float, LEN> load_f16(const half* ptr, size_t count = LEN) noexcept {
+            return vector<float, LEN>(detail::load_f16_vals<LEN>(ptr, count < LEN ? count : LEN));
+        }
+
+        // Writes the first min(count, LEN) lanes as halves, rounded to nearest even
+        template<size_t LEN>
+        void store_f16(half* ptr, vector<float, LEN> const& v, size_t count = LEN) noexcept {
+            detail::store_f16_vals<LEN>(ptr, v(), count < LEN ? count : LEN);
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_HALF_HPP
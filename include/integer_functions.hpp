@@ -0,0 +1,216 @@
+#pragma once
+#ifndef SIMD_WRAP_INTEGER_FUNCTIONS_HPP
+#define SIMD_WRAP_INTEGER_FUNCTIONS_HPP
+#include <cassert>
+#include <cstdint>
+#include "vector_functions.hpp"
+#include "detail/integer_operators.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            Division by a divisor that's fixed for many numerators, like a table
+            size, as a multiply by a precomputed magic number and shifts (Granlund
+            and Montgomery, "Division by invariant integers using multiplication").
+            Results match the / operator, truncating towards zero. Constructing
+            one costs a 64 bit division, so it pays off after a few uses.
+        */
+        template<typename T>
+        class divider {
+        public:
+
+            explicit divider(T d) noexcept : value(d) {
+                // checked here, as operator/ below names divider<T> for any vector
+                static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>, "divider is only implemented for 32 bit integers.");
+                assert(d != 0);
+                if constexpr (std::is_unsigned_v<T>) {
+                    // l = ceil(log2(d)), m = floor(2^32 (2^l - d) / d) + 1
+                    int l = 0;
+                    while (l < 32 && (uint64_t(1) << l) < d) {
+                        ++l;
+                    }
+                    magic = uint32_t((uint64_t(1) << 32) * ((uint64_t(1) << l) - d) / d + 1);
+                    first_shift = l < 1 ? l : 1;
+                    second_shift = l > 1 ? l - 1 : 0;
+                }
+                else {
+                    // l = max(ceil(log2(|d|)), 1), m = 2^(31 + l) / |d| + 1 - 2^32
+                    const uint32_t magnitude = d < 0 ? uint32_t(0) - uint32_t(d) : uint32_t(d);
+                    int l = 1;
+                    while ((uint64_t(1) << l) < magnitude) {
+                        ++l;
+                    }
+                    magic = uint32_t((uint64_t(1) << (31 + l)) / magnitude + 1);
+                    first_shift = l - 1;
+                    second_shift = 0;
+                }
+            }
+
+            T divisor() const noexcept {
+                return value;
+            }
+
+            // n / divisor(), the same steps as for a vector
+            T divide(T n) const noexcept {
+                if constexpr (std::is_unsigned_v<T>) {
+                    const uint32_t t = uint32_t((uint64_t(magic) * n) >> 32);
+                    return (t + ((n - t) >> first_shift)) >> second_shift;
+                }
+                else {
+                    // wrapping adds, the numerator can be anything
+                    const int32_t high = int32_t((int64_t(int32_t(magic)) * n) >> 32);
+                    const int32_t q = int32_t(uint32_t(n) + uint32_t(high)) >> first_shift;
+                    const uint32_t rounded = uint32_t(q) - uint32_t(n >> 31);
+                    const uint32_t sign = uint32_t(value >> 31);
+                    return int32_t((rounded ^ sign) - sign);
+                }
+            }
+
+            uint32_t multiplier() const noexcept {
+                return magic;
+            }
+
+            // only the first is used for signed divisors
+            int shift(size_t index) const noexcept {
+                return index == 0 ? first_shift : second_shift;
+            }
+
+        private:
+            T value;
+            uint32_t magic;
+            int first_shift;
+            int second_shift;
+        };
+
+        namespace detail {
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> divide_vals(vector_type_t<T, LEN> n, divider<T> const& d) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                const vector_type magic = broadcast_val<T, LEN>(T(d.multiplier()));
+                if constexpr (std::is_unsigned_v<T>) {
+                    const vector_type t = mulhi_vals<T, LEN>(n, magic);
+                    const vector_type half_difference = shift_right_vals<T, LEN>(sub_vals<T, LEN>(n, t), d.shift(0));
+                    return shift_right_vals<T, LEN>(add_vals<T, LEN>(t, half_difference), d.shift(1));
+                }
+                else {
+                    const vector_type q = shift_right_vals<T, LEN>(add_vals<T, LEN>(n, mulhi_vals<T, LEN>(n, magic)), d.shift(0));
+                    // rounds the negative quotients up towards zero
+                    const vector_type rounded = sub_vals<T, LEN>(q, shift_right_vals<T, LEN>(n, 31));
+                    const vector_type sign = broadcast_val<T, LEN>(T(d.divisor() >> 31));
+                    return sub_vals<T, LEN>(xor_vals<T, LEN>(rounded, sign), sign);
+                }
+            }
+
+        }
+
+        // Low half of the lane-wise product, what the * operator does for integers
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> mullo(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "mullo arguments must have the same type and length.");
+            static_assert(std::is_integral_v<value_type>, "mullo requires an integer vector.");
+            return detail::math_result_t<EXPR0>(detail::mul_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        // High half of the lane-wise product, for 16 and 32 bit lanes
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> mulhi(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "mulhi arguments must have the same type and length.");
+            static_assert(std::is_integral_v<value_type>, "mulhi requires an integer vector.");
+            return detail::math_result_t<EXPR0>(detail::mulhi_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> shift_left(EXPR const& x, int count) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_integral_v<value_type>, "shift_left requires an integer vector.");
+            return detail::math_result_t<EXPR>(detail::shift_left_vals<value_type, EXPR::length>(x(), count));
+        }
+
+        // Arithmetic for signed lanes, logical for unsigned ones
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> shift_right(EXPR const& x, int count) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_integral_v<value_type>, "shift_right requires an integer vector.");
+            return detail::math_result_t<EXPR>(detail::shift_right_vals<value_type, EXPR::length>(x(), count));
+        }
+
+        // a + b per lane, clamped to the range of the 8 or 16 bit lanes instead of wrapping
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> adds(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "adds arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::adds_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> subs(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "subs arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::subs_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        // (a * b + 2^14) >> 15 for int16_t lanes, the rounded product of two Q15 numbers
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> mulhrs(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "mulhrs arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::mulhrs_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        // (a + b + 1) / 2 per lane without overflow, 8 and 16 bit lanes
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> avg(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "avg arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::avg_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        /*
+            The lanes of a followed by those of b, each clamped to the range of
+            To, half as wide: int16_t to int8_t or uint8_t, int32_t to int16_t or
+            uint16_t, and the unsigned types to their unsigned halves. Both have
+            to fill their register.
+        */
+        template<typename To, typename T, size_t LEN>
+        vector<To, LEN * 2> pack_saturate(vector<T, LEN> const& a, vector<T, LEN> const& b) noexcept {
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0, "pack_saturate works on whole registers.");
+            return vector<To, LEN * 2>(detail::pack_saturate_vals<To, T, LEN>(a(), b()));
+        }
+
+        // the first LEN / 2 lanes sign or zero extended to twice their width
+        template<typename T, size_t LEN>
+        vector<detail::widened_t<T>, LEN / 2> widen_low(vector<T, LEN> const& v) noexcept {
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0, "widen_low works on whole registers.");
+            return vector<detail::widened_t<T>, LEN / 2>(detail::widen_vals<T, LEN, false>(v()));
+        }
+
+        // the last LEN / 2 lanes sign or zero extended to twice their width
+        template<typename T, size_t LEN>
+        vector<detail::widened_t<T>, LEN / 2> widen_high(vector<T, LEN> const& v) noexcept {
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0, "widen_high works on whole registers.");
+            return vector<detail::widened_t<T>, LEN / 2>(detail::widen_vals<T, LEN, true>(v()));
+        }
+
+        // n / d per lane; INT_MIN / -1 wraps to INT_MIN
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> operator/(EXPR const& n, divider<typename EXPR::value_type> const& d) noexcept {
+            using value_type = typename EXPR::value_type;
+            return detail::math_result_t<EXPR>(detail::divide_vals<value_type, EXPR::length>(n(), d));
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_INTEGER_FUNCTIONS_HPP
@@ -0,0 +1,39 @@
+#pragma once
+#ifndef SIMD_WRAP_KERNELS_HPP
+#define SIMD_WRAP_KERNELS_HPP
+#include <cstddef>
+#include "dispatch.hpp"
+#include "thread_pool.hpp"
+
+/*
+    Bulk kernels over plain arrays. These are compiled once per supported
+    instruction set and called through the table selected by active_isa(),
+    so they run at full width on whatever host they end up on. Pointers
+    don't need any particular alignment, and output may alias an input.
+*/
+
+namespace sw {
+
+    namespace kernels {
+
+        // out[i] = a[i] + b[i]
+        void add(const float* a, const float* b, float* out, size_t count) noexcept;
+        // out[i] = a[i] - b[i]
+        void sub(const float* a, const float* b, float* out, size_t count) noexcept;
+        // out[i] = a[i] * b[i]
+        void mul(const float* a, const float* b, float* out, size_t count) noexcept;
+        // out[i] = a[i] / b[i]
+        void div(const float* a, const float* b, float* out, size_t count) noexcept;
+        // out[i] = a[i] * b[i] + c[i], fused where the level has FMA
+        void mul_add(const float* a, const float* b, const float* c, float* out, size_t count) noexcept;
+        // c = alpha * a * b + beta * c, column major m x k a, k x n b and m x n c, see sw::gemm in matrix.hpp
+        void gemm(size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda, const float* b, size_t ldb, float beta, float* c, size_t ldc) noexcept;
+        // the same on the policy's pool, results don't depend on the number of threads
+        void gemm(execution::parallel_policy const& policy, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+            const float* b, size_t ldb, float beta, float* c, size_t ldc) noexcept;
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_KERNELS_HPP
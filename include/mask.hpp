@@ -0,0 +1,396 @@
+#pragma once
+#ifndef SIMD_WRAP_MASK_HPP
+#define SIMD_WRAP_MASK_HPP
+#include <cstdint>
+#include "vector.hpp"
+#include "detail/bitwise_operators.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // one bit per lane, lane 0 in bit 0, only the first LEN lanes
+            template<typename T, size_t LEN>
+            uint64_t mask_bits_vals(mask_type_t<T, LEN> mask) noexcept {
+                using mask_type = mask_type_t<T, LEN>;
+                constexpr uint64_t used = LEN >= 64 ? ~uint64_t(0) : (uint64_t(1) << LEN) - 1;
+                uint64_t bits;
+                if constexpr (std::is_integral_v<mask_type>) {
+                    bits = static_cast<uint64_t>(mask);
+                }
+                else if constexpr (USE_GENERIC_VECTORS) {
+                    // the sign of each lane, like movemask
+                    const auto lanes = (generic_mask_t<mask_type>)mask;
+                    bits = 0;
+                    for (size_t i = 0; i < simd_traits<T, LEN>::num_entries; ++i) {
+                        bits |= uint64_t(lanes[i] < 0) << i;
+                    }
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<mask_type, __m128>) {
+                    bits = uint64_t(_mm_movemask_ps(mask));
+                }
+                else if constexpr (std::is_same_v<mask_type, __m128d>) {
+                    bits = uint64_t(_mm_movemask_pd(mask));
+                }
+                else if constexpr (std::is_same_v<mask_type, __m256>) {
+                    bits = uint64_t(_mm256_movemask_ps(mask));
+                }
+                else if constexpr (std::is_same_v<mask_type, __m256d>) {
+                    bits = uint64_t(_mm256_movemask_pd(mask));
+                }
+                else if constexpr (std::is_same_v<mask_type, __m256i>) {
+                    if constexpr (sizeof(T) == 1) {
+                        bits = uint32_t(_mm256_movemask_epi8(mask));
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        // packs works within each 128 bit half, the permute gathers both halves into the low one
+                        const __m256i packed = _mm256_packs_epi16(mask, _mm256_setzero_si256());
+                        bits = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_permute4x64_epi64(packed, 0xD8))));
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        bits = uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+                    }
+                    else {
+                        bits = uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+                    }
+                }
+                else {
+                    if constexpr (sizeof(T) == 1) {
+                        bits = uint64_t(_mm_movemask_epi8(mask));
+                    }
+                    else if constexpr (sizeof(T) == 2) {
+                        bits = uint64_t(_mm_movemask_epi8(_mm_packs_epi16(mask, _mm_setzero_si128())));
+                    }
+                    else if constexpr (sizeof(T) == 4) {
+                        bits = uint64_t(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+                    }
+                    else {
+                        bits = uint64_t(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+                    }
+                }
+#endif
+                return bits & used;
+            }
+
+            template<typename T, size_t LEN>
+            mask_type_t<T, LEN> mask_and_vals(mask_type_t<T, LEN> a, mask_type_t<T, LEN> b) noexcept {
+                if constexpr (std::is_integral_v<mask_type_t<T, LEN>>) {
+                    return static_cast<mask_type_t<T, LEN>>(a & b);
+                }
+                else {
+                    return and_vals<T, LEN>(a, b);
+                }
+            }
+
+            template<typename T, size_t LEN>
+            mask_type_t<T, LEN> mask_or_vals(mask_type_t<T, LEN> a, mask_type_t<T, LEN> b) noexcept {
+                if constexpr (std::is_integral_v<mask_type_t<T, LEN>>) {
+                    return static_cast<mask_type_t<T, LEN>>(a | b);
+                }
+                else {
+                    return or_vals<T, LEN>(a, b);
+                }
+            }
+
+            template<typename T, size_t LEN>
+            mask_type_t<T, LEN> mask_xor_vals(mask_type_t<T, LEN> a, mask_type_t<T, LEN> b) noexcept {
+                if constexpr (std::is_integral_v<mask_type_t<T, LEN>>) {
+                    return static_cast<mask_type_t<T, LEN>>(a ^ b);
+                }
+                else {
+                    return xor_vals<T, LEN>(a, b);
+                }
+            }
+
+            /*
+                Shuffle controls for packing the selected lanes to the front. 128
+                bit registers use pshufb with one 16 byte control per 4 lane mask,
+                256 bit ones permutevar8x32 with the 8 lane indices packed into
+                the nibbles of a uint32_t. 64 bit lanes use the same tables with
+                every mask bit doubled.
+            */
+            struct compress_tables {
+                alignas(16) uint8_t bytes[16][16];
+                uint32_t nibbles[256];
+            };
+
+            constexpr compress_tables make_compress_tables() noexcept {
+                compress_tables tables{};
+                for (size_t m = 0; m < 16; ++m) {
+                    size_t out = 0;
+                    for (size_t lane = 0; lane < 4; ++lane) {
+                        if (m & (size_t(1) << lane)) {
+                            for (size_t b = 0; b < 4; ++b) {
+                                tables.bytes[m][out * 4 + b] = uint8_t(lane * 4 + b);
+                            }
+                            ++out;
+                        }
+                    }
+                    // pshufb zeroes the bytes whose control has the top bit set
+                    for (; out < 4; ++out) {
+                        for (size_t b = 0; b < 4; ++b) {
+                            tables.bytes[m][out * 4 + b] = 0x80;
+                        }
+                    }
+                }
+                for (size_t m = 0; m < 256; ++m) {
+                    uint32_t packed = 0;
+                    size_t out = 0;
+                    for (size_t lane = 0; lane < 8; ++lane) {
+                        if (m & (size_t(1) << lane)) {
+                            packed |= uint32_t(lane) << (4 * out++);
+                        }
+                    }
+                    tables.nibbles[m] = packed;
+                }
+                return tables;
+            }
+
+            inline constexpr compress_tables compress_lookup = make_compress_tables();
+
+            // every bit twice, for 64 bit lanes in 32 bit tables
+            constexpr uint32_t double_bits(uint32_t bits) noexcept {
+                uint32_t result = 0;
+                for (uint32_t i = 0; i < 4; ++i) {
+                    result |= ((bits >> i) & 1u) * (3u << (2 * i));
+                }
+                return result;
+            }
+
+            // set bits, popcnt from SSE4.1 up
+            inline size_t popcount_bits(uint64_t bits) noexcept {
+#if defined(SW_GENERIC_VECTORS)
+                return size_t(__builtin_popcountll(bits));
+#else
+                return size_t(_mm_popcnt_u64(bits));
+#endif
+            }
+
+            // the lanes with their bit set moved to the front, in order; what follows is unspecified
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> compress_vals(vector_type_t<T, LEN> val, uint64_t bits) noexcept {
+                static_assert(sizeof(T) >= 4, "Only 32 and 64 bit lanes can be compressed in registers.");
+                const auto ints = as_int_bits<T, LEN>(val);
+                using int_type = std::remove_const_t<decltype(ints)>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    int_type result{};
+                    size_t out = 0;
+                    for (size_t i = 0; i < simd_traits<T, LEN>::num_entries; ++i) {
+                        if ((bits >> i) & 1) {
+                            result[out++] = ints[i];
+                        }
+                    }
+                    return from_int_bits<T, LEN>(result);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<int_type, __m512i>) {
+                        return from_int_bits<T, LEN>(sizeof(T) == 4 ? _mm512_maskz_compress_epi32(__mmask16(bits), ints) : _mm512_maskz_compress_epi64(__mmask8(bits), ints));
+                    }
+                    else if constexpr (std::is_same_v<int_type, __m256i>) {
+                        return from_int_bits<T, LEN>(sizeof(T) == 4 ? _mm256_maskz_compress_epi32(__mmask8(bits), ints) : _mm256_maskz_compress_epi64(__mmask8(bits), ints));
+                    }
+                    else {
+                        return from_int_bits<T, LEN>(sizeof(T) == 4 ? _mm_maskz_compress_epi32(__mmask8(bits), ints) : _mm_maskz_compress_epi64(__mmask8(bits), ints));
+                    }
+                }
+                else if constexpr (std::is_same_v<int_type, __m256i>) {
+                    const uint32_t lanes = sizeof(T) == 4 ? uint32_t(bits) : double_bits(uint32_t(bits));
+                    const __m256i packed = _mm256_set1_epi32(int(compress_lookup.nibbles[lanes]));
+                    const __m256i indices = _mm256_and_si256(_mm256_srlv_epi32(packed, _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28)), _mm256_set1_epi32(7));
+                    return from_int_bits<T, LEN>(_mm256_permutevar8x32_epi32(ints, indices));
+                }
+                else {
+                    const uint32_t lanes = sizeof(T) == 4 ? uint32_t(bits) : double_bits(uint32_t(bits));
+                    const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i*>(compress_lookup.bytes[lanes]));
+                    return from_int_bits<T, LEN>(_mm_shuffle_epi8(ints, control));
+                }
+#endif
+            }
+
+            /*
+                Writes the lanes with their bit set to ptr, one after the other,
+                and returns how many. With WHOLE_REGISTER the full register is
+                stored instead, so ptr needs room for all of its lanes. 8 and 16
+                bit lanes go one by one, they'd need AVX-512 VBMI2.
+            */
+            template<typename T, size_t LEN, bool WHOLE_REGISTER = false>
+            size_t compress_store_vals(T* ptr, vector_type_t<T, LEN> val, uint64_t bits) noexcept {
+                const size_t count = popcount_bits(bits);
+                if constexpr (sizeof(T) >= 4) {
+                    const vector_type_t<T, LEN> packed = compress_vals<T, LEN>(val, bits);
+                    if constexpr (WHOLE_REGISTER) {
+                        store_vals<T, LEN>(ptr, packed);
+                    }
+                    else {
+                        masked_store_vals<T, LEN>(ptr, packed, count);
+                    }
+                }
+                else {
+                    alignas(64) T lanes[simd_traits<T, LEN>::num_entries];
+                    store_vals<T, LEN, true>(lanes, val);
+                    size_t out = 0;
+                    for (size_t i = 0; i < LEN; ++i) {
+                        if constexpr (WHOLE_REGISTER) {
+                            // branch free, the slot after the last kept lane may get written
+                            ptr[out] = lanes[i];
+                            out += size_t((bits >> i) & 1);
+                        }
+                        else if ((bits >> i) & 1) {
+                            ptr[out++] = lanes[i];
+                        }
+                    }
+                }
+                return count;
+            }
+
+        }
+
+        /*
+            Result of a comparison, one flag per lane. A k-register with AVX-512,
+            a register of all-ones/all-zeros lanes below. Lanes past LEN are
+            ignored by everything that looks at the flags.
+        */
+        template<typename T, size_t LEN>
+        struct mask {
+            using underlying_mask_type = typename simd_traits<T, LEN>::mask_type;
+            using value_type = T;
+            constexpr static size_t length = LEN;
+
+            // no lane set
+            constexpr mask() noexcept : data{} {}
+            explicit mask(bool value) noexcept : data(value ? detail::lane_mask<T, LEN>(LEN) : underlying_mask_type{}) {}
+            constexpr explicit mask(underlying_mask_type value) noexcept : data(value) {}
+
+            // the first count lanes set, the rest clear
+            static mask first(size_t count) noexcept {
+                return mask(detail::lane_mask<T, LEN>(count));
+            }
+
+            // lane i in bit i
+            uint64_t bits() const noexcept {
+                return detail::mask_bits_vals<T, LEN>(data);
+            }
+
+            bool operator[](size_t lane) const noexcept {
+                return (bits() >> lane) & 1;
+            }
+
+            underlying_mask_type operator()() const noexcept {
+                return data;
+            }
+
+        private:
+            underlying_mask_type data;
+        };
+
+        template<typename T, size_t LEN>
+        mask<T, LEN> operator&(mask<T, LEN> const& a, mask<T, LEN> const& b) noexcept {
+            return mask<T, LEN>(detail::mask_and_vals<T, LEN>(a(), b()));
+        }
+
+        template<typename T, size_t LEN>
+        mask<T, LEN> operator|(mask<T, LEN> const& a, mask<T, LEN> const& b) noexcept {
+            return mask<T, LEN>(detail::mask_or_vals<T, LEN>(a(), b()));
+        }
+
+        template<typename T, size_t LEN>
+        mask<T, LEN> operator^(mask<T, LEN> const& a, mask<T, LEN> const& b) noexcept {
+            return mask<T, LEN>(detail::mask_xor_vals<T, LEN>(a(), b()));
+        }
+
+        // only flips the first LEN lanes
+        template<typename T, size_t LEN>
+        mask<T, LEN> operator~(mask<T, LEN> const& a) noexcept {
+            return mask<T, LEN>(detail::mask_xor_vals<T, LEN>(a(), detail::lane_mask<T, LEN>(LEN)));
+        }
+
+        template<typename T, size_t LEN>
+        bool any(mask<T, LEN> const& m) noexcept {
+            return m.bits() != 0;
+        }
+
+        template<typename T, size_t LEN>
+        bool all(mask<T, LEN> const& m) noexcept {
+            return m.bits() == (LEN >= 64 ? ~uint64_t(0) : (uint64_t(1) << LEN) - 1);
+        }
+
+        template<typename T, size_t LEN>
+        bool none(mask<T, LEN> const& m) noexcept {
+            return m.bits() == 0;
+        }
+
+        template<typename T, size_t LEN>
+        size_t popcount(mask<T, LEN> const& m) noexcept {
+            return detail::popcount_bits(m.bits());
+        }
+
+        // per lane m ? a : b, either side may be an expression or a scalar
+        template<typename T, size_t LEN, typename OP0, typename OP1>
+        vector<T, LEN> select(mask<T, LEN> const& m, OP0 const& a, OP1 const& b) noexcept {
+            using vector_type = vector<T, LEN>;
+            return vector_type(detail::select_vals<T, LEN>(m(), detail::as_operand<vector_type>(a)(), detail::as_operand<vector_type>(b)()));
+        }
+
+        /*
+            Writes the lanes of v where m is set to out, packed together in lane
+            order, and returns how many were written. Nothing past them is touched.
+        */
+        template<typename T, size_t LEN>
+        size_t compress_store(T* out, mask<T, LEN> const& m, vector<T, LEN> const& v) noexcept {
+            return detail::compress_store_vals<T, LEN>(out, v(), m.bits());
+        }
+
+        namespace detail {
+
+            template<compare_op OP, typename OTHER, typename OP0, typename OP1>
+            mask<typename OTHER::value_type, OTHER::length> compare_operands(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+                using value_type = typename OTHER::value_type;
+                constexpr size_t length = OTHER::length;
+                return mask<value_type, length>(compare_vals<value_type, length, OP>(as_operand<OTHER>(operand_0)(), as_operand<OTHER>(operand_1)()));
+            }
+
+        }
+
+        /*
+            Comparisons evaluate right away and return a mask of the operands
+            type. Float compares are ordered (false for NaN) except !=.
+        */
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator==(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::eq, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator!=(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::neq, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator<(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::lt, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator<=(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::le, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator>(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::gt, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+        template<typename OP0, typename OP1, typename = std::enable_if_t<detail::is_binary_operand_pair_v<OP0, OP1>>>
+        auto operator>=(OP0 const& operand_0, OP1 const& operand_1) noexcept {
+            return detail::compare_operands<detail::compare_op::ge, detail::other_operand_t<OP0, OP1>>(operand_0, operand_1);
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_MASK_HPP
@@ -0,0 +1,590 @@
+#pragma once
+#ifndef SIMD_WRAP_MATRIX_HPP
+#define SIMD_WRAP_MATRIX_HPP
+#include <utility>
+#include "aligned_arena.hpp"
+#include "parallel.hpp"
+#include "vector_functions.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // lane LANE of every group of 4 lanes, across the whole register
+            template<int LANE, typename T, size_t LEN>
+            vector_type_t<T, LEN> splat_quad_lane_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                constexpr int pattern = LANE * 0x55;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    static_assert(sizeof(vector_type) == 4 * sizeof(T), "splat_quad_lane_vals needs registers of whole groups of 4 lanes.");
+                    return broadcast_val<T, LEN>(a[LANE]);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_shuffle_ps(a, a, pattern);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_permute_ps(a, pattern);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_permute_ps(a, pattern);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_permute4x64_pd(a, pattern);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "splat_quad_lane_vals needs registers of whole groups of 4 lanes.");
+                    return _mm512_permutex_pd(a, pattern);
+                }
+#endif
+            }
+
+            // a 4 lane register repeated across the register holding LEN lanes
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> repeat_quad_vals(vector_type_t<T, 4> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (std::is_same_v<vector_type, vector_type_t<T, 4>>) {
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_set_m128(a, a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_broadcast_f32x4(a);
+                }
+                else {
+                    static_assert(std::is_same_v<vector_type, __m512d>, "repeat_quad_vals needs registers of whole groups of 4 lanes.");
+                    return _mm512_broadcast_f64x4(a);
+                }
+#endif
+            }
+
+            // 3D cross product of the first three lanes, the fourth comes out as a3 * b3 - a3 * b3
+            template<typename T>
+            vector_type_t<T, 4> cross3_vals(vector_type_t<T, 4> a, vector_type_t<T, 4> b) noexcept {
+                using vector_type = vector_type_t<T, 4>;
+                const auto yzx = [](vector_type v) {
+                    if constexpr (USE_GENERIC_VECTORS) {
+                        return vector_type{ v[1], v[2], v[0], v[3] };
+                    }
+#if !defined(SW_GENERIC_VECTORS)
+                    else if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+                    }
+                    else {
+                        return _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 0, 2, 1));
+                    }
+#endif
+                };
+                // (a * b.yzx - a.yzx * b).yzx
+                return yzx(sub_vals<T, 4>(mul_vals<T, 4>(a, yzx(b)), mul_vals<T, 4>(yzx(a), b)));
+            }
+
+            template<typename T>
+            T dot3_vals(vector_type_t<T, 4> a, vector_type_t<T, 4> b) noexcept {
+                // the 3 lane vector shares the register and masks the fourth lane off
+                return reduce_register<T, add_reduction>(fill_padding<T, 3>(mul_vals<T, 4>(a, b), T(0)));
+            }
+
+            template<typename T>
+            void transpose4_vals(vector_type_t<T, 4>& c0, vector_type_t<T, 4>& c1, vector_type_t<T, 4>& c2, vector_type_t<T, 4>& c3) noexcept {
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using vector_type = vector_type_t<T, 4>;
+                    const vector_type r0 = c0, r1 = c1, r2 = c2, r3 = c3;
+                    c0 = vector_type{ r0[0], r1[0], r2[0], r3[0] };
+                    c1 = vector_type{ r0[1], r1[1], r2[1], r3[1] };
+                    c2 = vector_type{ r0[2], r1[2], r2[2], r3[2] };
+                    c3 = vector_type{ r0[3], r1[3], r2[3], r3[3] };
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type_t<T, 4>, __m128>) {
+                    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                }
+                else {
+                    const __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+                    const __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+                    const __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+                    const __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+                    c0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+                    c1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+                    c2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+                    c3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+                }
+#endif
+            }
+
+            // sum of columns[k] * v[k], lanes of v broadcast with shuffles
+            template<typename T, size_t R, size_t... K>
+            vector_type_t<T, R> combine_columns_vals(const vector<T, R>* columns, vector_type_t<T, R> v, std::index_sequence<K...>) noexcept {
+                vector_type_t<T, R> result = mul_vals<T, R>(columns[0](), splat_quad_lane_vals<0, T, R>(v));
+                ((result = mul_add_vals<T, R>(columns[K + 1](), splat_quad_lane_vals<int(K + 1), T, R>(v), result)), ...);
+                return result;
+            }
+
+        }
+
+        /*
+            R x C matrix of floating point values, stored as C column vectors
+            of R lanes that stay in registers for the operations below. Column
+            major like OpenGL: m * v transforms the column vector v, and
+            load()/store() take elements column after column.
+
+            mat4 and dmat4 (AVX2 and up, dmat4 needs 256 bit registers) get
+            shuffle based multiplication, transpose and inverses.
+        */
+        template<typename T, size_t R, size_t C>
+        struct matrix {
+            static_assert(std::is_floating_point_v<T>, "matrix is only implemented for floating point values.");
+            using value_type = T;
+            using column_type = vector<T, R>;
+            constexpr static size_t rows = R;
+            constexpr static size_t columns = C;
+
+            // all zero
+            matrix() noexcept = default;
+
+            // diagonal filled with value
+            explicit matrix(T value) noexcept {
+                for (size_t j = 0; j < C && j < R; ++j) {
+                    T lanes[R] = {};
+                    lanes[j] = value;
+                    cols[j] = column_type::load_partial(lanes);
+                }
+            }
+
+            static matrix identity() noexcept {
+                return matrix(T(1));
+            }
+
+            static matrix load(const T* column_major) noexcept {
+                matrix result;
+                for (size_t j = 0; j < C; ++j) {
+                    result.cols[j] = column_type::load_partial(column_major + j * R);
+                }
+                return result;
+            }
+
+            void store(T* column_major) const noexcept {
+                for (size_t j = 0; j < C; ++j) {
+                    cols[j].store_partial(column_major + j * R);
+                }
+            }
+
+            column_type& column(size_t j) noexcept {
+                return cols[j];
+            }
+
+            column_type const& column(size_t j) const noexcept {
+                return cols[j];
+            }
+
+            // single elements go through memory, prefer whole columns in loops
+            T operator()(size_t row, size_t col) const noexcept {
+                T lanes[R];
+                cols[col].store_partial(lanes);
+                return lanes[row];
+            }
+
+        private:
+            column_type cols[C];
+        };
+
+        template<typename T>
+        using mat4 = matrix<T, 4, 4>;
+
+        template<typename T, size_t R, size_t C>
+        vector<T, R> operator*(matrix<T, R, C> const& m, vector<T, C> const& v) noexcept {
+            if constexpr (R == 4 && C == 4) {
+                return vector<T, R>(detail::combine_columns_vals<T, R>(&m.column(0), v(), std::make_index_sequence<C - 1>{}));
+            }
+            else {
+                T lanes[C];
+                v.store_partial(lanes);
+                vector<T, R> result = m.column(0) * lanes[0];
+                for (size_t k = 1; k < C; ++k) {
+                    result = m.column(k) * lanes[k] + result;
+                }
+                return result;
+            }
+        }
+
+        // column j of a * b is a * (column j of b)
+        template<typename T, size_t R, size_t K, size_t C>
+        matrix<T, R, C> operator*(matrix<T, R, K> const& a, matrix<T, K, C> const& b) noexcept {
+            matrix<T, R, C> result;
+            for (size_t j = 0; j < C; ++j) {
+                result.column(j) = a * b.column(j);
+            }
+            return result;
+        }
+
+        template<typename T, size_t R, size_t C>
+        matrix<T, C, R> transpose(matrix<T, R, C> const& m) noexcept {
+            matrix<T, C, R> result;
+            if constexpr (R == 4 && C == 4) {
+                auto c0 = m.column(0)(), c1 = m.column(1)(), c2 = m.column(2)(), c3 = m.column(3)();
+                detail::transpose4_vals<T>(c0, c1, c2, c3);
+                result.column(0) = vector<T, 4>(c0);
+                result.column(1) = vector<T, 4>(c1);
+                result.column(2) = vector<T, 4>(c2);
+                result.column(3) = vector<T, 4>(c3);
+            }
+            else {
+                T elements[R * C], transposed[R * C];
+                m.store(elements);
+                for (size_t j = 0; j < C; ++j) {
+                    for (size_t i = 0; i < R; ++i) {
+                        transposed[i * C + j] = elements[j * R + i];
+                    }
+                }
+                result = matrix<T, C, R>::load(transposed);
+            }
+            return result;
+        }
+
+        /*
+            Inverse of an affine transform (last row 0 0 0 1): the 3x3 part is
+            inverted through cross products of its columns, the translation
+            follows as -inverse * t. Handles scale and shear, not projections.
+        */
+        template<typename T>
+        mat4<T> inverse_affine(mat4<T> const& m) noexcept {
+            using detail::cross3_vals;
+            const auto a = m.column(0)(), b = m.column(1)(), c = m.column(2)(), t = m.column(3)();
+            const auto scale = detail::broadcast_val<T, 4>(T(1) / detail::dot3_vals<T>(a, cross3_vals<T>(b, c)));
+            auto r0 = detail::mul_vals<T, 4>(cross3_vals<T>(b, c), scale);
+            auto r1 = detail::mul_vals<T, 4>(cross3_vals<T>(c, a), scale);
+            auto r2 = detail::mul_vals<T, 4>(cross3_vals<T>(a, b), scale);
+            auto r3 = mat4<T>::identity().column(3)();
+            // rows of the inverse 3x3 into columns, the last column becomes 0 0 0 1
+            detail::transpose4_vals<T>(r0, r1, r2, r3);
+            mat4<T> result;
+            result.column(0) = vector<T, 4>(r0);
+            result.column(1) = vector<T, 4>(r1);
+            result.column(2) = vector<T, 4>(r2);
+            const auto moved = detail::combine_columns_vals<T, 4>(&result.column(0), t, std::make_index_sequence<2>{});
+            result.column(3) = vector<T, 4>(detail::sub_vals<T, 4>(r3, moved));
+            return result;
+        }
+
+        namespace detail {
+
+            /*
+                General 4x4 inverse after Lengyel (Foundations of Game Engine
+                Development, vol. 1): with the columns a, b, c, d cut to their
+                first three rows and x, y, z, w the last row, everything comes
+                down to four cross products and their dot products.
+            */
+            template<typename T>
+            struct inverse_terms {
+                vector_type_t<T, 4> s, t, u, v;
+                T det;
+            };
+
+            template<typename T>
+            inverse_terms<T> inverse_terms_of(mat4<T> const& m) noexcept {
+                const auto a = m.column(0)(), b = m.column(1)(), c = m.column(2)(), d = m.column(3)();
+                inverse_terms<T> terms;
+                terms.s = cross3_vals<T>(a, b);
+                terms.t = cross3_vals<T>(c, d);
+                // a * y - b * x and c * w - d * z, the last row splatted from the fourth lanes
+                terms.u = sub_vals<T, 4>(mul_vals<T, 4>(a, splat_quad_lane_vals<3, T, 4>(b)), mul_vals<T, 4>(b, splat_quad_lane_vals<3, T, 4>(a)));
+                terms.v = sub_vals<T, 4>(mul_vals<T, 4>(c, splat_quad_lane_vals<3, T, 4>(d)), mul_vals<T, 4>(d, splat_quad_lane_vals<3, T, 4>(c)));
+                terms.det = dot3_vals<T>(terms.s, terms.v) + dot3_vals<T>(terms.t, terms.u);
+                return terms;
+            }
+
+        }
+
+        template<typename T>
+        T determinant(mat4<T> const& m) noexcept {
+            return detail::inverse_terms_of<T>(m).det;
+        }
+
+        // no singularity check: a zero determinant gives inf and NaN elements
+        template<typename T>
+        mat4<T> inverse(mat4<T> const& m) noexcept {
+            using namespace detail;
+            const auto a = m.column(0)(), b = m.column(1)(), c = m.column(2)(), d = m.column(3)();
+            const inverse_terms<T> terms = inverse_terms_of<T>(m);
+            const auto scale = broadcast_val<T, 4>(T(1) / terms.det);
+            const auto s = mul_vals<T, 4>(terms.s, scale);
+            const auto t = mul_vals<T, 4>(terms.t, scale);
+            const auto u = mul_vals<T, 4>(terms.u, scale);
+            const auto v = mul_vals<T, 4>(terms.v, scale);
+            const auto x = splat_quad_lane_vals<3, T, 4>(a);
+            const auto y = splat_quad_lane_vals<3, T, 4>(b);
+            const auto z = splat_quad_lane_vals<3, T, 4>(c);
+            const auto w = splat_quad_lane_vals<3, T, 4>(d);
+            // rows of the inverse, their fourth lanes replaced by the dot products
+            const auto first_three = lane_mask<T, 4>(3);
+            auto r0 = select_vals<T, 4>(first_three, mul_add_vals<T, 4>(t, y, cross3_vals<T>(b, v)), broadcast_val<T, 4>(-dot3_vals<T>(b, t)));
+            auto r1 = select_vals<T, 4>(first_three, neg_mul_add_vals<T, 4>(t, x, cross3_vals<T>(v, a)), broadcast_val<T, 4>(dot3_vals<T>(a, t)));
+            auto r2 = select_vals<T, 4>(first_three, mul_add_vals<T, 4>(s, w, cross3_vals<T>(d, u)), broadcast_val<T, 4>(-dot3_vals<T>(d, s)));
+            auto r3 = select_vals<T, 4>(first_three, neg_mul_add_vals<T, 4>(s, z, cross3_vals<T>(u, c)), broadcast_val<T, 4>(dot3_vals<T>(c, s)));
+            transpose4_vals<T>(r0, r1, r2, r3);
+            mat4<T> result;
+            result.column(0) = vector<T, 4>(r0);
+            result.column(1) = vector<T, 4>(r1);
+            result.column(2) = vector<T, 4>(r2);
+            result.column(3) = vector<T, 4>(r3);
+            return result;
+        }
+
+        namespace detail {
+
+            /*
+                m * p for packed xyzw points, as many per register as fit: the
+                columns are repeated across the register and every point splats
+                its own lanes, so 2 (AVX) or 4 (AVX-512) float points go through
+                four multiply-adds together.
+            */
+            template<typename T>
+            struct transform_points_op {
+                vector<T, native_length<T>> columns[4];
+
+                explicit transform_points_op(mat4<T> const& m) noexcept {
+                    for (size_t j = 0; j < 4; ++j) {
+                        columns[j] = vector<T, native_length<T>>(repeat_quad_vals<T, native_length<T>>(m.column(j)()));
+                    }
+                }
+
+                vector<T, native_length<T>> operator()(vector<T, native_length<T>> const& points) const noexcept {
+                    return vector<T, native_length<T>>(combine_columns_vals<T, native_length<T>>(columns, points(), std::make_index_sequence<3>{}));
+                }
+            };
+
+            template<typename T>
+            const T* points_data(span<const vector<T, 4>> points) noexcept {
+                return reinterpret_cast<const T*>(points.data());
+            }
+
+        }
+
+        // out[i] = m * in[i], in and out may be the same span
+        template<typename T>
+        void transform_points(mat4<T> const& m, span<const vector<T, 4>> in, span<vector<T, 4>> out) noexcept {
+            assert(in.size() >= out.size());
+            static_assert(native_length<T> % 4 == 0, "transform_points needs registers of whole points.");
+            transform(span<const T>(detail::points_data<T>(in), out.size() * 4), span<T>(reinterpret_cast<T*>(out.data()), out.size() * 4),
+                detail::transform_points_op<T>(m));
+        }
+
+        template<typename T>
+        void transform_points(mat4<T> const& m, span<vector<T, 4>> points) noexcept {
+            transform_points(m, span<const vector<T, 4>>(points.data(), points.size()), points);
+        }
+
+        // splits the points over the policy's pool, see parallel.hpp
+        template<typename T>
+        void transform_points(execution::parallel_policy const& policy, mat4<T> const& m, span<const vector<T, 4>> in, span<vector<T, 4>> out) {
+            assert(in.size() >= out.size());
+            static_assert(native_length<T> % 4 == 0, "transform_points needs registers of whole points.");
+            transform(policy, span<const T>(detail::points_data<T>(in), out.size() * 4), span<T>(reinterpret_cast<T*>(out.data()), out.size() * 4),
+                detail::transform_points_op<T>(m));
+        }
+
+
+        namespace detail {
+
+            /*
+                Blocking of the GEMM below, after Goto and van de Geijn: an
+                mr x nr block of C lives in 2 * nr accumulator registers while
+                the micro kernel streams packed slivers of A (mr rows) and B
+                (nr columns) through them. kc x nr slivers of B stay in L1, an
+                mc x kc block of A in L2 and the kc x nc panel of B in L3.
+            */
+            template<typename T>
+            struct gemm_blocking {
+                constexpr static size_t lanes = native_length<T>;
+                constexpr static size_t mr = 2 * lanes;
+                // 2 * nr accumulators, two registers of A and a broadcast of B: 15 of 16, 27 of 32 registers
+                constexpr static size_t nr = USE_AVX512_INTRINSICS ? 12 : 6;
+                constexpr static size_t kc = 256;
+                constexpr static size_t mc = 128 * 1024 / (kc * sizeof(T)) / mr * mr;
+                constexpr static size_t nc = 2048 / nr * nr;
+                // columns per task of the parallel version
+                constexpr static size_t parallel_columns = 8 * nr;
+            };
+
+            // rows [0, rows) of A as mr row slivers, kc deep, zero padded to whole slivers
+            template<typename T>
+            void gemm_pack_a(const T* a, size_t lda, size_t rows, size_t depth, T* packed) noexcept {
+                using blocking = gemm_blocking<T>;
+                using column_type = vector<T, blocking::lanes>;
+                for (size_t i = 0; i < rows; i += blocking::mr) {
+                    const size_t height = rows - i < blocking::mr ? rows - i : blocking::mr;
+                    const size_t upper = height < blocking::lanes ? height : blocking::lanes;
+                    for (size_t p = 0; p < depth; ++p, packed += blocking::mr) {
+                        const T* src = a + i + p * lda;
+                        column_type::load_partial(src, upper).store(packed);
+                        column_type::load_partial(src + upper, height - upper).store(packed + blocking::lanes);
+                    }
+                }
+            }
+
+            // columns [0, columns) of B as nr column slivers, each row of a sliver contiguous
+            template<typename T>
+            void gemm_pack_b(const T* b, size_t ldb, size_t depth, size_t columns, T* packed) noexcept {
+                using blocking = gemm_blocking<T>;
+                for (size_t j = 0; j < columns; j += blocking::nr) {
+                    const size_t width = columns - j < blocking::nr ? columns - j : blocking::nr;
+                    for (size_t p = 0; p < depth; ++p, packed += blocking::nr) {
+                        for (size_t c = 0; c < blocking::nr; ++c) {
+                            packed[c] = c < width ? b[p + (j + c) * ldb] : T(0);
+                        }
+                    }
+                }
+            }
+
+            // C[0:rows, 0:columns] += alpha * (packed A sliver) * (packed B sliver)
+            template<typename T, size_t... J>
+            void gemm_micro_kernel(size_t depth, const T* a, const T* b, T alpha, T* c, size_t ldc, size_t rows, size_t columns, std::index_sequence<J...>) noexcept {
+                using blocking = gemm_blocking<T>;
+                constexpr size_t L = blocking::lanes;
+                using register_type = vector_type_t<T, L>;
+                register_type low[sizeof...(J)] = {};
+                register_type high[sizeof...(J)] = {};
+                for (size_t p = 0; p < depth; ++p, a += blocking::mr, b += blocking::nr) {
+                    const register_type a0 = vector<T, L>::load(a)();
+                    const register_type a1 = vector<T, L>::load(a + L)();
+                    ([&] {
+                        const register_type bj = broadcast_val<T, L>(b[J]);
+                        low[J] = mul_add_vals<T, L>(a0, bj, low[J]);
+                        high[J] = mul_add_vals<T, L>(a1, bj, high[J]);
+                    }(), ...);
+                }
+                const register_type scale = broadcast_val<T, L>(alpha);
+                if (rows == blocking::mr && columns == blocking::nr) {
+                    ([&] {
+                        T* column = c + J * ldc;
+                        vector<T, L>(mul_add_vals<T, L>(low[J], scale, vector<T, L>::load_unaligned(column)())).store_unaligned(column);
+                        vector<T, L>(mul_add_vals<T, L>(high[J], scale, vector<T, L>::load_unaligned(column + L)())).store_unaligned(column + L);
+                    }(), ...);
+                }
+                else {
+                    const size_t upper = rows < L ? rows : L;
+                    ([&] {
+                        if (J < columns) {
+                            T* column = c + J * ldc;
+                            vector<T, L>(mul_add_vals<T, L>(low[J], scale, vector<T, L>::load_partial(column, upper)())).store_partial(column, upper);
+                            vector<T, L>(mul_add_vals<T, L>(high[J], scale, vector<T, L>::load_partial(column + L, rows - upper)())).store_partial(column + L, rows - upper);
+                        }
+                    }(), ...);
+                }
+            }
+
+            // one mc x (columns) block of C from packed A and B
+            template<typename T>
+            void gemm_macro_kernel(size_t rows, size_t columns, size_t depth, const T* packed_a, const T* packed_b, T alpha, T* c, size_t ldc) noexcept {
+                using blocking = gemm_blocking<T>;
+                for (size_t j = 0; j < columns; j += blocking::nr) {
+                    const T* b_sliver = packed_b + j * depth;
+                    for (size_t i = 0; i < rows; i += blocking::mr) {
+                        gemm_micro_kernel<T>(depth, packed_a + i * depth, b_sliver, alpha, c + i + j * ldc, ldc,
+                            rows - i < blocking::mr ? rows - i : blocking::mr, columns - j < blocking::nr ? columns - j : blocking::nr,
+                            std::make_index_sequence<blocking::nr>{});
+                    }
+                }
+            }
+
+            template<typename T>
+            void gemm_scale(size_t m, size_t n, T beta, T* c, size_t ldc) noexcept {
+                for (size_t j = 0; j < n; ++j) {
+                    const span<T> column(c + j * ldc, m);
+                    if (beta == T(0)) {
+                        // no 0 * NaN from whatever C held before
+                        transform(column, column, [](auto const&) { return vector<T, native_length<T>>(T(0)); });
+                    }
+                    else if (beta != T(1)) {
+                        transform(column, column, [beta](auto const& x) { return x * beta; });
+                    }
+                }
+            }
+
+            /*
+                Shared by the sequential and the parallel gemm, for_each(count, task)
+                runs task(i) for every i < count in any order. The whole kc deep
+                panel of A is packed up front, so every block of C can be handed
+                out on its own. Blocks always cover the same rows and nr column
+                slivers, results don't depend on the grouping of columns.
+            */
+            template<typename T, typename ForEach>
+            void gemm_driver(ForEach&& for_each, size_t group_columns, size_t m, size_t n, size_t k, T alpha, const T* a, size_t lda,
+                const T* b, size_t ldb, T beta, T* c, size_t ldc) {
+                using blocking = gemm_blocking<T>;
+                if (m == 0 || n == 0) {
+                    return;
+                }
+                const size_t row_blocks = (m + blocking::mc - 1) / blocking::mc;
+                for_each(n, [&](size_t j) { gemm_scale<T>(m, 1, beta, c + j * ldc, ldc); });
+                if (k == 0 || alpha == T(0)) {
+                    return;
+                }
+                const size_t padded_m = (m + blocking::mr - 1) / blocking::mr * blocking::mr;
+                aligned_arena scratch((padded_m * blocking::kc + blocking::nc * blocking::kc) * sizeof(T) + 1024);
+                T* packed_a = scratch.allocate_array<T>(padded_m * blocking::kc);
+                T* packed_b = scratch.allocate_array<T>(blocking::nc * blocking::kc);
+                for (size_t jc = 0; jc < n; jc += blocking::nc) {
+                    const size_t width = n - jc < blocking::nc ? n - jc : blocking::nc;
+                    const size_t groups = (width + group_columns - 1) / group_columns;
+                    for (size_t pc = 0; pc < k; pc += blocking::kc) {
+                        const size_t depth = k - pc < blocking::kc ? k - pc : blocking::kc;
+                        for_each((width + blocking::nr - 1) / blocking::nr, [&](size_t sliver) {
+                            const size_t j = sliver * blocking::nr;
+                            gemm_pack_b<T>(b + pc + (jc + j) * ldb, ldb, depth, width - j < blocking::nr ? width - j : blocking::nr, packed_b + j * depth);
+                        });
+                        for_each(row_blocks, [&](size_t block) {
+                            const size_t i = block * blocking::mc;
+                            gemm_pack_a<T>(a + i + pc * lda, lda, m - i < blocking::mc ? m - i : blocking::mc, depth, packed_a + i * depth);
+                        });
+                        for_each(row_blocks * groups, [&](size_t task) {
+                            const size_t i = task % row_blocks * blocking::mc;
+                            const size_t j = task / row_blocks * group_columns;
+                            gemm_macro_kernel<T>(m - i < blocking::mc ? m - i : blocking::mc, width - j < group_columns ? width - j : group_columns,
+                                depth, packed_a + i * depth, packed_b + j * depth, alpha, c + i + (jc + j) * ldc, ldc);
+                        });
+                    }
+                }
+            }
+
+        }
+
+        /*
+            C = alpha * A * B + beta * C for column major m x k A, k x n B and
+            m x n C, like BLAS' gemm without the transpose options. lda, ldb and
+            ldc are the distances between columns, at least the number of rows.
+            With beta == 0, C is only written and may hold anything beforehand.
+            Needs scratch memory of about (m + 2048) * 256 elements.
+        */
+        template<typename T>
+        void gemm(size_t m, size_t n, size_t k, T alpha, const T* a, size_t lda, const T* b, size_t ldb, T beta, T* c, size_t ldc) {
+            static_assert(std::is_floating_point_v<T>, "gemm is only implemented for floating point values.");
+            assert(lda >= m && ldb >= k && ldc >= m);
+            detail::gemm_driver<T>([](size_t count, auto&& task) {
+                for (size_t i = 0; i < count; ++i) {
+                    task(i);
+                }
+            }, detail::gemm_blocking<T>::nc, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
+
+        // packing and blocks of C run on the policy's pool, chunk_bytes isn't used, the result is the same as gemm()'s
+        template<typename T>
+        void gemm(execution::parallel_policy const& policy, size_t m, size_t n, size_t k, T alpha, const T* a, size_t lda,
+            const T* b, size_t ldb, T beta, T* c, size_t ldc) {
+            static_assert(std::is_floating_point_v<T>, "gemm is only implemented for floating point values.");
+            assert(lda >= m && ldb >= k && ldc >= m);
+            thread_pool& pool = policy.get_pool();
+            detail::gemm_driver<T>([&pool](size_t count, auto&& task) {
+                pool.parallel_for(count, task);
+            }, detail::gemm_blocking<T>::parallel_columns, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_MATRIX_HPP
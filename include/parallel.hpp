@@ -0,0 +1,142 @@
+#pragma once
+#ifndef SIMD_WRAP_PARALLEL_HPP
+#define SIMD_WRAP_PARALLEL_HPP
+#include <vector>
+#include "thread_pool.hpp"
+#include "transform.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // elements per chunk: about chunk_bytes per stream, in whole multiples of step
+            template<typename T>
+            size_t chunk_length(execution::parallel_policy const& policy, size_t step) noexcept {
+                const size_t requested = policy.chunk_bytes / sizeof(T);
+                return requested < step ? step : requested / step * step;
+            }
+
+            /*
+                The first chunk also covers the head up to the outputs alignment,
+                so every later chunk starts on an aligned output element and runs
+                the aligned path without peeling.
+            */
+            template<typename T, size_t LEN, typename Op, typename Out, typename... Inputs>
+            void parallel_transform(execution::parallel_policy const& policy, Op const& op, Out* out, size_t count, const Inputs*... inputs) {
+                const size_t chunk = chunk_length<T>(policy, LEN);
+                size_t head = 0;
+                if constexpr (std::is_same_v<Out, T>) {
+                    head = peel_count<T, LEN>(out, count);
+                }
+                const size_t chunks = count <= head ? 1 : (count - head + chunk - 1) / chunk;
+                if (chunks == 1) {
+                    Op local = op;
+                    transform_spans<T, LEN>(local, out, count, inputs...);
+                    return;
+                }
+                policy.get_pool().parallel_for(chunks, [&](size_t index) {
+                    const size_t begin = index == 0 ? 0 : head + index * chunk;
+                    const size_t end = head + (index + 1) * chunk < count ? head + (index + 1) * chunk : count;
+                    Op local = op;
+                    transform_spans<T, LEN>(local, out + begin, end - begin, (inputs + begin)...);
+                });
+            }
+
+            // fixed shape pairwise tree, the same for every thread count
+            template<typename T>
+            T pairwise_sum(const T* values, size_t count) noexcept {
+                if (count == 1) {
+                    return values[0];
+                }
+                const size_t half = count / 2;
+                return pairwise_sum(values, half) + pairwise_sum(values + half, count - half);
+            }
+
+            /*
+                Chunk boundaries only depend on count and chunk_bytes, the partial
+                sums go into a slot per chunk and are combined in a fixed order
+                afterwards: the result is bitwise the same whatever number of
+                threads ran the chunks, or in which order they finished.
+            */
+            template<typename T, size_t LEN, typename Op, typename... Inputs>
+            T parallel_transform_reduce(execution::parallel_policy const& policy, Op const& op, size_t count, const Inputs*... inputs) {
+                constexpr auto unrolled = std::make_index_sequence<bulk_unroll>{};
+                const size_t chunk = chunk_length<T>(policy, LEN * bulk_unroll);
+                const size_t chunks = (count + chunk - 1) / chunk;
+                if (chunks <= 1) {
+                    Op local = op;
+                    return transform_reduce_spans<T, LEN>(local, unrolled, count, inputs...);
+                }
+                std::vector<T> partials(chunks);
+                policy.get_pool().parallel_for(chunks, [&](size_t index) {
+                    const size_t begin = index * chunk;
+                    const size_t length = count - begin < chunk ? count - begin : chunk;
+                    Op local = op;
+                    partials[index] = transform_reduce_spans<T, LEN>(local, unrolled, length, (inputs + begin)...);
+                });
+                return pairwise_sum(partials.data(), chunks);
+            }
+
+        }
+
+        /*
+            Parallel versions of transform and transform_reduce, see transform.hpp
+            for op. op is copied for every chunk and may run on several threads at
+            once, it shouldn't carry mutable state.
+        */
+        template<size_t LEN = 0, typename I0, typename T, typename Op>
+        void transform(execution::parallel_policy const& policy, span<I0> in0, span<T> out, Op op) {
+            assert(in0.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::parallel_transform<C, detail::bulk_length<C, LEN>>(policy, op, out.data(), out.size(), static_cast<const I0*>(in0.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename T, typename Op>
+        void transform(execution::parallel_policy const& policy, span<I0> in0, span<I1> in1, span<T> out, Op op) {
+            assert(in0.size() >= out.size() && in1.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::parallel_transform<C, detail::bulk_length<C, LEN>>(policy, op, out.data(), out.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename I2, typename T, typename Op>
+        void transform(execution::parallel_policy const& policy, span<I0> in0, span<I1> in1, span<I2> in2, span<T> out, Op op) {
+            assert(in0.size() >= out.size() && in1.size() >= out.size() && in2.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::parallel_transform<C, detail::bulk_length<C, LEN>>(policy, op, out.data(), out.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()), static_cast<const I2*>(in2.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename Op>
+        detail::compute_type_t<I0> transform_reduce(execution::parallel_policy const& policy, span<I0> in0, Op op) {
+            using T = detail::compute_type_t<I0>;
+            return detail::parallel_transform_reduce<T, detail::bulk_length<T, LEN>>(policy, op, in0.size(), static_cast<const I0*>(in0.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename Op>
+        detail::compute_type_t<I0> transform_reduce(execution::parallel_policy const& policy, span<I0> in0, span<I1> in1, Op op) {
+            using T = detail::compute_type_t<I0>;
+            static_assert(std::is_same_v<T, detail::compute_type_t<I1>>, "Inputs of a transform_reduce have to share their element type.");
+            assert(in1.size() >= in0.size());
+            return detail::parallel_transform_reduce<T, detail::bulk_length<T, LEN>>(policy, op, in0.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()));
+        }
+
+        // sequenced policy: same as the plain overloads
+        template<size_t LEN = 0, typename... Args>
+        void transform(execution::sequenced_policy, Args&&... args) {
+            transform<LEN>(std::forward<Args>(args)...);
+        }
+
+        template<size_t LEN = 0, typename... Args>
+        auto transform_reduce(execution::sequenced_policy, Args&&... args) {
+            return transform_reduce<LEN>(std::forward<Args>(args)...);
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_PARALLEL_HPP
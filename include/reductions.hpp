@@ -0,0 +1,258 @@
+#pragma once
+#ifndef SIMD_WRAP_REDUCTIONS_HPP
+#define SIMD_WRAP_REDUCTIONS_HPP
+#include <utility>
+#include "transform.hpp"
+
+namespace sw {
+
+    /*
+        How reduce_add and dot over spans add up: plain keeps bulk_unroll
+        independent accumulators per lane, which is fast but loses about
+        log2(count) bits on long float arrays. compensated carries the
+        rounding error of every add (and, for dot, every product) along in a
+        second register and folds it back in at the end, giving about the
+        accuracy of summing in twice the precision. Either is only correct
+        without -ffast-math, which would optimize the compensation away.
+    */
+    enum class summation {
+        plain,
+        compensated
+    };
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            /*
+                One accumulator per unrolled register, combined pairwise at the
+                end and then folded with the shuffles of reduce_register. The
+                tail is loaded masked and its missing lanes set to the identity.
+            */
+            template<typename T, size_t LEN, typename Reduction, size_t... UNROLLED>
+            T reduce_span(const T* data, size_t count, std::index_sequence<UNROLLED...>) noexcept {
+                using register_type = vector_type_t<T, LEN>;
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                const register_type identity = broadcast_val<T, LEN>(Reduction::template identity<T>());
+                register_type acc[sizeof...(UNROLLED)];
+                for (register_type& sum : acc) {
+                    sum = identity;
+                }
+                size_t i = 0;
+                for (; i + stride <= count; i += stride) {
+                    ((acc[UNROLLED] = Reduction::template combine<T, LEN>(acc[UNROLLED], vector<T, LEN>::load_unaligned(data + i + UNROLLED * LEN)())), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    acc[0] = Reduction::template combine<T, LEN>(acc[0], vector<T, LEN>::load_unaligned(data + i)());
+                }
+                if (i < count) {
+                    const register_type tail = select_vals<T, LEN>(lane_mask<T, LEN>(count - i), vector<T, LEN>::load_partial(data + i, count - i)(), identity);
+                    acc[0] = Reduction::template combine<T, LEN>(acc[0], tail);
+                }
+                for (size_t width = sizeof...(UNROLLED) / 2; width != 0; width /= 2) {
+                    for (size_t j = 0; j < width; ++j) {
+                        acc[j] = Reduction::template combine<T, LEN>(acc[j], acc[j + width]);
+                    }
+                }
+                return reduce_register<T, Reduction>(acc[0]);
+            }
+
+            // s + e == a + b exactly (Knuth's TwoSum, no branch on the magnitudes)
+            template<typename T, size_t LEN>
+            void two_sum_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN>& s, vector_type_t<T, LEN>& e) noexcept {
+                s = add_vals<T, LEN>(a, b);
+                const vector_type_t<T, LEN> z = sub_vals<T, LEN>(s, a);
+                e = add_vals<T, LEN>(sub_vals<T, LEN>(a, sub_vals<T, LEN>(s, z)), sub_vals<T, LEN>(b, z));
+            }
+
+            // p + e == a * b exactly, with fma or else Dekker's splitting
+            template<typename T, size_t LEN>
+            void two_product_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b, vector_type_t<T, LEN>& p, vector_type_t<T, LEN>& e) noexcept {
+                p = mul_vals<T, LEN>(a, b);
+                if constexpr (USE_FMA_INTRINSICS) {
+                    e = fmsub_vals<T, LEN>(a, b, p);
+                }
+                else {
+                    const auto factor = broadcast_val<T, LEN>(std::is_same_v<T, float> ? T(4097) : T(134217729));
+                    const auto split = [&factor](vector_type_t<T, LEN> x, vector_type_t<T, LEN>& high, vector_type_t<T, LEN>& low) {
+                        const vector_type_t<T, LEN> c = mul_vals<T, LEN>(factor, x);
+                        high = sub_vals<T, LEN>(c, sub_vals<T, LEN>(c, x));
+                        low = sub_vals<T, LEN>(x, high);
+                    };
+                    vector_type_t<T, LEN> ah, al, bh, bl;
+                    split(a, ah, al);
+                    split(b, bh, bl);
+                    e = sub_vals<T, LEN>(mul_vals<T, LEN>(ah, bh), p);
+                    e = add_vals<T, LEN>(e, mul_vals<T, LEN>(ah, bl));
+                    e = add_vals<T, LEN>(e, mul_vals<T, LEN>(al, bh));
+                    e = add_vals<T, LEN>(e, mul_vals<T, LEN>(al, bl));
+                }
+            }
+
+            // sum and error registers of the compensated loops
+            template<typename T, size_t LEN>
+            struct compensated_sum {
+                vector_type_t<T, LEN> sum = broadcast_val<T, LEN>(T(0));
+                vector_type_t<T, LEN> error = broadcast_val<T, LEN>(T(0));
+
+                void add(vector_type_t<T, LEN> x) noexcept {
+                    vector_type_t<T, LEN> e;
+                    two_sum_vals<T, LEN>(sum, x, sum, e);
+                    error = add_vals<T, LEN>(error, e);
+                }
+            };
+
+            // the lanes of all accumulators added with TwoSum once more, their errors on top
+            template<typename T, size_t LEN, size_t N>
+            T finish_compensated(compensated_sum<T, LEN> const (&acc)[N]) noexcept {
+                constexpr size_t lanes = simd_traits<T, LEN>::num_entries;
+                T sums[lanes], errors[lanes];
+                T total = T(0), error = T(0);
+                for (size_t j = 0; j < N; ++j) {
+                    vector<T, LEN>(acc[j].sum).store_partial(sums, lanes);
+                    vector<T, LEN>(acc[j].error).store_partial(errors, lanes);
+                    for (size_t l = 0; l < lanes; ++l) {
+                        const T s = total + sums[l];
+                        const T z = s - total;
+                        error += (total - (s - z)) + (sums[l] - z) + errors[l];
+                        total = s;
+                    }
+                }
+                return total + error;
+            }
+
+            template<typename T, size_t LEN, size_t... UNROLLED>
+            T compensated_sum_span(const T* data, size_t count, std::index_sequence<UNROLLED...>) noexcept {
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                compensated_sum<T, LEN> acc[sizeof...(UNROLLED)];
+                size_t i = 0;
+                for (; i + stride <= count; i += stride) {
+                    (acc[UNROLLED].add(vector<T, LEN>::load_unaligned(data + i + UNROLLED * LEN)()), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    acc[0].add(vector<T, LEN>::load_unaligned(data + i)());
+                }
+                if (i < count) {
+                    acc[0].add(vector<T, LEN>::load_partial(data + i, count - i)());
+                }
+                return finish_compensated(acc);
+            }
+
+            // fused multiply-adds into independent accumulators
+            template<typename T, size_t LEN, size_t... UNROLLED>
+            T dot_span(const T* a, const T* b, size_t count, std::index_sequence<UNROLLED...>) noexcept {
+                using register_type = vector_type_t<T, LEN>;
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                register_type acc[sizeof...(UNROLLED)];
+                for (register_type& sum : acc) {
+                    sum = broadcast_val<T, LEN>(T(0));
+                }
+                const auto step = [&](register_type& sum, size_t i) {
+                    sum = mul_add_vals<T, LEN>(vector<T, LEN>::load_unaligned(a + i)(), vector<T, LEN>::load_unaligned(b + i)(), sum);
+                };
+                size_t i = 0;
+                for (; i + stride <= count; i += stride) {
+                    (step(acc[UNROLLED], i + UNROLLED * LEN), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    step(acc[0], i);
+                }
+                if (i < count) {
+                    // both tails come in zeroed, so are their products
+                    acc[0] = mul_add_vals<T, LEN>(vector<T, LEN>::load_partial(a + i, count - i)(), vector<T, LEN>::load_partial(b + i, count - i)(), acc[0]);
+                }
+                for (size_t width = sizeof...(UNROLLED) / 2; width != 0; width /= 2) {
+                    for (size_t j = 0; j < width; ++j) {
+                        acc[j] = add_vals<T, LEN>(acc[j], acc[j + width]);
+                    }
+                }
+                return reduce_register<T, add_reduction>(acc[0]);
+            }
+
+            // Ogita, Rump and Oishi's Dot2: exact products and sums, errors added up on the side
+            template<typename T, size_t LEN, size_t... UNROLLED>
+            T compensated_dot_span(const T* a, const T* b, size_t count, std::index_sequence<UNROLLED...>) noexcept {
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                compensated_sum<T, LEN> acc[sizeof...(UNROLLED)];
+                const auto step = [](compensated_sum<T, LEN>& sum, vector_type_t<T, LEN> x, vector_type_t<T, LEN> y) {
+                    vector_type_t<T, LEN> p, product_error;
+                    two_product_vals<T, LEN>(x, y, p, product_error);
+                    sum.add(p);
+                    sum.error = add_vals<T, LEN>(sum.error, product_error);
+                };
+                size_t i = 0;
+                for (; i + stride <= count; i += stride) {
+                    (step(acc[UNROLLED], vector<T, LEN>::load_unaligned(a + i + UNROLLED * LEN)(), vector<T, LEN>::load_unaligned(b + i + UNROLLED * LEN)()), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    step(acc[0], vector<T, LEN>::load_unaligned(a + i)(), vector<T, LEN>::load_unaligned(b + i)());
+                }
+                if (i < count) {
+                    step(acc[0], vector<T, LEN>::load_partial(a + i, count - i)(), vector<T, LEN>::load_partial(b + i, count - i)());
+                }
+                return finish_compensated(acc);
+            }
+
+        }
+
+        /*
+            Reductions over whole arrays, LEN wide registers (native by default)
+            with bulk_unroll accumulators so consecutive operations don't wait
+            on each other, finished with shuffles instead of hadd. The order of
+            operations differs from a scalar loop, so sums and products can
+            differ in the last bits. Empty spans give the identity, min and max
+            of data containing NaN are unspecified.
+        */
+        template<summation S = summation::plain, size_t LEN = 0, typename I0>
+        std::remove_const_t<I0> reduce_add(span<I0> in) noexcept {
+            using T = std::remove_const_t<I0>;
+            constexpr auto unrolled = std::make_index_sequence<detail::bulk_unroll>{};
+            static_assert(std::is_floating_point_v<T> || S == summation::plain, "Compensated summation needs floating point values.");
+            if constexpr (S == summation::compensated) {
+                return detail::compensated_sum_span<T, detail::bulk_length<T, LEN>>(in.data(), in.size(), unrolled);
+            }
+            else {
+                return detail::reduce_span<T, detail::bulk_length<T, LEN>, detail::add_reduction>(in.data(), in.size(), unrolled);
+            }
+        }
+
+        template<size_t LEN = 0, typename I0>
+        std::remove_const_t<I0> reduce_mul(span<I0> in) noexcept {
+            using T = std::remove_const_t<I0>;
+            static_assert(std::is_floating_point_v<T>, "reduce_mul is currently only implemented for floating point values.");
+            return detail::reduce_span<T, detail::bulk_length<T, LEN>, detail::mul_reduction>(in.data(), in.size(), std::make_index_sequence<detail::bulk_unroll>{});
+        }
+
+        template<size_t LEN = 0, typename I0>
+        std::remove_const_t<I0> reduce_min(span<I0> in) noexcept {
+            using T = std::remove_const_t<I0>;
+            return detail::reduce_span<T, detail::bulk_length<T, LEN>, detail::min_reduction>(in.data(), in.size(), std::make_index_sequence<detail::bulk_unroll>{});
+        }
+
+        template<size_t LEN = 0, typename I0>
+        std::remove_const_t<I0> reduce_max(span<I0> in) noexcept {
+            using T = std::remove_const_t<I0>;
+            return detail::reduce_span<T, detail::bulk_length<T, LEN>, detail::max_reduction>(in.data(), in.size(), std::make_index_sequence<detail::bulk_unroll>{});
+        }
+
+        // sum of a[i] * b[i] over a, b needs at least as many elements
+        template<summation S = summation::plain, size_t LEN = 0, typename I0, typename I1>
+        std::remove_const_t<I0> dot(span<I0> a, span<I1> b) noexcept {
+            using T = std::remove_const_t<I0>;
+            static_assert(std::is_same_v<T, std::remove_const_t<I1>>, "Inputs of a dot product have to share their element type.");
+            static_assert(std::is_floating_point_v<T>, "dot over spans is only implemented for floating point values.");
+            assert(b.size() >= a.size());
+            constexpr auto unrolled = std::make_index_sequence<detail::bulk_unroll>{};
+            if constexpr (S == summation::compensated) {
+                return detail::compensated_dot_span<T, detail::bulk_length<T, LEN>>(a.data(), b.data(), a.size(), unrolled);
+            }
+            else {
+                return detail::dot_span<T, detail::bulk_length<T, LEN>>(a.data(), b.data(), a.size(), unrolled);
+            }
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_REDUCTIONS_HPP
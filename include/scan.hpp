@@ -0,0 +1,358 @@
+#pragma once
+#ifndef SIMD_WRAP_SCAN_HPP
+#define SIMD_WRAP_SCAN_HPP
+#include <cstdint>
+#include <cstring>
+#include "mask.hpp"
+#include "transform.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            Any set of byte values, kept as the tables the vector lookup needs. Bit
+            h of lower[l] stands for the byte 16 h + l, upper[] the same for the
+            bytes from 0x80 on. Build one per set of delimiters and reuse it.
+        */
+        class byte_set {
+        public:
+
+            constexpr byte_set() noexcept = default;
+
+            // the bytes of a string, e.g. byte_set(",;\n")
+            constexpr explicit byte_set(const char* bytes) noexcept {
+                for (; *bytes != '\0'; ++bytes) {
+                    insert(uint8_t(*bytes));
+                }
+            }
+
+            constexpr byte_set& insert(uint8_t byte) noexcept {
+                uint8_t* rows = byte < 0x80 ? lower : upper;
+                rows[byte & 0x0F] = uint8_t(rows[byte & 0x0F] | (1u << ((byte >> 4) & 7)));
+                return *this;
+            }
+
+            constexpr bool contains(uint8_t byte) const noexcept {
+                const uint8_t* rows = byte < 0x80 ? lower : upper;
+                return (rows[byte & 0x0F] >> ((byte >> 4) & 7)) & 1;
+            }
+
+            const uint8_t* lower_rows() const noexcept {
+                return lower;
+            }
+
+            const uint8_t* upper_rows() const noexcept {
+                return upper;
+            }
+
+        private:
+            alignas(16) uint8_t lower[16] = {};
+            alignas(16) uint8_t upper[16] = {};
+        };
+
+        namespace detail {
+
+            // index of the lowest set bit, bits must not be 0. popcnt is in the baseline, tzcnt isn't
+            inline size_t lowest_bit(uint64_t bits) noexcept {
+                return popcount_bits((bits & (uint64_t(0) - bits)) - 1);
+            }
+
+            // bit i set when an odd number of bits up to and including i are, the inside of quotes
+            inline uint64_t prefix_xor(uint64_t bits) noexcept {
+                bits ^= bits << 1;
+                bits ^= bits << 2;
+                bits ^= bits << 4;
+                bits ^= bits << 8;
+                bits ^= bits << 16;
+                bits ^= bits << 32;
+                return bits;
+            }
+
+            template<size_t LEN>
+            constexpr uint64_t low_bits = LEN >= 64 ? ~uint64_t(0) : (uint64_t(1) << LEN) - 1;
+
+            // 16 bytes repeated in every 128 bit lane, the shape pshufb wants its table in
+            template<size_t LEN>
+            vector_type_t<uint8_t, LEN> broadcast_table_vals(const uint8_t* table) noexcept {
+                using vector_type = vector_type_t<uint8_t, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    vector_type result;
+                    std::memcpy(&result, table, sizeof(result));
+                    return result;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else {
+                    const __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+                    if constexpr (std::is_same_v<vector_type, __m512i>) {
+                        return _mm512_broadcast_i32x4(row);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                        return _mm256_broadcastsi128_si256(row);
+                    }
+                    else {
+                        return row;
+                    }
+                }
+#endif
+            }
+
+            /*
+                pshufb: byte i of the result is the byte of table's 128 bit lane
+                that the low nibble of index[i] picks, or 0 if index[i] has its
+                top bit set. Nothing crosses 128 bit lanes.
+            */
+            template<size_t LEN>
+            vector_type_t<uint8_t, LEN> shuffle_bytes_vals(vector_type_t<uint8_t, LEN> table, vector_type_t<uint8_t, LEN> index) noexcept {
+                using vector_type = vector_type_t<uint8_t, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    vector_type result;
+                    for (size_t i = 0; i < sizeof(vector_type); ++i) {
+                        result[i] = index[i] & 0x80 ? 0 : table[index[i] & 0x0F];
+                    }
+                    return result;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    return _mm512_shuffle_epi8(table, index);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    return _mm256_shuffle_epi8(table, index);
+                }
+                else {
+                    return _mm_shuffle_epi8(table, index);
+                }
+#endif
+            }
+
+            // upper nibble of each byte, there is no 8 bit shift
+            template<size_t LEN>
+            vector_type_t<uint8_t, LEN> high_nibble_vals(vector_type_t<uint8_t, LEN> a) noexcept {
+                using vector_type = vector_type_t<uint8_t, LEN>;
+                vector_type shifted;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    shifted = a >> 4;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m512i>) {
+                    shifted = _mm512_srli_epi16(a, 4);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256i>) {
+                    shifted = _mm256_srli_epi16(a, 4);
+                }
+                else {
+                    shifted = _mm_srli_epi16(a, 4);
+                }
+#endif
+                return and_vals<uint8_t, LEN>(shifted, broadcast_val<uint8_t, LEN>(uint8_t(0x0F)));
+            }
+
+            template<size_t LEN>
+            vector_type_t<uint8_t, LEN> classify_vals(vector_type_t<uint8_t, LEN> a, const uint8_t* low, const uint8_t* high) noexcept {
+                const auto low_nibble = and_vals<uint8_t, LEN>(a, broadcast_val<uint8_t, LEN>(uint8_t(0x0F)));
+                const auto by_low = shuffle_bytes_vals<LEN>(broadcast_table_vals<LEN>(low), low_nibble);
+                const auto by_high = shuffle_bytes_vals<LEN>(broadcast_table_vals<LEN>(high), high_nibble_vals<LEN>(a));
+                return and_vals<uint8_t, LEN>(by_low, by_high);
+            }
+
+            // lane i in bit i for the bytes equal to value
+            template<size_t LEN>
+            uint64_t equal_bits_vals(vector_type_t<uint8_t, LEN> a, uint8_t value) noexcept {
+                return mask_bits_vals<uint8_t, LEN>(compare_vals<uint8_t, LEN, compare_op::eq>(a, broadcast_val<uint8_t, LEN>(value)));
+            }
+
+            /*
+                Non-zero for the bytes in set. Three lookups: the row of the low
+                nibble in the table of its half (pshufb zeroes the bytes with the
+                top bit set, which picks the half), and the bit of the high nibble
+                in that row.
+            */
+            template<size_t LEN>
+            vector_type_t<uint8_t, LEN> byte_set_hits_vals(vector_type_t<uint8_t, LEN> a, byte_set const& set) noexcept {
+                alignas(16) static constexpr uint8_t nibble_bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+                const auto top_flipped = xor_vals<uint8_t, LEN>(a, broadcast_val<uint8_t, LEN>(uint8_t(0x80)));
+                const auto rows = or_vals<uint8_t, LEN>(
+                    shuffle_bytes_vals<LEN>(broadcast_table_vals<LEN>(set.lower_rows()), a),
+                    shuffle_bytes_vals<LEN>(broadcast_table_vals<LEN>(set.upper_rows()), top_flipped));
+                const auto bit = shuffle_bytes_vals<LEN>(broadcast_table_vals<LEN>(nibble_bits), high_nibble_vals<LEN>(a));
+                return and_vals<uint8_t, LEN>(rows, bit);
+            }
+
+            template<size_t LEN>
+            mask_type_t<uint8_t, LEN> byte_set_mask_vals(vector_type_t<uint8_t, LEN> a, byte_set const& set) noexcept {
+                return compare_vals<uint8_t, LEN, compare_op::neq>(byte_set_hits_vals<LEN>(a, set), vector_type_t<uint8_t, LEN>{});
+            }
+
+            template<size_t LEN>
+            uint64_t byte_set_bits_vals(vector_type_t<uint8_t, LEN> a, byte_set const& set) noexcept {
+                return mask_bits_vals<uint8_t, LEN>(byte_set_mask_vals<LEN>(a, set));
+            }
+
+            /*
+                Calls visit(block, offset, used) on every LEN bytes, the last block
+                zero padded with only its first bits in used. Stops once visit
+                returns false.
+            */
+            template<size_t LEN, typename Visit>
+            void scan_blocks(const uint8_t* data, size_t count, Visit&& visit) {
+                static_assert(LEN <= 64, "Scans keep a block in one 64 bit mask.");
+                size_t i = 0;
+                for (; i + LEN <= count; i += LEN) {
+                    if (!visit(load_vals<uint8_t, LEN, false>(data + i), i, low_bits<LEN>)) {
+                        return;
+                    }
+                }
+                if (i < count) {
+                    visit(masked_load_vals<uint8_t, LEN>(data + i, count - i), i, low_bits<LEN> >> (LEN - (count - i)));
+                }
+            }
+
+            template<typename C>
+            const uint8_t* as_bytes(span<C> data) noexcept {
+                static_assert(sizeof(C) == 1 && std::is_integral_v<std::remove_const_t<C>>, "Scans take spans of bytes or chars.");
+                return reinterpret_cast<const uint8_t*>(data.data());
+            }
+
+            // writes the positions of the bits to out until it's full
+            inline bool write_positions(uint64_t bits, size_t offset, span<size_t> out, size_t& written) noexcept {
+                while (bits != 0) {
+                    if (written == out.size()) {
+                        return false;
+                    }
+                    out[written++] = offset + lowest_bit(bits);
+                    bits &= bits - 1;
+                }
+                return true;
+            }
+
+        }
+
+        /*
+            pshufb on each 128 bit lane: byte i is table[index[i] & 15] from the
+            same lane of table, or 0 where index[i] has its top bit set.
+        */
+        template<size_t LEN>
+        vector<uint8_t, LEN> shuffle_bytes(vector<uint8_t, LEN> const& table, vector<uint8_t, LEN> const& index) noexcept {
+            return vector<uint8_t, LEN>(detail::shuffle_bytes_vals<LEN>(table(), index()));
+        }
+
+        /*
+            low[b & 15] & high[b >> 4] for every byte b: give each class of bytes
+            a bit in both tables and a non-zero result names the classes b is in.
+            Whitespace, digits, structural characters and so on in two lookups.
+        */
+        template<size_t LEN>
+        vector<uint8_t, LEN> classify(vector<uint8_t, LEN> const& v, const uint8_t (&low)[16], const uint8_t (&high)[16]) noexcept {
+            return vector<uint8_t, LEN>(detail::classify_vals<LEN>(v(), low, high));
+        }
+
+        // the lanes of v that are in set, exact for any set
+        template<size_t LEN>
+        mask<uint8_t, LEN> match(byte_set const& set, vector<uint8_t, LEN> const& v) noexcept {
+            return mask<uint8_t, LEN>(detail::byte_set_mask_vals<LEN>(v(), set));
+        }
+
+        // the first lane set in m, LEN if there is none
+        template<typename T, size_t LEN>
+        size_t find_first(mask<T, LEN> const& m) noexcept {
+            const uint64_t bits = m.bits();
+            return bits == 0 ? LEN : detail::lowest_bit(bits);
+        }
+
+        /*
+            The scans below take spans of bytes or chars and go over them a
+            register at a time, comparing, taking the movemask and working on
+            the bits. Positions are offsets into data, the find functions
+            return data.size() when nothing matched.
+        */
+        template<size_t LEN = 0, typename C>
+        size_t find_byte(span<C> data, uint8_t value) noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t found = data.size();
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t offset, uint64_t used) {
+                const uint64_t bits = detail::equal_bits_vals<lanes>(block, value) & used;
+                if (bits != 0) {
+                    found = offset + detail::lowest_bit(bits);
+                }
+                return bits == 0;
+            });
+            return found;
+        }
+
+        template<size_t LEN = 0, typename C>
+        size_t find_first_of(span<C> data, byte_set const& set) noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t found = data.size();
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t offset, uint64_t used) {
+                const uint64_t bits = detail::byte_set_bits_vals<lanes>(block, set) & used;
+                if (bits != 0) {
+                    found = offset + detail::lowest_bit(bits);
+                }
+                return bits == 0;
+            });
+            return found;
+        }
+
+        // how often value occurs, e.g. the lines of a file
+        template<size_t LEN = 0, typename C>
+        size_t count_byte(span<C> data, uint8_t value) noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t count = 0;
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t, uint64_t used) {
+                count += detail::popcount_bits(detail::equal_bits_vals<lanes>(block, value) & used);
+                return true;
+            });
+            return count;
+        }
+
+        template<size_t LEN = 0, typename C>
+        size_t count_of(span<C> data, byte_set const& set) noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t count = 0;
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t, uint64_t used) {
+                count += detail::popcount_bits(detail::byte_set_bits_vals<lanes>(block, set) & used);
+                return true;
+            });
+            return count;
+        }
+
+        /*
+            Writes the position of every byte of data in set to positions, in
+            order, and returns how many it wrote. Stops when positions is full,
+            carry on from the byte after the last one written.
+        */
+        template<size_t LEN = 0, typename C>
+        size_t find_all(span<C> data, byte_set const& set, span<size_t> positions) noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t written = 0;
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t offset, uint64_t used) {
+                return detail::write_positions(detail::byte_set_bits_vals<lanes>(block, set) & used, offset, positions, written);
+            });
+            return written;
+        }
+
+        /*
+            find_all for CSV like input: skips the bytes between a quote and the
+            next one. A doubled quote inside a quoted field closes and reopens
+            it, so escaped quotes need no special case. data has to start
+            outside of quotes, and set shouldn't contain quote.
+        */
+        template<size_t LEN = 0, typename C>
+        size_t find_all_unquoted(span<C> data, byte_set const& set, span<size_t> positions, uint8_t quote = '"') noexcept {
+            constexpr size_t lanes = detail::bulk_length<uint8_t, LEN>;
+            size_t written = 0;
+            uint64_t inside = 0;
+            detail::scan_blocks<lanes>(detail::as_bytes(data), data.size(), [&](auto block, size_t offset, uint64_t used) {
+                const uint64_t quoted = detail::prefix_xor(detail::equal_bits_vals<lanes>(block, quote)) ^ inside;
+                // all ones if the block ends inside quotes
+                inside = uint64_t(0) - ((quoted >> (lanes - 1)) & 1);
+                return detail::write_positions(detail::byte_set_bits_vals<lanes>(block, set) & ~quoted & used, offset, positions, written);
+            });
+            return written;
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_SCAN_HPP
@@ -0,0 +1,406 @@
+#pragma once
+#ifndef SIMD_WRAP_SOA_ARRAY_HPP
+#define SIMD_WRAP_SOA_ARRAY_HPP
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include "vector.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            Structure-of-arrays storage for COMPONENTS-wide elements (xyz points,
+            rgba colours, ...): each component lives in its own stream, aligned
+            for vector<T, LEN> and padded to a whole number of registers. The
+            padding past size() is kept zeroed, so blocks can always be loaded
+            as full aligned registers.
+
+            Iterating the array walks it in blocks of LEN elements, each block
+            handing out one vector per component.
+
+            Memory comes from a std::pmr::memory_resource (e.g. an aligned_arena),
+            following the pmr rules: moves keep the resource, copies start out on
+            the default one.
+        */
+        template<typename T, size_t COMPONENTS, size_t LEN = native_length<T>>
+        class soa_array {
+            static_assert(COMPONENTS > 0, "soa_array needs at least one component.");
+            static_assert(is_simd_compatible<T, LEN>, "Given combination of data type T and vector length LEN is not SIMD-compatible!");
+            static_assert(simd_traits<T, LEN>::remainder_entries == 0, "soa_array streams are processed in whole registers, LEN has to fill one.");
+        public:
+            using value_type = T;
+            using vector_type = vector<T, LEN>;
+            using element_type = std::array<T, COMPONENTS>;
+            constexpr static size_t components = COMPONENTS;
+            constexpr static size_t length = LEN;
+            constexpr static size_t alignment = simd_traits<T, LEN>::alignment;
+
+            // LEN consecutive elements, or fewer for the last block
+            template<bool CONST>
+            class basic_block {
+                using pointer = std::conditional_t<CONST, const T*, T*>;
+            public:
+                basic_block(pointer first_, size_t stride_, size_t count_) noexcept : first(first_), stride(stride_), count(count_) {}
+
+                vector_type load(size_t component) const noexcept {
+                    return vector_type::load(first + component * stride);
+                }
+
+                // lanes past size() aren't written, so the padding stays zero
+                template<bool C = CONST, typename = std::enable_if_t<!C>>
+                void store(size_t component, vector_type const& value) const noexcept {
+                    if (count == LEN) {
+                        value.store(first + component * stride);
+                    }
+                    else {
+                        value.store_partial(first + component * stride, count);
+                    }
+                }
+
+                size_t size() const noexcept {
+                    return count;
+                }
+
+            private:
+                pointer first;
+                size_t stride;
+                size_t count;
+            };
+
+            template<bool CONST>
+            class basic_block_iterator {
+                using pointer = std::conditional_t<CONST, const T*, T*>;
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = basic_block<CONST>;
+                using difference_type = std::ptrdiff_t;
+                using reference = value_type;
+
+                basic_block_iterator(pointer storage_, size_t stride_, size_t offset_, size_t count_) noexcept :
+                    storage(storage_), stride(stride_), offset(offset_), count(count_) {}
+
+                value_type operator*() const noexcept {
+                    const size_t remaining = count - offset;
+                    return value_type(storage + offset, stride, remaining < LEN ? remaining : LEN);
+                }
+
+                basic_block_iterator& operator++() noexcept {
+                    offset += LEN;
+                    return *this;
+                }
+
+                basic_block_iterator operator++(int) noexcept {
+                    basic_block_iterator result = *this;
+                    offset += LEN;
+                    return result;
+                }
+
+                bool operator==(basic_block_iterator const& other) const noexcept {
+                    return offset == other.offset;
+                }
+
+                bool operator!=(basic_block_iterator const& other) const noexcept {
+                    return offset != other.offset;
+                }
+
+            private:
+                pointer storage;
+                size_t stride;
+                size_t offset;
+                size_t count;
+            };
+
+            using block = basic_block<false>;
+            using const_block = basic_block<true>;
+            using iterator = basic_block_iterator<false>;
+            using const_iterator = basic_block_iterator<true>;
+
+            soa_array() noexcept;
+            explicit soa_array(std::pmr::memory_resource* resource) noexcept;
+            explicit soa_array(size_t count, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+            soa_array(soa_array const& other);
+            soa_array(soa_array&& other) noexcept;
+            soa_array& operator=(soa_array const& other);
+            soa_array& operator=(soa_array&& other);
+            ~soa_array();
+
+            std::pmr::memory_resource* get_resource() const noexcept;
+            size_t size() const noexcept;
+            bool empty() const noexcept;
+            // per component, always a multiple of LEN
+            size_t capacity() const noexcept;
+            size_t num_blocks() const noexcept;
+
+            void reserve(size_t new_capacity);
+            // new elements are zeroed
+            void resize(size_t new_size);
+            void clear() noexcept;
+            void push_back(element_type const& element);
+
+            element_type get(size_t index) const noexcept;
+            void set(size_t index, element_type const& element) noexcept;
+            T& operator()(size_t component, size_t index) noexcept;
+            const T& operator()(size_t component, size_t index) const noexcept;
+            // start of a component stream, aligned to alignment
+            T* data(size_t component) noexcept;
+            const T* data(size_t component) const noexcept;
+
+            block block_at(size_t block_index) noexcept;
+            const_block block_at(size_t block_index) const noexcept;
+            iterator begin() noexcept;
+            iterator end() noexcept;
+            const_iterator begin() const noexcept;
+            const_iterator end() const noexcept;
+            const_iterator cbegin() const noexcept;
+            const_iterator cend() const noexcept;
+
+        private:
+            void reallocate(size_t new_stride);
+            void copy_from(soa_array const& other);
+            T* allocate(size_t new_stride);
+            void deallocate() noexcept;
+
+            std::pmr::memory_resource* resource;
+            T* storage = nullptr;
+            size_t count = 0;
+            size_t stride = 0;
+        };
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::soa_array() noexcept : resource(std::pmr::get_default_resource()) {}
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::soa_array(std::pmr::memory_resource* resource_) noexcept : resource(resource_) {}
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::soa_array(size_t count_, std::pmr::memory_resource* resource_) : resource(resource_) {
+            resize(count_);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::soa_array(soa_array const& other) : resource(std::pmr::get_default_resource()) {
+            copy_from(other);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::soa_array(soa_array&& other) noexcept : resource(other.resource), storage(other.storage), count(other.count), stride(other.stride) {
+            other.storage = nullptr;
+            other.count = 0;
+            other.stride = 0;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>& soa_array<T, COMPONENTS, LEN>::operator=(soa_array const& other) {
+            if (this != &other) {
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>& soa_array<T, COMPONENTS, LEN>::operator=(soa_array&& other) {
+            if (this == &other) {
+                return *this;
+            }
+            if (resource->is_equal(*other.resource)) {
+                deallocate();
+                storage = other.storage;
+                count = other.count;
+                stride = other.stride;
+                other.storage = nullptr;
+                other.count = 0;
+                other.stride = 0;
+            }
+            else {
+                // memory can't change hands between resources, copy instead
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        soa_array<T, COMPONENTS, LEN>::~soa_array() {
+            deallocate();
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline std::pmr::memory_resource* soa_array<T, COMPONENTS, LEN>::get_resource() const noexcept {
+            return resource;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline size_t soa_array<T, COMPONENTS, LEN>::size() const noexcept {
+            return count;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline bool soa_array<T, COMPONENTS, LEN>::empty() const noexcept {
+            return count == 0;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline size_t soa_array<T, COMPONENTS, LEN>::capacity() const noexcept {
+            return stride;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline size_t soa_array<T, COMPONENTS, LEN>::num_blocks() const noexcept {
+            return (count + LEN - 1) / LEN;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        void soa_array<T, COMPONENTS, LEN>::reserve(size_t new_capacity) {
+            const size_t new_stride = (new_capacity + LEN - 1) / LEN * LEN;
+            if (new_stride > stride) {
+                reallocate(new_stride);
+            }
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        void soa_array<T, COMPONENTS, LEN>::resize(size_t new_size) {
+            if (new_size > stride) {
+                reserve(new_size);
+            }
+            else if (new_size < count) {
+                // dropped elements become padding again
+                for (size_t c = 0; c < COMPONENTS; ++c) {
+                    std::memset(data(c) + new_size, 0, sizeof(T) * (count - new_size));
+                }
+            }
+            count = new_size;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline void soa_array<T, COMPONENTS, LEN>::clear() noexcept {
+            resize(0);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        void soa_array<T, COMPONENTS, LEN>::push_back(element_type const& element) {
+            if (count == stride) {
+                reallocate(stride == 0 ? LEN : stride * 2);
+            }
+            ++count;
+            set(count - 1, element);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::element_type soa_array<T, COMPONENTS, LEN>::get(size_t index) const noexcept {
+            element_type result;
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                result[c] = storage[c * stride + index];
+            }
+            return result;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline void soa_array<T, COMPONENTS, LEN>::set(size_t index, element_type const& element) noexcept {
+            for (size_t c = 0; c < COMPONENTS; ++c) {
+                storage[c * stride + index] = element[c];
+            }
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline T& soa_array<T, COMPONENTS, LEN>::operator()(size_t component, size_t index) noexcept {
+            return storage[component * stride + index];
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline const T& soa_array<T, COMPONENTS, LEN>::operator()(size_t component, size_t index) const noexcept {
+            return storage[component * stride + index];
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline T* soa_array<T, COMPONENTS, LEN>::data(size_t component) noexcept {
+            return storage + component * stride;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline const T* soa_array<T, COMPONENTS, LEN>::data(size_t component) const noexcept {
+            return storage + component * stride;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::block soa_array<T, COMPONENTS, LEN>::block_at(size_t block_index) noexcept {
+            return *iterator(storage, stride, block_index * LEN, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::const_block soa_array<T, COMPONENTS, LEN>::block_at(size_t block_index) const noexcept {
+            return *const_iterator(storage, stride, block_index * LEN, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::iterator soa_array<T, COMPONENTS, LEN>::begin() noexcept {
+            return iterator(storage, stride, 0, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::iterator soa_array<T, COMPONENTS, LEN>::end() noexcept {
+            return iterator(storage, stride, num_blocks() * LEN, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::const_iterator soa_array<T, COMPONENTS, LEN>::begin() const noexcept {
+            return cbegin();
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::const_iterator soa_array<T, COMPONENTS, LEN>::end() const noexcept {
+            return cend();
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::const_iterator soa_array<T, COMPONENTS, LEN>::cbegin() const noexcept {
+            return const_iterator(storage, stride, 0, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline typename soa_array<T, COMPONENTS, LEN>::const_iterator soa_array<T, COMPONENTS, LEN>::cend() const noexcept {
+            return const_iterator(storage, stride, num_blocks() * LEN, count);
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        void soa_array<T, COMPONENTS, LEN>::reallocate(size_t new_stride) {
+            T* new_storage = allocate(new_stride);
+            // zeroing the whole thing also sets up the padding
+            std::memset(new_storage, 0, sizeof(T) * new_stride * COMPONENTS);
+            for (size_t c = 0; c < COMPONENTS && count != 0; ++c) {
+                std::memcpy(new_storage + c * new_stride, storage + c * stride, sizeof(T) * count);
+            }
+            deallocate();
+            storage = new_storage;
+            stride = new_stride;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        void soa_array<T, COMPONENTS, LEN>::copy_from(soa_array const& other) {
+            clear();
+            reserve(other.count);
+            for (size_t c = 0; c < COMPONENTS && other.count != 0; ++c) {
+                std::memcpy(data(c), other.data(c), sizeof(T) * other.count);
+            }
+            count = other.count;
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline T* soa_array<T, COMPONENTS, LEN>::allocate(size_t new_stride) {
+            return static_cast<T*>(resource->allocate(sizeof(T) * new_stride * COMPONENTS, alignment));
+        }
+
+        template<typename T, size_t COMPONENTS, size_t LEN>
+        inline void soa_array<T, COMPONENTS, LEN>::deallocate() noexcept {
+            if (storage != nullptr) {
+                resource->deallocate(storage, sizeof(T) * stride * COMPONENTS, alignment);
+                storage = nullptr;
+            }
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_SOA_ARRAY_HPP
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef SIMD_WRAP_SPAN_HPP
+#define SIMD_WRAP_SPAN_HPP
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "detail/simd_traits.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        /*
+            Pointer and element count, the argument type of the bulk functions.
+            Stand-in for std::span while we target C++17: converts from arrays and
+            from anything with data() and size() (std::vector, std::array,
+            std::span, ...), and can be deduced from those with sw::span(x).
+        */
+        template<typename T>
+        class span {
+        public:
+            using element_type = T;
+            using value_type = std::remove_cv_t<T>;
+
+            constexpr span() noexcept = default;
+            constexpr span(T* ptr_, size_t count_) noexcept : ptr(ptr_), count(count_) {}
+            template<size_t N>
+            constexpr span(T (&array)[N]) noexcept : ptr(array), count(N) {}
+            template<typename Container, typename = std::enable_if_t<
+                std::is_convertible_v<decltype(std::declval<Container&>().data()), T*> &&
+                !std::is_same_v<std::remove_cv_t<std::remove_reference_t<Container>>, span>>>
+            constexpr span(Container&& container) noexcept : ptr(container.data()), count(container.size()) {}
+
+            constexpr T* data() const noexcept {
+                return ptr;
+            }
+
+            constexpr size_t size() const noexcept {
+                return count;
+            }
+
+            constexpr bool empty() const noexcept {
+                return count == 0;
+            }
+
+            constexpr T& operator[](size_t idx) const noexcept {
+                return ptr[idx];
+            }
+
+            constexpr T* begin() const noexcept {
+                return ptr;
+            }
+
+            constexpr T* end() const noexcept {
+                return ptr + count;
+            }
+
+            constexpr span subspan(size_t offset, size_t length) const noexcept {
+                return span(ptr + offset, length);
+            }
+
+        private:
+            T* ptr = nullptr;
+            size_t count = 0;
+        };
+
+        template<typename T, size_t N>
+        span(T (&)[N]) -> span<T>;
+
+        template<typename Container>
+        span(Container&) -> span<std::remove_pointer_t<decltype(std::declval<Container&>().data())>>;
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_SPAN_HPP
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef SIMD_WRAP_THREAD_POOL_HPP
+#define SIMD_WRAP_THREAD_POOL_HPP
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace sw {
+
+    /*
+        Work-stealing pool behind the parallel bulk functions. Every worker owns
+        a deque of tasks: it works from the back of its own and steals from the
+        front of the others when that runs dry. The thread calling
+        parallel_for() takes part as well, so nesting parallel_for() inside a
+        task doesn't deadlock.
+
+        Tasks must not throw, an exception escaping one terminates the program.
+    */
+    class thread_pool {
+    public:
+        // threads == 0 uses std::thread::hardware_concurrency(), the caller counts as one of them
+        explicit thread_pool(size_t threads = 0);
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+        ~thread_pool();
+
+        // threads working on a parallel_for(), including the caller
+        size_t size() const noexcept;
+
+        // runs task(i) for every i in [0, count) and returns once all of them finished
+        template<typename Task>
+        void parallel_for(size_t count, Task&& task);
+
+        // shared by the parallel bulk functions unless a pool is given explicitly
+        static thread_pool& default_pool();
+
+    private:
+        using task_fn = void(*)(void* context, size_t index);
+        void run(size_t count, task_fn fn, void* context);
+
+        struct impl;
+        std::unique_ptr<impl> state;
+    };
+
+    template<typename Task>
+    inline void thread_pool::parallel_for(size_t count, Task&& task) {
+        using task_type = std::remove_reference_t<Task>;
+        run(count, [](void* context, size_t index) {
+            (*static_cast<task_type*>(context))(index);
+        }, const_cast<void*>(static_cast<const void*>(&task)));
+    }
+
+    namespace execution {
+
+        struct sequenced_policy {};
+
+        /*
+            Splits bulk work into chunks of about chunk_bytes per stream that
+            run on pool (the default pool when null). Reductions combine the
+            chunk results in a fixed order, so they don't depend on the number
+            of threads.
+        */
+        struct parallel_policy {
+            thread_pool* pool = nullptr;
+            size_t chunk_bytes = 64 * 1024;
+
+            // defined in thread_pool.cpp, this struct is shared by every ISA level
+            thread_pool& get_pool() const;
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_THREAD_POOL_HPP
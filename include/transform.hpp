@@ -0,0 +1,175 @@
+#pragma once
+#ifndef SIMD_WRAP_TRANSFORM_HPP
+#define SIMD_WRAP_TRANSFORM_HPP
+#include <cassert>
+#include <utility>
+#include "half.hpp"
+#include "span.hpp"
+#include "vector_functions.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // registers in flight per iteration of the bulk loops
+            constexpr size_t bulk_unroll = 4;
+
+            // LEN of 0 asks for the widest register the compiled level has for T
+            template<typename T, size_t LEN>
+            constexpr size_t bulk_length = LEN == 0 ? native_length<T> : LEN;
+
+            // T is what op computes in, Out and Inputs are T or half storage for float
+            template<typename T, size_t LEN, typename Op, typename Out, typename... Inputs>
+            void transform_partial(Op& op, Out* out, size_t count, const Inputs*... inputs) {
+                const vector<T, LEN> result = op(load_elements_partial<T, LEN>(inputs, count)...);
+                store_elements_partial<T, LEN>(out, result, count);
+            }
+
+            template<typename T, size_t LEN, bool LOADS_ALIGNED, bool STORES_ALIGNED, typename Op, typename Out, typename... Inputs>
+            void transform_step(Op& op, size_t i, Out* out, const Inputs*... inputs) {
+                const vector<T, LEN> result = op(load_elements<T, LEN, LOADS_ALIGNED>(inputs + i)...);
+                store_elements<T, LEN, STORES_ALIGNED>(out + i, result);
+            }
+
+            template<typename T, size_t LEN, bool LOADS_ALIGNED, bool STORES_ALIGNED, typename Op, size_t... UNROLLED, typename Out, typename... Inputs>
+            size_t transform_loop(Op& op, std::index_sequence<UNROLLED...>, Out* out, size_t i, size_t count, const Inputs*... inputs) {
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                for (; i + stride <= count; i += stride) {
+                    (transform_step<T, LEN, LOADS_ALIGNED, STORES_ALIGNED>(op, i + UNROLLED * LEN, out, inputs...), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    transform_step<T, LEN, LOADS_ALIGNED, STORES_ALIGNED>(op, i, out, inputs...);
+                }
+                return i;
+            }
+
+            /*
+                Masked head up to the outputs alignment, unrolled main loop with
+                aligned stores (and loads, when the inputs share the outputs
+                offset), then one masked iteration for the tail. Half storage
+                anywhere keeps it all unaligned.
+            */
+            template<typename T, size_t LEN, typename Op, typename Out, typename... Inputs>
+            void transform_spans(Op& op, Out* out, size_t count, const Inputs*... inputs) {
+                static_assert(simd_traits<T, LEN>::remainder_entries == 0, "Bulk functions work on whole registers, LEN has to fill one.");
+                static_assert(std::is_same_v<compute_type_t<Out>, T> && (std::is_same_v<compute_type_t<Inputs>, T> && ...),
+                    "Inputs and output of a transform have to share their element type, or store floats as half.");
+                constexpr auto unrolled = std::make_index_sequence<bulk_unroll>{};
+                size_t i = 0;
+                if constexpr (is_half_v<Out> || (is_half_v<Inputs> || ...)) {
+                    i = transform_loop<T, LEN, false, false>(op, unrolled, out, i, count, inputs...);
+                }
+                else {
+                    i = peel_count<T, LEN>(out, count);
+                    if (i != 0) {
+                        transform_partial<T, LEN>(op, out, i, inputs...);
+                    }
+                    if (!is_aligned<T, LEN>(out + i)) {
+                        i = transform_loop<T, LEN, false, false>(op, unrolled, out, i, count, inputs...);
+                    }
+                    else if ((is_aligned<T, LEN>(inputs + i) && ...)) {
+                        i = transform_loop<T, LEN, true, true>(op, unrolled, out, i, count, inputs...);
+                    }
+                    else {
+                        i = transform_loop<T, LEN, false, true>(op, unrolled, out, i, count, inputs...);
+                    }
+                }
+                if (i < count) {
+                    transform_partial<T, LEN>(op, out + i, count - i, (inputs + i)...);
+                }
+            }
+
+            template<typename T, size_t LEN, typename Op, typename... Inputs>
+            vector<T, LEN> map_registers(Op& op, size_t i, const Inputs*... inputs) {
+                return op(load_elements<T, LEN, false>(inputs + i)...);
+            }
+
+            /*
+                Sums op over the inputs with bulk_unroll independent accumulators,
+                so consecutive adds don't wait on each other. The tail is mapped
+                masked and its unused lanes zeroed before they are added, op
+                doesn't have to map 0 to 0.
+            */
+            template<typename T, size_t LEN, typename Op, size_t... UNROLLED, typename... Inputs>
+            T transform_reduce_spans(Op& op, std::index_sequence<UNROLLED...>, size_t count, const Inputs*... inputs) {
+                static_assert(simd_traits<T, LEN>::remainder_entries == 0, "Bulk functions work on whole registers, LEN has to fill one.");
+                constexpr size_t stride = LEN * sizeof...(UNROLLED);
+                vector<T, LEN> sums[sizeof...(UNROLLED)];
+                size_t i = 0;
+                for (; i + stride <= count; i += stride) {
+                    ((sums[UNROLLED] += map_registers<T, LEN>(op, i + UNROLLED * LEN, inputs...)), ...);
+                }
+                for (; i + LEN <= count; i += LEN) {
+                    sums[0] += map_registers<T, LEN>(op, i, inputs...);
+                }
+                if (i < count) {
+                    const vector<T, LEN> tail = op(load_elements_partial<T, LEN>(inputs + i, count - i)...);
+                    sums[0] += vector<T, LEN>(select_vals<T, LEN>(lane_mask<T, LEN>(count - i), tail(), vector_type_t<T, LEN>{}));
+                }
+                return reduce_add((sums[UNROLLED] + ...));
+            }
+
+        }
+
+        /*
+            Applies op to every LEN wide chunk of the inputs and writes the result
+            to out. op gets one vector<T, LEN> const& per input and returns a
+            vector or an expression of its arguments, e.g.
+
+                sw::transform(sw::span(a), sw::span(b), sw::span(out),
+                    [](auto const& x, auto const& y) { return x * y + 1.0f; });
+
+            Expressions are evaluated after op returns, so an op building on its
+            own locals has to return a vector<T, LEN> rather than an expression.
+            The inputs need at least out.size() elements, any of them may be out itself
+            for an in place transform, but must not overlap it otherwise. Spans of
+            sw::half stand in for float ones: they are converted on load and store
+            and op sees float vectors.
+        */
+        template<size_t LEN = 0, typename I0, typename T, typename Op>
+        void transform(span<I0> in0, span<T> out, Op op) {
+            assert(in0.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::transform_spans<C, detail::bulk_length<C, LEN>>(op, out.data(), out.size(), static_cast<const I0*>(in0.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename T, typename Op>
+        void transform(span<I0> in0, span<I1> in1, span<T> out, Op op) {
+            assert(in0.size() >= out.size() && in1.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::transform_spans<C, detail::bulk_length<C, LEN>>(op, out.data(), out.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename I2, typename T, typename Op>
+        void transform(span<I0> in0, span<I1> in1, span<I2> in2, span<T> out, Op op) {
+            assert(in0.size() >= out.size() && in1.size() >= out.size() && in2.size() >= out.size());
+            using C = detail::compute_type_t<T>;
+            detail::transform_spans<C, detail::bulk_length<C, LEN>>(op, out.data(), out.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()), static_cast<const I2*>(in2.data()));
+        }
+
+        // Sum of op over all elements of the input, e.g. a sum of squares
+        template<size_t LEN = 0, typename I0, typename Op>
+        detail::compute_type_t<I0> transform_reduce(span<I0> in0, Op op) {
+            using T = detail::compute_type_t<I0>;
+            return detail::transform_reduce_spans<T, detail::bulk_length<T, LEN>>(op, std::make_index_sequence<detail::bulk_unroll>{}, in0.size(),
+                static_cast<const I0*>(in0.data()));
+        }
+
+        template<size_t LEN = 0, typename I0, typename I1, typename Op>
+        detail::compute_type_t<I0> transform_reduce(span<I0> in0, span<I1> in1, Op op) {
+            using T = detail::compute_type_t<I0>;
+            static_assert(std::is_same_v<T, detail::compute_type_t<I1>>, "Inputs of a transform_reduce have to share their element type.");
+            assert(in1.size() >= in0.size());
+            return detail::transform_reduce_spans<T, detail::bulk_length<T, LEN>>(op, std::make_index_sequence<detail::bulk_unroll>{}, in0.size(),
+                static_cast<const I0*>(in0.data()), static_cast<const I1*>(in1.data()));
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_TRANSFORM_HPP
@@ -1,23 +1,77 @@
 #pragma once
 #ifndef SIMD_WRAP_VECTOR_HPP
 #define SIMD_WRAP_VECTOR_HPP
-#include "simd_traits.hpp"
+#include "detail/simd_traits.hpp"
+#include "detail/base_expressions.hpp"
+#include "detail/binary_operators.hpp"
+#include "detail/unary_operators.hpp"
+#include "detail/compare_operators.hpp"
+#include "detail/load_store.hpp"
 
 namespace sw {
 
-    template<typename T, size_t LEN>
-    struct vector {
-        using underlying_vector_type = typename simd_traits<T, LEN>::vector_type;
-        static_assert(is_simd_compatible<T, LEN>, "Given combination of data type T and vector length LEN is not SIMD-compatible!");
-        constexpr vector() noexcept;
-        constexpr explicit vector(T value) noexcept;
-        // not the same as LEN. Should we force matching 
-        // for LEN or for size()?
-        // - probably LEN, as thats the users/mathematical intent
-        constexpr size_t size() const noexcept;
-    private:
-        underlying_vector_type data;
-    };
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            // expression node that evaluates into a vector<T, LEN>
+            template<typename EXPR, typename T, size_t LEN, bool = is_expression_node_v<EXPR>>
+            struct is_expression_of : std::false_type {};
+
+            template<typename EXPR, typename T, size_t LEN>
+            struct is_expression_of<EXPR, T, LEN, true> : std::bool_constant<std::is_same_v<typename EXPR::value_type, T> && EXPR::length == LEN> {};
+
+            template<typename EXPR, typename T, size_t LEN>
+            constexpr bool is_expression_of_v = is_expression_of<EXPR, T, LEN>::value;
+
+        }
+
+        template<typename T, size_t LEN>
+        struct vector {
+            using underlying_vector_type = typename simd_traits<T, LEN>::vector_type;
+            using value_type = T;
+            constexpr static size_t length = LEN;
+            static_assert(is_simd_compatible<T, LEN>, "Given combination of data type T and vector length LEN is not SIMD-compatible!");
+            constexpr vector() noexcept;
+            constexpr explicit vector(T value) noexcept;
+            // Wraps a register produced by intrinsics or the detail:: helpers
+            constexpr explicit vector(underlying_vector_type value) noexcept;
+            // Evaluates the whole expression tree in registers, without intermediate vectors
+            template<typename EXPR, typename = std::enable_if_t<detail::is_expression_of_v<EXPR, T, LEN>>>
+            vector(EXPR const& expr) noexcept;
+            template<typename EXPR, typename = std::enable_if_t<detail::is_expression_of_v<EXPR, T, LEN>>>
+            vector& operator=(EXPR const& expr) noexcept;
+
+            template<typename OP>
+            vector& operator+=(OP const& operand) noexcept;
+            template<typename OP>
+            vector& operator-=(OP const& operand) noexcept;
+            template<typename OP>
+            vector& operator*=(OP const& operand) noexcept;
+            template<typename OP>
+            vector& operator/=(OP const& operand) noexcept;
+
+            // ptr has to be aligned to simd_traits<T, LEN>::alignment (see is_aligned)
+            static vector load(const T* ptr) noexcept;
+            static vector load_unaligned(const T* ptr) noexcept;
+            void store(T* ptr) const noexcept;
+            void store_unaligned(T* ptr) const noexcept;
+            // Reads min(count, LEN) elements and zeroes the other lanes, never touching ptr[count] and beyond
+            static vector load_partial(const T* ptr, size_t count = LEN) noexcept;
+            // Writes the first min(count, LEN) lanes, leaving the memory after them alone
+            void store_partial(T* ptr, size_t count = LEN) const noexcept;
+
+            // Leaf of an expression tree: yields the register itself
+            underlying_vector_type operator()() const noexcept;
+            // not the same as LEN. Should we force matching 
+            // for LEN or for size()?
+            // - probably LEN, as thats the users/mathematical intent
+            constexpr size_t size() const noexcept;
+        private:
+            underlying_vector_type data;
+        };
+
+    }
 
 }
 
@@ -1,21 +1,119 @@
+#include <cassert>
 #include "vector.hpp"
 
 namespace sw {
 
-    template<typename T, size_t LEN>
-    constexpr inline vector<T, LEN>::vector() noexcept {
+    inline namespace SW_ISA_NAMESPACE {
 
-    }
+        template<typename T, size_t LEN>
+        constexpr inline vector<T, LEN>::vector() noexcept : data{} {}
+
+        template<typename T, size_t LEN>
+        constexpr inline vector<T, LEN>::vector(T value) noexcept : data(detail::broadcast_val<T, LEN>(value)) {}
+
+        template<typename T, size_t LEN>
+        constexpr inline vector<T, LEN>::vector(underlying_vector_type value) noexcept : data(value) {}
+
+        template<typename T, size_t LEN>
+        template<typename EXPR, typename>
+        inline vector<T, LEN>::vector(EXPR const& expr) noexcept : data(expr()) {}
+
+        template<typename T, size_t LEN>
+        template<typename EXPR, typename>
+        inline vector<T, LEN>& vector<T, LEN>::operator=(EXPR const& expr) noexcept {
+            data = expr();
+            return *this;
+        }
+
+        template<typename T, size_t LEN>
+        template<typename OP>
+        inline vector<T, LEN>& vector<T, LEN>::operator+=(OP const& operand) noexcept {
+            // through the expression node, so that v += a * b is contracted as well
+            data = (*this + operand)();
+            return *this;
+        }
+
+        template<typename T, size_t LEN>
+        template<typename OP>
+        inline vector<T, LEN>& vector<T, LEN>::operator-=(OP const& operand) noexcept {
+            data = (*this - operand)();
+            return *this;
+        }
+
+        template<typename T, size_t LEN>
+        template<typename OP>
+        inline vector<T, LEN>& vector<T, LEN>::operator*=(OP const& operand) noexcept {
+            data = detail::mul_vals<T, LEN>(data, detail::as_operand<vector>(operand)());
+            return *this;
+        }
+
+        template<typename T, size_t LEN>
+        template<typename OP>
+        inline vector<T, LEN>& vector<T, LEN>::operator/=(OP const& operand) noexcept {
+            data = detail::div_vals<T, LEN>(data, detail::as_operand<vector>(operand)());
+            return *this;
+        }
 
-    template<typename T, size_t LEN>
-    template<typename...Args>
-    inline constexpr vector<T, LEN>::vector(Args...args) noexcept {
-        if constexpr (sizeof...(Args) == 1) {
-            data = detail::broadcast_val(args...);
+        /*
+            Lengths that don't fill the register go through the masked path, so
+            exactly LEN elements are read or written and the padding stays zero.
+        */
+        template<typename T, size_t LEN>
+        inline vector<T, LEN> vector<T, LEN>::load(const T* ptr) noexcept {
+            assert((is_aligned<T, LEN>(ptr)));
+            vector result;
+            if constexpr (simd_traits<T, LEN>::remainder_entries == 0) {
+                result.data = detail::load_vals<T, LEN, true>(ptr);
+            }
+            else {
+                result.data = detail::masked_load_vals<T, LEN>(ptr, LEN);
+            }
+            return result;
         }
-        else {
-            static_assert(sizeof...(Args) == LEN, "Variadic constructor must have values for full length of vector, or single \"fill\" argument!");
+
+        template<typename T, size_t LEN>
+        inline vector<T, LEN> vector<T, LEN>::load_unaligned(const T* ptr) noexcept {
+            return load_partial(ptr, LEN);
+        }
+
+        template<typename T, size_t LEN>
+        inline void vector<T, LEN>::store(T* ptr) const noexcept {
+            assert((is_aligned<T, LEN>(ptr)));
+            if constexpr (simd_traits<T, LEN>::remainder_entries == 0) {
+                detail::store_vals<T, LEN, true>(ptr, data);
+            }
+            else {
+                detail::masked_store_vals<T, LEN>(ptr, data, LEN);
+            }
+        }
+
+        template<typename T, size_t LEN>
+        inline void vector<T, LEN>::store_unaligned(T* ptr) const noexcept {
+            store_partial(ptr, LEN);
+        }
+
+        template<typename T, size_t LEN>
+        inline vector<T, LEN> vector<T, LEN>::load_partial(const T* ptr, size_t count) noexcept {
+            vector result;
+            result.data = detail::masked_load_vals<T, LEN>(ptr, count < LEN ? count : LEN);
+            return result;
         }
+
+        template<typename T, size_t LEN>
+        inline void vector<T, LEN>::store_partial(T* ptr, size_t count) const noexcept {
+            detail::masked_store_vals<T, LEN>(ptr, data, count < LEN ? count : LEN);
+        }
+
+        template<typename T, size_t LEN>
+        inline typename vector<T, LEN>::underlying_vector_type vector<T, LEN>::operator()() const noexcept {
+            return data;
+        }
+
+        template<typename T, size_t LEN>
+        constexpr inline size_t vector<T, LEN>::size() const noexcept {
+            return LEN;
+        }
+
     }
 
 }
@@ -0,0 +1,946 @@
+#pragma once
+#ifndef SIMD_WRAP_VECTOR_FUNCTIONS_HPP
+#define SIMD_WRAP_VECTOR_FUNCTIONS_HPP
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "vector.hpp"
+#include "mask.hpp"
+#include "detail/bitwise_operators.hpp"
+
+namespace sw {
+
+    /*
+        Accuracy of rsqrt, rcp and div. fast is the hardware estimate alone
+        (12 bits, 14 with AVX-512), refined adds Newton-Raphson steps to get
+        within 3 ulp (2 for div), exact uses sqrt and div. Denormal inputs
+        count as zero for fast and refined, and below AVX-512 so do denormal
+        results of the float estimate: rcp of |x| > 2^126 gives 0, and so
+        does div by such an x, whatever the dividend. Use exact where the
+        divisors can get that large.
+    */
+    enum class precision {
+        fast,
+        refined,
+        exact
+    };
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            struct add_reduction {
+                template<typename T, size_t LEN>
+                static vector_type_t<T, LEN> combine(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                    return add_vals<T, LEN>(a, b);
+                }
+                template<typename T>
+                static constexpr T identity() noexcept {
+                    return T(0);
+                }
+            };
+
+            struct min_reduction {
+                template<typename T, size_t LEN>
+                static vector_type_t<T, LEN> combine(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                    return min_vals<T, LEN>(a, b);
+                }
+                template<typename T>
+                static constexpr T identity() noexcept {
+                    if constexpr (std::is_floating_point_v<T>) {
+                        return std::numeric_limits<T>::infinity();
+                    }
+                    else {
+                        return std::numeric_limits<T>::max();
+                    }
+                }
+            };
+
+            struct max_reduction {
+                template<typename T, size_t LEN>
+                static vector_type_t<T, LEN> combine(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                    return max_vals<T, LEN>(a, b);
+                }
+                template<typename T>
+                static constexpr T identity() noexcept {
+                    if constexpr (std::is_floating_point_v<T>) {
+                        return -std::numeric_limits<T>::infinity();
+                    }
+                    else {
+                        return std::numeric_limits<T>::lowest();
+                    }
+                }
+            };
+
+            struct mul_reduction {
+                template<typename T, size_t LEN>
+                static vector_type_t<T, LEN> combine(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                    return mul_vals<T, LEN>(a, b);
+                }
+                template<typename T>
+                static constexpr T identity() noexcept {
+                    return T(1);
+                }
+            };
+
+            // folds a 128 bit register down to its first lane with shuffles, no hadd
+            template<typename T, typename Reduction, typename Register>
+            T reduce_register_128(Register v) noexcept {
+                constexpr size_t lanes = 16 / sizeof(T);
+                if constexpr (USE_GENERIC_VECTORS) {
+                    // the same halving, the upper half moved down lane by lane
+                    for (size_t width = lanes / 2; width > 0; width /= 2) {
+                        Register upper = v;
+                        for (size_t i = 0; i < width; ++i) {
+                            upper[i] = v[i + width];
+                        }
+                        v = Reduction::template combine<T, lanes>(v, upper);
+                    }
+                    return static_cast<T>(v[0]);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<Register, __m128>) {
+                    v = Reduction::template combine<T, lanes>(v, _mm_movehl_ps(v, v));
+                    v = Reduction::template combine<T, lanes>(v, _mm_movehdup_ps(v));
+                    return _mm_cvtss_f32(v);
+                }
+                else if constexpr (std::is_same_v<Register, __m128d>) {
+                    v = Reduction::template combine<T, lanes>(v, _mm_unpackhi_pd(v, v));
+                    return _mm_cvtsd_f64(v);
+                }
+                else {
+                    v = Reduction::template combine<T, lanes>(v, _mm_srli_si128(v, 8));
+                    if constexpr (sizeof(T) <= 4) {
+                        v = Reduction::template combine<T, lanes>(v, _mm_srli_si128(v, 4));
+                    }
+                    if constexpr (sizeof(T) <= 2) {
+                        v = Reduction::template combine<T, lanes>(v, _mm_srli_si128(v, 2));
+                    }
+                    if constexpr (sizeof(T) == 1) {
+                        v = Reduction::template combine<T, lanes>(v, _mm_srli_si128(v, 1));
+                    }
+                    if constexpr (sizeof(T) == 8) {
+                        return static_cast<T>(_mm_cvtsi128_si64(v));
+                    }
+                    else {
+                        return static_cast<T>(_mm_cvtsi128_si32(v));
+                    }
+                }
+#endif
+            }
+
+            /*
+                Horizontal reduction of a whole register: wide registers are halved
+                until 128 bits remain. Integer registers are cut into 128 bit pieces
+                directly, as vector_type_t doesn't map every 256 bit integer length.
+            */
+            template<typename T, typename Reduction, typename Register>
+            T reduce_register(Register v) noexcept {
+                if constexpr (sizeof(Register) == 16) {
+                    return reduce_register_128<T, Reduction>(v);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<Register, __m256>) {
+                    return reduce_register_128<T, Reduction>(Reduction::template combine<T, 4>(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+                }
+                else if constexpr (std::is_same_v<Register, __m256d>) {
+                    return reduce_register_128<T, Reduction>(Reduction::template combine<T, 2>(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+                }
+                else if constexpr (std::is_same_v<Register, __m512>) {
+                    const __m256 lo = _mm512_castps512_ps256(v);
+                    const __m256 hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1));
+                    return reduce_register<T, Reduction>(Reduction::template combine<T, 8>(lo, hi));
+                }
+                else if constexpr (std::is_same_v<Register, __m512d>) {
+                    return reduce_register<T, Reduction>(Reduction::template combine<T, 4>(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1)));
+                }
+                else if constexpr (std::is_same_v<Register, __m256i>) {
+                    constexpr size_t lanes = 16 / sizeof(T);
+                    return reduce_register_128<T, Reduction>(Reduction::template combine<T, lanes>(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+                }
+                else {
+                    constexpr size_t lanes = 16 / sizeof(T);
+                    __m128i folded = Reduction::template combine<T, lanes>(_mm512_castsi512_si128(v), _mm512_extracti32x4_epi32(v, 1));
+                    folded = Reduction::template combine<T, lanes>(folded, _mm512_extracti32x4_epi32(v, 2));
+                    folded = Reduction::template combine<T, lanes>(folded, _mm512_extracti32x4_epi32(v, 3));
+                    return reduce_register_128<T, Reduction>(folded);
+                }
+#endif
+            }
+
+            // lanes past LEN get the identity of the reduction first, so odd lengths come out right
+            template<typename Reduction, typename EXPR>
+            typename EXPR::value_type reduce_expression(EXPR const& expr) noexcept {
+                using value_type = typename EXPR::value_type;
+                constexpr size_t length = EXPR::length;
+                return reduce_register<value_type, Reduction>(fill_padding<value_type, length>(expr(), Reduction::template identity<value_type>()));
+            }
+
+            /*
+                Math functions. Everything below runs on whole registers, with the
+                usual scheme: reduce the argument to a small interval exactly or
+                close to it (Cody-Waite splits of ln2 and pi/2), evaluate a short
+                polynomial there, then undo the reduction through the exponent
+                bits. Polynomials are the Cephes ones unless noted otherwise.
+            */
+            template<typename T>
+            struct float_layout;
+
+            template<>
+            struct float_layout<float> {
+                constexpr static int mantissa_bits = 23;
+                // adding it rounds to an integer that lands in the low mantissa bits
+                constexpr static float round_magic = 12582912.0f;
+                constexpr static float min_normal = 1.17549435e-38f;
+            };
+
+            template<>
+            struct float_layout<double> {
+                constexpr static int mantissa_bits = 52;
+                constexpr static double round_magic = 6755399441055744.0;
+                constexpr static double min_normal = 2.2250738585072014e-308;
+            };
+
+            // 2^k for integral k in the normal exponent range, built straight from the bits
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> pow2_int_vals(vector_type_t<T, LEN> k) noexcept {
+                constexpr int mantissa_bits = float_layout<T>::mantissa_bits;
+                const auto biased = as_int_bits<T, LEN>(add_vals<T, LEN>(k, broadcast_val<T, LEN>(float_layout<T>::round_magic)));
+                // the magic's own bits shift out, leaving k << mantissa_bits
+                const auto shifted = int_lanes_shift_left<mantissa_bits, T>(biased);
+                return from_int_bits<T, LEN>(int_lanes_add<T>(shifted, as_int_bits<T, LEN>(broadcast_val<T, LEN>(T(1)))));
+            }
+
+            // p * 2^n in two steps, so results that overflow or go subnormal still round once
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> scale_pow2_vals(vector_type_t<T, LEN> p, vector_type_t<T, LEN> n) noexcept {
+                const vector_type_t<T, LEN> n0 = round_vals<T, LEN>(mul_vals<T, LEN>(n, broadcast_val<T, LEN>(T(0.5))));
+                const vector_type_t<T, LEN> n1 = sub_vals<T, LEN>(n, n0);
+                return mul_vals<T, LEN>(mul_vals<T, LEN>(p, pow2_int_vals<T, LEN>(n0)), pow2_int_vals<T, LEN>(n1));
+            }
+
+            // exp(r) for |r| <= ln2 / 2
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> exp_reduced_vals(vector_type_t<T, LEN> r) noexcept {
+                const vector_type_t<T, LEN> one = broadcast_val<T, LEN>(T(1));
+                if constexpr (std::is_same_v<T, float>) {
+                    const vector_type_t<T, LEN> p = polynomial_vals<T, LEN>(r, 1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                        4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f);
+                    return add_vals<T, LEN>(mul_add_vals<T, LEN>(p, mul_vals<T, LEN>(r, r), r), one);
+                }
+                else {
+                    // Taylor series to r^13, the truncation error stays below 0.02 ulp
+                    const vector_type_t<T, LEN> p = polynomial_vals<T, LEN>(r, 1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0,
+                        1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5);
+                    return add_vals<T, LEN>(mul_add_vals<T, LEN>(p, mul_vals<T, LEN>(r, r), r), one);
+                }
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> exp_vals(vector_type_t<T, LEN> x) noexcept {
+                // past these the result is inf or 0 anyway, clamping keeps n in range. NaN passes through
+                const T hi = std::is_same_v<T, float> ? T(89.0) : T(710.0);
+                const T lo = std::is_same_v<T, float> ? T(-104.0) : T(-746.0);
+                // ln2 split so that n * ln2_hi is exact
+                const T ln2_hi = std::is_same_v<T, float> ? T(0.693359375) : T(6.93145751953125e-1);
+                const T ln2_lo = std::is_same_v<T, float> ? T(-2.12194440e-4) : T(1.42860682030941723212e-6);
+                x = max_vals<T, LEN>(broadcast_val<T, LEN>(lo), min_vals<T, LEN>(broadcast_val<T, LEN>(hi), x));
+                const vector_type_t<T, LEN> n = round_vals<T, LEN>(mul_vals<T, LEN>(x, broadcast_val<T, LEN>(T(1.44269504088896340736))));
+                vector_type_t<T, LEN> r = neg_mul_add_vals<T, LEN>(n, broadcast_val<T, LEN>(ln2_hi), x);
+                r = neg_mul_add_vals<T, LEN>(n, broadcast_val<T, LEN>(ln2_lo), r);
+                return scale_pow2_vals<T, LEN>(exp_reduced_vals<T, LEN>(r), n);
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> exp2_vals(vector_type_t<T, LEN> x) noexcept {
+                const T hi = std::is_same_v<T, float> ? T(129.0) : T(1025.0);
+                const T lo = std::is_same_v<T, float> ? T(-151.0) : T(-1076.0);
+                x = max_vals<T, LEN>(broadcast_val<T, LEN>(lo), min_vals<T, LEN>(broadcast_val<T, LEN>(hi), x));
+                const vector_type_t<T, LEN> n = round_vals<T, LEN>(x);
+                // x - n is exact, only scaling it by ln2 rounds
+                const vector_type_t<T, LEN> r = mul_vals<T, LEN>(sub_vals<T, LEN>(x, n), broadcast_val<T, LEN>(T(0.693147180559945309417)));
+                return scale_pow2_vals<T, LEN>(exp_reduced_vals<T, LEN>(r), n);
+            }
+
+            /*
+                Splits positive x into 2^e * m with m in [sqrt(0.5), sqrt(2)) and
+                returns log(m) through the atanh series in s = (m - 1) / (m + 1),
+                which only needs the reciprocal odd numbers as coefficients.
+            */
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> log_reduced_vals(vector_type_t<T, LEN> x, vector_type_t<T, LEN>& e) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                constexpr int mantissa_bits = float_layout<T>::mantissa_bits;
+                const vector_type one = broadcast_val<T, LEN>(T(1));
+                const vector_type magic = broadcast_val<T, LEN>(float_layout<T>::round_magic);
+
+                // subnormals are scaled into the normal range first
+                const auto subnormal = compare_vals<T, LEN, compare_op::lt>(x, broadcast_val<T, LEN>(float_layout<T>::min_normal));
+                x = select_vals<T, LEN>(subnormal, mul_vals<T, LEN>(x, broadcast_val<T, LEN>(T(uint64_t(1) << mantissa_bits))), x);
+                const vector_type bias = select_vals<T, LEN>(subnormal, broadcast_val<T, LEN>(std::is_same_v<T, float> ? T(126 + 23) : T(1022 + 52)),
+                    broadcast_val<T, LEN>(std::is_same_v<T, float> ? T(126) : T(1022)));
+
+                // exponent field into the mantissa of the magic number, which converts it exactly
+                const auto exponent_bits = int_lanes_shift_right<mantissa_bits, T>(as_int_bits<T, LEN>(x));
+                e = sub_vals<T, LEN>(from_int_bits<T, LEN>(int_lanes_add<T>(exponent_bits, as_int_bits<T, LEN>(magic))), magic);
+                e = sub_vals<T, LEN>(e, bias);
+                // mantissa bits under the exponent of 0.5, m in [0.5, 1)
+                vector_type m = or_vals<T, LEN>(andnot_vals<T, LEN>(broadcast_val<T, LEN>(-std::numeric_limits<T>::infinity()), x), broadcast_val<T, LEN>(T(0.5)));
+                const auto small = compare_vals<T, LEN, compare_op::lt>(m, broadcast_val<T, LEN>(T(0.70710678118654752440)));
+                m = select_vals<T, LEN>(small, add_vals<T, LEN>(m, m), m);
+                e = select_vals<T, LEN>(small, sub_vals<T, LEN>(e, one), e);
+
+                const vector_type f = sub_vals<T, LEN>(m, one);
+                const vector_type s = div_vals<T, LEN>(f, add_vals<T, LEN>(m, one));
+                const vector_type z = mul_vals<T, LEN>(s, s);
+                vector_type p;
+                if constexpr (std::is_same_v<T, float>) {
+                    p = polynomial_vals<T, LEN>(z, 1.0f / 9.0f, 1.0f / 7.0f, 1.0f / 5.0f, 1.0f / 3.0f);
+                }
+                else {
+                    p = polynomial_vals<T, LEN>(z, 1.0 / 21.0, 1.0 / 19.0, 1.0 / 17.0, 1.0 / 15.0, 1.0 / 13.0, 1.0 / 11.0, 1.0 / 9.0,
+                        1.0 / 7.0, 1.0 / 5.0, 1.0 / 3.0);
+                }
+                // 2s (1 + z p) rewritten as f - s (f - 2 z p): the exact f leads, the rounding of s only touches the correction
+                const vector_type two_z = add_vals<T, LEN>(z, z);
+                return neg_mul_add_vals<T, LEN>(s, neg_mul_add_vals<T, LEN>(two_z, p, f), f);
+            }
+
+            // log(0) = -inf, log(inf) = inf, negative and NaN give NaN
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> log_special_vals(vector_type_t<T, LEN> x, vector_type_t<T, LEN> result) noexcept {
+                constexpr T inf = std::numeric_limits<T>::infinity();
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(x, broadcast_val<T, LEN>(inf)), x, result);
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(x, broadcast_val<T, LEN>(T(0))), broadcast_val<T, LEN>(-inf), result);
+                return select_vals<T, LEN>(compare_vals<T, LEN, compare_op::ge>(x, broadcast_val<T, LEN>(T(0))), result,
+                    broadcast_val<T, LEN>(std::numeric_limits<T>::quiet_NaN()));
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> log_vals(vector_type_t<T, LEN> x) noexcept {
+                const T ln2_hi = std::is_same_v<T, float> ? T(0.693359375) : T(6.93147180369123816490e-01);
+                const T ln2_lo = std::is_same_v<T, float> ? T(-2.12194440e-4) : T(1.90821492927058770002e-10);
+                vector_type_t<T, LEN> e;
+                const vector_type_t<T, LEN> log_m = log_reduced_vals<T, LEN>(x, e);
+                const vector_type_t<T, LEN> result = mul_add_vals<T, LEN>(e, broadcast_val<T, LEN>(ln2_hi),
+                    mul_add_vals<T, LEN>(e, broadcast_val<T, LEN>(ln2_lo), log_m));
+                return log_special_vals<T, LEN>(x, result);
+            }
+
+            // exact for powers of two
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> log2_vals(vector_type_t<T, LEN> x) noexcept {
+                vector_type_t<T, LEN> e;
+                const vector_type_t<T, LEN> log_m = log_reduced_vals<T, LEN>(x, e);
+                const vector_type_t<T, LEN> result = mul_add_vals<T, LEN>(log_m, broadcast_val<T, LEN>(T(1.44269504088896340736)), e);
+                return log_special_vals<T, LEN>(x, result);
+            }
+
+            /*
+                sin and cos of |x| - j * pi/2 with |r| <= pi/4, pi/2 split in three
+                so j * pi/2 stays exact enough for |x| up to 8192 (float) and 2^24
+                (double). The quadrant j & 3 picks the polynomial and the sign: its
+                bits come out of the magic number used to round j. Larger lanes are
+                left to trig_large_vals.
+            */
+            template<typename T, size_t LEN>
+            struct trig_reduction {
+                vector_type_t<T, LEN> sin_r;
+                vector_type_t<T, LEN> cos_r;
+                // j + the rounding magic, j & 3 in the low bits
+                vector_type_t<T, LEN> quadrant;
+            };
+
+            template<typename T, size_t LEN>
+            trig_reduction<T, LEN> trig_reduce_vals(vector_type_t<T, LEN> x) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                const vector_type ax = abs_vals<T, LEN>(x);
+                const vector_type j = round_vals<T, LEN>(mul_vals<T, LEN>(ax, broadcast_val<T, LEN>(T(0.636619772367581343076))));
+                vector_type r;
+                if constexpr (std::is_same_v<T, float>) {
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(1.5703125f), ax);
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(4.837512969970703125e-4f), r);
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(7.54978995489188216e-8f), r);
+                }
+                else {
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(1.57079625129699707031e0), ax);
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(7.54978941586159635335e-8), r);
+                    r = neg_mul_add_vals<T, LEN>(j, broadcast_val<T, LEN>(5.39030285815811905290e-15), r);
+                }
+                const vector_type z = mul_vals<T, LEN>(r, r);
+                const vector_type half_z = mul_vals<T, LEN>(z, broadcast_val<T, LEN>(T(0.5)));
+                vector_type sin_p, cos_p;
+                if constexpr (std::is_same_v<T, float>) {
+                    sin_p = polynomial_vals<T, LEN>(z, -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f);
+                    cos_p = polynomial_vals<T, LEN>(z, 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f);
+                }
+                else {
+                    sin_p = polynomial_vals<T, LEN>(z, 1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+                        -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1);
+                    cos_p = polynomial_vals<T, LEN>(z, -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+                        2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2);
+                }
+                trig_reduction<T, LEN> result;
+                result.sin_r = mul_add_vals<T, LEN>(mul_vals<T, LEN>(r, z), sin_p, r);
+                result.cos_r = mul_add_vals<T, LEN>(mul_vals<T, LEN>(z, z), cos_p, sub_vals<T, LEN>(broadcast_val<T, LEN>(T(1)), half_z));
+                result.quadrant = add_vals<T, LEN>(j, broadcast_val<T, LEN>(float_layout<T>::round_magic));
+                return result;
+            }
+
+            // largest |x| trig_reduce_vals keeps accurate
+            template<typename T>
+            constexpr T trig_reduction_limit = std::is_same_v<T, float> ? T(8192) : T(16777216);
+
+            /*
+                Lanes of x past the reduction limit get their result from the C
+                library instead, which reduces exactly (Payne-Hanek). Those are
+                rare, the common case only pays for a compare.
+            */
+            template<typename T, size_t LEN, typename SCALAR>
+            vector_type_t<T, LEN> trig_large_vals(vector_type_t<T, LEN> x, vector_type_t<T, LEN> result, SCALAR scalar) noexcept {
+                const auto large = compare_vals<T, LEN, compare_op::gt>(abs_vals<T, LEN>(x), broadcast_val<T, LEN>(trig_reduction_limit<T>));
+                const uint64_t bits = mask_bits_vals<T, LEN>(large);
+                if (bits == 0) {
+                    return result;
+                }
+                constexpr size_t lanes = simd_traits<T, LEN>::num_entries;
+                T args[lanes];
+                T values[lanes];
+                store_vals<T, LEN>(args, x);
+                store_vals<T, LEN>(values, result);
+                for (size_t i = 0; i < LEN; ++i) {
+                    if ((bits >> i) & 1) {
+                        values[i] = scalar(args[i]);
+                    }
+                }
+                return load_vals<T, LEN>(values);
+            }
+
+            // bit of the quadrant moved up into the sign bit
+            template<int BIT, typename T, size_t LEN>
+            vector_type_t<T, LEN> quadrant_sign_vals(vector_type_t<T, LEN> quadrant) noexcept {
+                constexpr int sign_bit = int(sizeof(T) * 8 - 1);
+                return sign_vals<T, LEN>(from_int_bits<T, LEN>(int_lanes_shift_left<sign_bit - BIT, T>(as_int_bits<T, LEN>(quadrant))));
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> sin_vals(vector_type_t<T, LEN> x) noexcept {
+                const trig_reduction<T, LEN> t = trig_reduce_vals<T, LEN>(x);
+                const auto odd = sign_bit_mask<T, LEN>(quadrant_sign_vals<0, T, LEN>(t.quadrant));
+                const vector_type_t<T, LEN> sign = xor_vals<T, LEN>(quadrant_sign_vals<1, T, LEN>(t.quadrant), sign_vals<T, LEN>(x));
+                const vector_type_t<T, LEN> result = xor_vals<T, LEN>(select_vals<T, LEN>(odd, t.cos_r, t.sin_r), sign);
+                return trig_large_vals<T, LEN>(x, result, [](T a) { return std::sin(a); });
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> cos_vals(vector_type_t<T, LEN> x) noexcept {
+                const trig_reduction<T, LEN> t = trig_reduce_vals<T, LEN>(x);
+                const auto odd = sign_bit_mask<T, LEN>(quadrant_sign_vals<0, T, LEN>(t.quadrant));
+                // cos(r + j * pi/2) is negative for j & 3 in { 1, 2 }, bit 1 of j + 1
+                const vector_type_t<T, LEN> next = add_vals<T, LEN>(t.quadrant, broadcast_val<T, LEN>(T(1)));
+                const vector_type_t<T, LEN> result = xor_vals<T, LEN>(select_vals<T, LEN>(odd, t.sin_r, t.cos_r), quadrant_sign_vals<1, T, LEN>(next));
+                return trig_large_vals<T, LEN>(x, result, [](T a) { return std::cos(a); });
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> tan_vals(vector_type_t<T, LEN> x) noexcept {
+                const trig_reduction<T, LEN> t = trig_reduce_vals<T, LEN>(x);
+                // odd quadrants give -cos(r) / sin(r)
+                const vector_type_t<T, LEN> odd_sign = quadrant_sign_vals<0, T, LEN>(t.quadrant);
+                const auto odd = sign_bit_mask<T, LEN>(odd_sign);
+                const vector_type_t<T, LEN> ratio = div_vals<T, LEN>(select_vals<T, LEN>(odd, t.cos_r, t.sin_r), select_vals<T, LEN>(odd, t.sin_r, t.cos_r));
+                const vector_type_t<T, LEN> result = xor_vals<T, LEN>(ratio, xor_vals<T, LEN>(odd_sign, sign_vals<T, LEN>(x)));
+                return trig_large_vals<T, LEN>(x, result, [](T a) { return std::tan(a); });
+            }
+
+            // atan(a) for a in [0, 1]
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> atan_unit_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                const vector_type one = broadcast_val<T, LEN>(T(1));
+                // above the split atan(a) = pi/4 + atan((a - 1) / (a + 1))
+                const T split = std::is_same_v<T, float> ? T(0.414213562373095) : T(0.66);
+                const auto upper = compare_vals<T, LEN, compare_op::gt>(a, broadcast_val<T, LEN>(split));
+                a = select_vals<T, LEN>(upper, div_vals<T, LEN>(sub_vals<T, LEN>(a, one), add_vals<T, LEN>(a, one)), a);
+                const vector_type offset = select_vals<T, LEN>(upper, broadcast_val<T, LEN>(T(0.785398163397448309616)), vector_type{});
+                const vector_type z = mul_vals<T, LEN>(a, a);
+                vector_type p;
+                if constexpr (std::is_same_v<T, float>) {
+                    p = polynomial_vals<T, LEN>(z, 8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f, -3.33329491539e-1f);
+                }
+                else {
+                    p = div_vals<T, LEN>(polynomial_vals<T, LEN>(z, -8.750608600031904122785e-1, -1.615753718733365076637e1,
+                            -7.500855792314704667340e1, -1.228866684490136173410e2, -6.485021904942025371773e1),
+                        polynomial_vals<T, LEN>(z, 1.0, 2.485846490142306297962e1, 1.650270098316988542046e2, 4.328810604912902668951e2,
+                            4.853903996359136964868e2, 1.945506571482613964425e2));
+                }
+                return add_vals<T, LEN>(mul_add_vals<T, LEN>(mul_vals<T, LEN>(a, z), p, a), offset);
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> atan2_vals(vector_type_t<T, LEN> y, vector_type_t<T, LEN> x) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                const vector_type ax = abs_vals<T, LEN>(x);
+                const vector_type ay = abs_vals<T, LEN>(y);
+                const vector_type lower = min_vals<T, LEN>(ax, ay);
+                const vector_type upper = max_vals<T, LEN>(ax, ay);
+                // 0 / 0 gives 0 and inf / inf gives 1, as atan2 of the signed zeros and infinities expects
+                vector_type a = div_vals<T, LEN>(lower, upper);
+                a = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(lower, upper), broadcast_val<T, LEN>(T(1)), a);
+                a = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(upper, vector_type{}), vector_type{}, a);
+                vector_type result = atan_unit_vals<T, LEN>(a);
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::gt>(ay, ax),
+                    sub_vals<T, LEN>(broadcast_val<T, LEN>(T(1.57079632679489661923)), result), result);
+                result = select_vals<T, LEN>(sign_bit_mask<T, LEN>(x), sub_vals<T, LEN>(broadcast_val<T, LEN>(T(3.14159265358979323846)), result), result);
+                result = or_vals<T, LEN>(result, sign_vals<T, LEN>(y));
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::neq>(x, x), x, result);
+                return select_vals<T, LEN>(compare_vals<T, LEN, compare_op::neq>(y, y), y, result);
+            }
+
+            // exp2(y * log2(x)) for x >= 0, without the special cases
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> pow_core_vals(vector_type_t<T, LEN> x, vector_type_t<T, LEN> y) noexcept {
+                return exp2_vals<T, LEN>(mul_vals<T, LEN>(y, log2_vals<T, LEN>(x)));
+            }
+
+            /*
+                float pow runs its core in double precision: the error of log2(x)
+                gets multiplied by y, which single precision can't absorb.
+            */
+            template<size_t LEN>
+            vector_type_t<float, LEN> pow_core_widened_vals(vector_type_t<float, LEN> x, vector_type_t<float, LEN> y) noexcept {
+                using vector_type = vector_type_t<float, LEN>;
+                constexpr size_t half = sizeof(vector_type) / sizeof(double);
+                if constexpr (USE_GENERIC_VECTORS) {
+                    using wide_type = vector_type_t<double, half>;
+                    const wide_type lo = pow_core_vals<double, half>(wide_type{ x[0], x[1] }, wide_type{ y[0], y[1] });
+                    const wide_type hi = pow_core_vals<double, half>(wide_type{ x[2], x[3] }, wide_type{ y[2], y[3] });
+                    return vector_type{ float(lo[0]), float(lo[1]), float(hi[0]), float(hi[1]) };
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    const __m128d lo = pow_core_vals<double, half>(_mm_cvtps_pd(x), _mm_cvtps_pd(y));
+                    const __m128d hi = pow_core_vals<double, half>(_mm_cvtps_pd(_mm_movehl_ps(x, x)), _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+                    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    const __m256d lo = pow_core_vals<double, half>(_mm256_cvtps_pd(_mm256_castps256_ps128(x)), _mm256_cvtps_pd(_mm256_castps256_ps128(y)));
+                    const __m256d hi = pow_core_vals<double, half>(_mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)), _mm256_cvtps_pd(_mm256_extractf128_ps(y, 1)));
+                    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+                }
+                else {
+                    const __m512d lo = pow_core_vals<double, half>(_mm512_cvtps_pd(_mm512_castps512_ps256(x)), _mm512_cvtps_pd(_mm512_castps512_ps256(y)));
+                    const __m512d hi = pow_core_vals<double, half>(_mm512_cvtps_pd(_mm512_extractf32x8_ps(x, 1)), _mm512_cvtps_pd(_mm512_extractf32x8_ps(y, 1)));
+                    return _mm512_insertf32x8(_mm512_castps256_ps512(_mm512_cvtpd_ps(lo)), _mm512_cvtpd_ps(hi), 1);
+                }
+#endif
+            }
+
+            // IEEE pow special cases on top of the core, which only sees |x|
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> pow_vals(vector_type_t<T, LEN> x, vector_type_t<T, LEN> y) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                const vector_type one = broadcast_val<T, LEN>(T(1));
+                const vector_type inf = broadcast_val<T, LEN>(std::numeric_limits<T>::infinity());
+                const vector_type ax = abs_vals<T, LEN>(x);
+                vector_type result;
+                if constexpr (std::is_same_v<T, float>) {
+                    result = pow_core_widened_vals<LEN>(ax, y);
+                }
+                else {
+                    result = pow_core_vals<T, LEN>(ax, y);
+                }
+                // negative x: odd integral y flips the sign, non integral y has no real result
+                const auto integral = compare_vals<T, LEN, compare_op::eq>(round_vals<T, LEN>(y), y);
+                const vector_type half_y = mul_vals<T, LEN>(y, broadcast_val<T, LEN>(T(0.5)));
+                const auto even = compare_vals<T, LEN, compare_op::eq>(round_vals<T, LEN>(half_y), half_y);
+                const vector_type negated = select_vals<T, LEN>(even, result, xor_vals<T, LEN>(result, broadcast_val<T, LEN>(T(-0.0))));
+                // except for zero and infinity, where only the sign of an odd power survives
+                const vector_type no_result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(ax, vector_type{}), result,
+                    select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(ax, inf), result, broadcast_val<T, LEN>(std::numeric_limits<T>::quiet_NaN())));
+                result = select_vals<T, LEN>(sign_bit_mask<T, LEN>(x), select_vals<T, LEN>(integral, negated, no_result), result);
+                // NaN x keeps its NaN, pow(1, y) and pow(-1, +-inf) are 1, pow(x, 0) is 1
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::neq>(x, x), x, result);
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(x, one), one, result);
+                result = select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(ax, one),
+                    select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(abs_vals<T, LEN>(y), inf), one, result), result);
+                return select_vals<T, LEN>(compare_vals<T, LEN, compare_op::eq>(y, vector_type{}), one, result);
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> sqrt_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    for (size_t i = 0; i < simd_traits<T, LEN>::num_entries; ++i) {
+                        a[i] = std::sqrt(a[i]);
+                    }
+                    return a;
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_sqrt_ps(a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                    return _mm_sqrt_pd(a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256>) {
+                    return _mm256_sqrt_ps(a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                    return _mm256_sqrt_pd(a);
+                }
+                else if constexpr (std::is_same_v<vector_type, __m512>) {
+                    return _mm512_sqrt_ps(a);
+                }
+                else {
+                    return _mm512_sqrt_pd(a);
+                }
+#endif
+            }
+
+            // double only gets estimate instructions with AVX-512, below that fast and refined are exact.
+            // The generic backend has none at all
+            template<typename T>
+            constexpr bool has_estimate = (std::is_same_v<T, float> && !USE_GENERIC_VECTORS) || USE_AVX512_INTRINSICS;
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> rcp_estimate_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return div_vals<T, LEN>(broadcast_val<T, LEN>(T(1)), a);
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_rcp14_ps(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_rcp14_pd(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_rcp14_ps(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_rcp14_pd(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_rcp14_ps(a);
+                    }
+                    else {
+                        return _mm512_rcp14_pd(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_rcp_ps(a);
+                }
+                else {
+                    return _mm256_rcp_ps(a);
+                }
+#endif
+            }
+
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> rsqrt_estimate_vals(vector_type_t<T, LEN> a) noexcept {
+                using vector_type = vector_type_t<T, LEN>;
+                if constexpr (USE_GENERIC_VECTORS) {
+                    return div_vals<T, LEN>(broadcast_val<T, LEN>(T(1)), sqrt_vals<T, LEN>(a));
+                }
+#if !defined(SW_GENERIC_VECTORS)
+                else if constexpr (USE_AVX512_INTRINSICS) {
+                    if constexpr (std::is_same_v<vector_type, __m128>) {
+                        return _mm_rsqrt14_ps(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m128d>) {
+                        return _mm_rsqrt14_pd(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256>) {
+                        return _mm256_rsqrt14_ps(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m256d>) {
+                        return _mm256_rsqrt14_pd(a);
+                    }
+                    else if constexpr (std::is_same_v<vector_type, __m512>) {
+                        return _mm512_rsqrt14_ps(a);
+                    }
+                    else {
+                        return _mm512_rsqrt14_pd(a);
+                    }
+                }
+                else if constexpr (std::is_same_v<vector_type, __m128>) {
+                    return _mm_rsqrt_ps(a);
+                }
+                else {
+                    return _mm256_rsqrt_ps(a);
+                }
+#endif
+            }
+
+            // each Newton step doubles the correct bits: one for float, two for double from 14 bits
+            template<typename T>
+            constexpr int newton_steps = std::is_same_v<T, float> ? 1 : 2;
+
+            // 0, inf and NaN turn into NaN inside a Newton step, those keep the estimate
+            template<typename T, size_t LEN>
+            vector_type_t<T, LEN> keep_estimate_vals(vector_type_t<T, LEN> estimate, vector_type_t<T, LEN> refined) noexcept {
+                return select_vals<T, LEN>(compare_vals<T, LEN, compare_op::neq>(refined, refined), estimate, refined);
+            }
+
+            template<precision P, typename T, size_t LEN>
+            vector_type_t<T, LEN> rcp_vals(vector_type_t<T, LEN> a) noexcept {
+                if constexpr (P == precision::exact || !has_estimate<T>) {
+                    return div_vals<T, LEN>(broadcast_val<T, LEN>(T(1)), a);
+                }
+                else if constexpr (P == precision::fast) {
+                    return rcp_estimate_vals<T, LEN>(a);
+                }
+                else {
+                    const vector_type_t<T, LEN> one = broadcast_val<T, LEN>(T(1));
+                    const vector_type_t<T, LEN> estimate = rcp_estimate_vals<T, LEN>(a);
+                    vector_type_t<T, LEN> x = estimate;
+                    for (int i = 0; i < newton_steps<T>; ++i) {
+                        // x + x (1 - a x)
+                        x = mul_add_vals<T, LEN>(x, neg_mul_add_vals<T, LEN>(a, x, one), x);
+                    }
+                    return keep_estimate_vals<T, LEN>(estimate, x);
+                }
+            }
+
+            template<precision P, typename T, size_t LEN>
+            vector_type_t<T, LEN> rsqrt_vals(vector_type_t<T, LEN> a) noexcept {
+                if constexpr (P == precision::exact || !has_estimate<T>) {
+                    return div_vals<T, LEN>(broadcast_val<T, LEN>(T(1)), sqrt_vals<T, LEN>(a));
+                }
+                else if constexpr (P == precision::fast) {
+                    return rsqrt_estimate_vals<T, LEN>(a);
+                }
+                else {
+                    const vector_type_t<T, LEN> one = broadcast_val<T, LEN>(T(1));
+                    const vector_type_t<T, LEN> half = broadcast_val<T, LEN>(T(0.5));
+                    const vector_type_t<T, LEN> estimate = rsqrt_estimate_vals<T, LEN>(a);
+                    vector_type_t<T, LEN> y = estimate;
+                    for (int i = 0; i < newton_steps<T>; ++i) {
+                        // y + y / 2 (1 - a y^2)
+                        const vector_type_t<T, LEN> residual = neg_mul_add_vals<T, LEN>(mul_vals<T, LEN>(a, y), y, one);
+                        y = mul_add_vals<T, LEN>(mul_vals<T, LEN>(y, half), residual, y);
+                    }
+                    return keep_estimate_vals<T, LEN>(estimate, y);
+                }
+            }
+
+            template<precision P, typename T, size_t LEN>
+            vector_type_t<T, LEN> div_precision_vals(vector_type_t<T, LEN> a, vector_type_t<T, LEN> b) noexcept {
+                if constexpr (P == precision::exact || !has_estimate<T>) {
+                    return div_vals<T, LEN>(a, b);
+                }
+                else if constexpr (P == precision::fast) {
+                    return mul_vals<T, LEN>(a, rcp_estimate_vals<T, LEN>(b));
+                }
+                else {
+                    // one more correction on the quotient itself, using its residual a - b q
+                    const vector_type_t<T, LEN> r = rcp_vals<precision::refined, T, LEN>(b);
+                    const vector_type_t<T, LEN> q = mul_vals<T, LEN>(a, r);
+                    return keep_estimate_vals<T, LEN>(q, mul_add_vals<T, LEN>(r, neg_mul_add_vals<T, LEN>(b, q, a), q));
+                }
+            }
+
+            template<typename EXPR>
+            using math_result_t = vector<typename EXPR::value_type, EXPR::length>;
+
+        }
+
+        // Sum of the LEN lanes of a vector or expression
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        typename EXPR::value_type reduce_add(EXPR const& expr) noexcept {
+            return detail::reduce_expression<detail::add_reduction>(expr);
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        typename EXPR::value_type reduce_min(EXPR const& expr) noexcept {
+            return detail::reduce_expression<detail::min_reduction>(expr);
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        typename EXPR::value_type reduce_max(EXPR const& expr) noexcept {
+            return detail::reduce_expression<detail::max_reduction>(expr);
+        }
+
+        // Product of the LEN lanes of a vector or expression
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        typename EXPR::value_type reduce_mul(EXPR const& expr) noexcept {
+            static_assert(std::is_floating_point_v<typename EXPR::value_type>, "reduce_mul is currently only implemented for floating point vectors.");
+            return detail::reduce_expression<detail::mul_reduction>(expr);
+        }
+
+        // Lane-wise min and max, for floats the second operand wins if either lane is NaN
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> min(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "min arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::min_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        template<typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> max(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "max arguments must have the same type and length.");
+            return detail::math_result_t<EXPR0>(detail::max_vals<value_type, EXPR0::length>(a(), b()));
+        }
+
+        // |x| per lane, the most negative integer maps to itself
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> abs(EXPR const& x) noexcept {
+            return detail::math_result_t<EXPR>(detail::abs_vals<typename EXPR::value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> sqrt(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "sqrt requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::sqrt_vals<value_type, EXPR::length>(x()));
+        }
+
+        // 1 / sqrt(x), rsqrt<precision::fast>(x) for the raw estimate
+        template<precision P = precision::exact, typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> rsqrt(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "rsqrt requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::rsqrt_vals<P, value_type, EXPR::length>(x()));
+        }
+
+        template<precision P = precision::exact, typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> rcp(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "rcp requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::rcp_vals<P, value_type, EXPR::length>(x()));
+        }
+
+        // a / b at the given precision, the / operator is always exact
+        template<precision P = precision::exact, typename EXPR0, typename EXPR1,
+            typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> div(EXPR0 const& a, EXPR1 const& b) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "div arguments must have the same type and length.");
+            static_assert(std::is_floating_point_v<value_type>, "div requires a floating point vector.");
+            return detail::math_result_t<EXPR0>(detail::div_precision_vals<P, value_type, EXPR0::length>(a(), b()));
+        }
+
+        /*
+            Lane-wise math on float and double vectors or expressions. Max errors
+            in ulp against the correctly rounded result, as measured by the
+            tests over their sample ranges at every level:
+
+                        float   double
+                exp     1       1       inf or 0 past the representable range
+                exp2    1       1
+                log     2       2       subnormals included
+                log2    2       2       exact for powers of two
+                sin     2       2       |x| <= 8192 / 2^24, larger lanes fall back
+                cos     2       2       to the C library, which reduces exactly
+                tan     4       4       same as sin
+                atan2   4       4
+                pow     1       see below
+
+            double pow has no extended precision log2, its error grows with the
+            size of the exponent of the result: about 1 + |y * log2(x)| / 2 ulp.
+            Special values (inf, NaN, signed zeros) follow the C library.
+        */
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> exp(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "exp requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::exp_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> exp2(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "exp2 requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::exp2_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> log(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "log requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::log_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> log2(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "log2 requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::log2_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> sin(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "sin requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::sin_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> cos(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "cos requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::cos_vals<value_type, EXPR::length>(x()));
+        }
+
+        // both from one argument reduction, { sin, cos }
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        std::pair<detail::math_result_t<EXPR>, detail::math_result_t<EXPR>> sincos(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            constexpr size_t length = EXPR::length;
+            static_assert(std::is_floating_point_v<value_type>, "sincos requires a floating point vector.");
+            const auto arg = x();
+            const detail::trig_reduction<value_type, length> t = detail::trig_reduce_vals<value_type, length>(arg);
+            const auto odd = detail::sign_bit_mask<value_type, length>(detail::quadrant_sign_vals<0, value_type, length>(t.quadrant));
+            const auto sin_sign = detail::xor_vals<value_type, length>(detail::quadrant_sign_vals<1, value_type, length>(t.quadrant),
+                detail::sign_vals<value_type, length>(arg));
+            const auto next = detail::add_vals<value_type, length>(t.quadrant, detail::broadcast_val<value_type, length>(value_type(1)));
+            const auto sin_result = detail::xor_vals<value_type, length>(detail::select_vals<value_type, length>(odd, t.cos_r, t.sin_r), sin_sign);
+            const auto cos_result = detail::xor_vals<value_type, length>(detail::select_vals<value_type, length>(odd, t.sin_r, t.cos_r),
+                detail::quadrant_sign_vals<1, value_type, length>(next));
+            return {
+                detail::math_result_t<EXPR>(detail::trig_large_vals<value_type, length>(arg, sin_result, [](value_type a) { return std::sin(a); })),
+                detail::math_result_t<EXPR>(detail::trig_large_vals<value_type, length>(arg, cos_result, [](value_type a) { return std::cos(a); }))
+            };
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> tan(EXPR const& x) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "tan requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::tan_vals<value_type, EXPR::length>(x()));
+        }
+
+        template<typename EXPR0, typename EXPR1, typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> atan2(EXPR0 const& y, EXPR1 const& x) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "atan2 arguments must have the same type and length.");
+            static_assert(std::is_floating_point_v<value_type>, "atan2 requires a floating point vector.");
+            return detail::math_result_t<EXPR0>(detail::atan2_vals<value_type, EXPR0::length>(y(), x()));
+        }
+
+        template<typename EXPR0, typename EXPR1, typename = std::enable_if_t<detail::is_expression_node_v<EXPR0> && detail::is_expression_node_v<EXPR1>>>
+        detail::math_result_t<EXPR0> pow(EXPR0 const& x, EXPR1 const& y) noexcept {
+            using value_type = typename EXPR0::value_type;
+            static_assert(std::is_same_v<value_type, typename EXPR1::value_type> && EXPR0::length == EXPR1::length, "pow arguments must have the same type and length.");
+            static_assert(std::is_floating_point_v<value_type>, "pow requires a floating point vector.");
+            return detail::math_result_t<EXPR0>(detail::pow_vals<value_type, EXPR0::length>(x(), y()));
+        }
+
+        template<typename EXPR, typename = std::enable_if_t<detail::is_expression_node_v<EXPR>>>
+        detail::math_result_t<EXPR> pow(EXPR const& x, typename EXPR::value_type y) noexcept {
+            using value_type = typename EXPR::value_type;
+            static_assert(std::is_floating_point_v<value_type>, "pow requires a floating point vector.");
+            return detail::math_result_t<EXPR>(detail::pow_vals<value_type, EXPR::length>(x(), detail::broadcast_val<value_type, EXPR::length>(y)));
+        }
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_VECTOR_FUNCTIONS_HPP
@@ -218,7 +218,7 @@ namespace simd {
 		}
 
 		const ivec8& SIMD_CALL operator*=(ivec8 const &other) {
-			_data = _mm256_mul_epi32(_data, other._data);
+			_data = _mm256_mullo_epi32(_data, other._data);
 			return *this;
 		}
 
@@ -267,7 +267,7 @@ namespace simd {
 			return ivec8(_mm256_sub_epi32(_data, a._data));
 		}
 		ivec8 const SIMD_CALL operator*(ivec8 const &a) const {
-			return ivec8(_mm256_mul_epi32(_data, a._data));
+			return ivec8(_mm256_mullo_epi32(_data, a._data));
 		}
 
 		ivec8 SIMD_CALL operator&(ivec8 const& a) const {
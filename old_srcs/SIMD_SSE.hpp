@@ -72,7 +72,7 @@ namespace simd {
 		}
 
 		ivec4& SIMD_CALL operator*=(ivec4 const &other) {
-			_data = _mm_mul_epi32(other._data, _data);
+			_data = _mm_mullo_epi32(other._data, _data);
 			return *this;
 		}
 
@@ -86,7 +86,7 @@ namespace simd {
 		}
 
 		ivec4 SIMD_CALL operator*(ivec4 const &other) const {
-			return ivec4(_mm_mul_epi32(_data, other._data));
+			return ivec4(_mm_mullo_epi32(_data, other._data));
 		}
 		
 		ivec4 SIMD_CALL operator<(ivec4 const &other) const {
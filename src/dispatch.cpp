@@ -0,0 +1,225 @@
+#include "dispatch.hpp"
+#include "kernels.hpp"
+#include "kernel_table.hpp"
+#include <atomic>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif !defined(SW_PLATFORM_ARM)
+#include <cpuid.h>
+#endif
+
+namespace sw {
+
+    namespace {
+
+#if !defined(SW_PLATFORM_ARM)
+        void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept {
+#if defined(_MSC_VER)
+            int result[4];
+            __cpuidex(result, static_cast<int>(leaf), static_cast<int>(subleaf));
+            for (size_t i = 0; i < 4; ++i) {
+                regs[i] = static_cast<uint32_t>(result[i]);
+            }
+#else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        // XCR0, which says what register state the OS saves on context switches.
+        // Read with inline asm on gcc/clang so this TU doesn't need -mxsave.
+        uint64_t read_xcr0() noexcept {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+        }
+
+        cpu_features probe_cpu_features() noexcept {
+            cpu_features result;
+            uint32_t regs[4] = { 0, 0, 0, 0 };
+            cpuid(0, 0, regs);
+            const uint32_t max_leaf = regs[0];
+            if (max_leaf < 1) {
+                return result;
+            }
+
+            cpuid(1, 0, regs);
+            const uint32_t ecx1 = regs[2];
+            result.sse41 = (ecx1 & (1u << 19)) != 0;
+            result.popcnt = (ecx1 & (1u << 23)) != 0;
+            const bool osxsave = (ecx1 & (1u << 27)) != 0;
+            const bool cpu_avx = (ecx1 & (1u << 28)) != 0;
+            const bool cpu_fma = (ecx1 & (1u << 12)) != 0;
+            const bool cpu_f16c = (ecx1 & (1u << 29)) != 0;
+
+            const uint64_t xcr0 = osxsave ? read_xcr0() : 0;
+            // XMM and YMM state
+            const bool os_ymm = (xcr0 & 0x6) == 0x6;
+            // opmask, upper ZMM0-15 and ZMM16-31 state on top of the above
+            const bool os_zmm = (xcr0 & 0xe6) == 0xe6;
+
+            result.avx = cpu_avx && os_ymm;
+            result.fma = cpu_fma && result.avx;
+            result.f16c = cpu_f16c && result.avx;
+
+            if (max_leaf >= 7) {
+                cpuid(7, 0, regs);
+                const uint32_t ebx7 = regs[1];
+                result.avx2 = result.avx && (ebx7 & (1u << 5)) != 0;
+                result.bmi2 = (ebx7 & (1u << 8)) != 0;
+                if (result.avx && os_zmm) {
+                    result.avx512f = (ebx7 & (1u << 16)) != 0;
+                    result.avx512dq = (ebx7 & (1u << 17)) != 0;
+                    result.avx512bw = (ebx7 & (1u << 30)) != 0;
+                    result.avx512vl = (ebx7 & (1u << 31)) != 0;
+                }
+            }
+
+            return result;
+        }
+#else
+        cpu_features probe_cpu_features() noexcept {
+            return cpu_features();
+        }
+#endif
+
+        const dispatch::kernel_table* table_for(isa level) noexcept {
+            switch (level) {
+#if !defined(SW_PLATFORM_ARM)
+            case isa::avx512:
+                return &dispatch::kernel_table_avx512();
+            case isa::avx2:
+                return &dispatch::kernel_table_avx2();
+            case isa::sse41:
+                return &dispatch::kernel_table_sse41();
+#endif
+#if defined(SW_GENERIC_KERNELS)
+            case isa::generic:
+                return &dispatch::kernel_table_generic();
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        const dispatch::kernel_table* select_best_table() noexcept {
+            const dispatch::kernel_table* result = table_for(best_supported_isa());
+#if defined(SW_GENERIC_KERNELS)
+            return result != nullptr ? result : table_for(isa::generic);
+#else
+            // without the generic kernels (MSVC) SSE4.1 is the lowest level, so
+            // hosts below it still get bound to that table rather than to nothing
+            return result != nullptr ? result : table_for(isa::sse41);
+#endif
+        }
+
+        std::atomic<const dispatch::kernel_table*>& table_slot() noexcept {
+            static std::atomic<const dispatch::kernel_table*> slot{ select_best_table() };
+            return slot;
+        }
+
+    }
+
+    const cpu_features& detect_cpu_features() noexcept {
+        static const cpu_features features = probe_cpu_features();
+        return features;
+    }
+
+    isa best_supported_isa() noexcept {
+        return best_supported_isa(detect_cpu_features());
+    }
+
+    isa best_supported_isa(cpu_features const& features) noexcept {
+        // popcnt at every level, and the AVX2 targets are built with F16C and BMI2 as well
+        const bool avx2 = features.avx2 && features.fma && features.f16c && features.bmi2 && features.popcnt;
+        if (avx2 && features.avx512f && features.avx512bw && features.avx512dq && features.avx512vl) {
+            return isa::avx512;
+        }
+        else if (avx2) {
+            return isa::avx2;
+        }
+        else if (features.sse41 && features.popcnt) {
+            return isa::sse41;
+        }
+        else {
+            return isa::generic;
+        }
+    }
+
+    bool is_supported(isa level) noexcept {
+        return level <= best_supported_isa();
+    }
+
+    isa active_isa() noexcept {
+        return table_slot().load(std::memory_order_acquire)->level;
+    }
+
+    bool set_active_isa(isa level) noexcept {
+        const dispatch::kernel_table* table = table_for(level);
+        if (table == nullptr || !is_supported(level)) {
+            return false;
+        }
+        table_slot().store(table, std::memory_order_release);
+        return true;
+    }
+
+    const char* isa_name(isa level) noexcept {
+        switch (level) {
+        case isa::generic:
+            return "generic";
+        case isa::sse41:
+            return "sse4.1";
+        case isa::avx2:
+            return "avx2";
+        case isa::avx512:
+            return "avx512";
+        default:
+            return "unknown";
+        }
+    }
+
+    namespace dispatch {
+
+        const kernel_table& active_table() noexcept {
+            return *table_slot().load(std::memory_order_acquire);
+        }
+
+    }
+
+    namespace kernels {
+
+        void add(const float* a, const float* b, float* out, size_t count) noexcept {
+            dispatch::active_table().add_f32(a, b, out, count);
+        }
+
+        void sub(const float* a, const float* b, float* out, size_t count) noexcept {
+            dispatch::active_table().sub_f32(a, b, out, count);
+        }
+
+        void mul(const float* a, const float* b, float* out, size_t count) noexcept {
+            dispatch::active_table().mul_f32(a, b, out, count);
+        }
+
+        void div(const float* a, const float* b, float* out, size_t count) noexcept {
+            dispatch::active_table().div_f32(a, b, out, count);
+        }
+
+        void mul_add(const float* a, const float* b, const float* c, float* out, size_t count) noexcept {
+            dispatch::active_table().mul_add_f32(a, b, c, out, count);
+        }
+
+        void gemm(size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda, const float* b, size_t ldb, float beta, float* c, size_t ldc) noexcept {
+            dispatch::active_table().gemm_f32(nullptr, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
+
+        void gemm(execution::parallel_policy const& policy, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+            const float* b, size_t ldb, float beta, float* c, size_t ldc) noexcept {
+            dispatch::active_table().gemm_f32(&policy, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
+
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef SIMD_WRAP_SRC_KERNEL_TABLE_HPP
+#define SIMD_WRAP_SRC_KERNEL_TABLE_HPP
+#include <cstddef>
+#include "dispatch.hpp"
+#include "thread_pool.hpp"
+
+/*
+    One table per compiled ISA level. kernels.cpp is built once per level and
+    defines the matching kernel_table_*() function; dispatch.cpp picks one.
+    Nothing in here may depend on the ISA of the including translation unit.
+*/
+
+namespace sw {
+
+    namespace dispatch {
+
+        using binary_f32_fn = void(*)(const float*, const float*, float*, size_t) noexcept;
+        using ternary_f32_fn = void(*)(const float*, const float*, const float*, float*, size_t) noexcept;
+        // sequential when the policy is null
+        using gemm_f32_fn = void(*)(const execution::parallel_policy*, size_t, size_t, size_t, float, const float*, size_t,
+            const float*, size_t, float, float*, size_t) noexcept;
+
+        struct kernel_table {
+            isa level;
+            binary_f32_fn add_f32;
+            binary_f32_fn sub_f32;
+            binary_f32_fn mul_f32;
+            binary_f32_fn div_f32;
+            ternary_f32_fn mul_add_f32;
+            gemm_f32_fn gemm_f32;
+        };
+
+        // only built when the GENERIC level is, which needs vector extensions
+        const kernel_table& kernel_table_generic() noexcept;
+        const kernel_table& kernel_table_sse41() noexcept;
+        const kernel_table& kernel_table_avx2() noexcept;
+        const kernel_table& kernel_table_avx512() noexcept;
+
+        // table currently selected by active_isa()
+        const kernel_table& active_table() noexcept;
+
+    }
+
+}
+
+#endif //!SIMD_WRAP_SRC_KERNEL_TABLE_HPP
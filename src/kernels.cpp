@@ -0,0 +1,115 @@
+/*
+    Built once per dispatched ISA level, each time with that levels compiler
+    flags (see SIMDWRAP_ISA_FLAGS_* in CMakeLists.txt). Everything from the
+    headers lands in that levels inline namespace, so the copies don't clash,
+    and only the kernel_table_*() function for the level is defined here.
+*/
+#include "matrix.hpp"
+#include "transform.hpp"
+#include "kernel_table.hpp"
+
+namespace sw {
+
+    inline namespace SW_ISA_NAMESPACE {
+
+        namespace detail {
+
+            namespace {
+
+                struct add_op {
+                    template<typename V>
+                    auto operator()(V const& a, V const& b) const noexcept {
+                        return a + b;
+                    }
+                };
+
+                struct sub_op {
+                    template<typename V>
+                    auto operator()(V const& a, V const& b) const noexcept {
+                        return a - b;
+                    }
+                };
+
+                struct mul_op {
+                    template<typename V>
+                    auto operator()(V const& a, V const& b) const noexcept {
+                        return a * b;
+                    }
+                };
+
+                struct div_op {
+                    template<typename V>
+                    auto operator()(V const& a, V const& b) const noexcept {
+                        return a / b;
+                    }
+                };
+
+                // contracted into an fma wherever CONTRACT_FMA is set
+                struct mul_add_op {
+                    template<typename V>
+                    auto operator()(V const& a, V const& b, V const& c) const noexcept {
+                        return a * b + c;
+                    }
+                };
+
+                template<typename Op>
+                void binary_f32_kernel(const float* a, const float* b, float* out, size_t count) noexcept {
+                    transform(span<const float>(a, count), span<const float>(b, count), span<float>(out, count), Op{});
+                }
+
+                void mul_add_f32_kernel(const float* a, const float* b, const float* c, float* out, size_t count) noexcept {
+                    transform(span<const float>(a, count), span<const float>(b, count), span<const float>(c, count), span<float>(out, count), mul_add_op{});
+                }
+
+                void gemm_f32_kernel(const execution::parallel_policy* policy, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+                    const float* b, size_t ldb, float beta, float* c, size_t ldc) noexcept {
+                    if (policy != nullptr) {
+                        gemm(*policy, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+                    }
+                    else {
+                        gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+                    }
+                }
+
+                const dispatch::kernel_table& make_kernel_table() noexcept {
+                    static const dispatch::kernel_table table{
+                        compiled_isa,
+                        &binary_f32_kernel<add_op>,
+                        &binary_f32_kernel<sub_op>,
+                        &binary_f32_kernel<mul_op>,
+                        &binary_f32_kernel<div_op>,
+                        &mul_add_f32_kernel,
+                        &gemm_f32_kernel
+                    };
+                    return table;
+                }
+
+            }
+
+        }
+
+    }
+
+    namespace dispatch {
+
+#if SW_ISA_LEVEL == 3
+        const kernel_table& kernel_table_avx512() noexcept {
+            return detail::make_kernel_table();
+        }
+#elif SW_ISA_LEVEL == 2
+        const kernel_table& kernel_table_avx2() noexcept {
+            return detail::make_kernel_table();
+        }
+#elif SW_ISA_LEVEL == 1
+        const kernel_table& kernel_table_sse41() noexcept {
+            return detail::make_kernel_table();
+        }
+#else
+        const kernel_table& kernel_table_generic() noexcept {
+            return detail::make_kernel_table();
+        }
+#endif
+
+    }
+
+}
@@ -0,0 +1,183 @@
+#include "thread_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sw {
+
+    namespace {
+
+        struct job {
+            void (*fn)(void*, size_t);
+            void* context;
+            std::atomic<size_t> remaining;
+        };
+
+        struct task {
+            job* owner;
+            size_t index;
+        };
+
+        struct task_queue {
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+    }
+
+    struct thread_pool::impl {
+        std::vector<std::unique_ptr<task_queue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<size_t> queued{ 0 };
+        bool stopping = false;
+
+        // set on the pool's own threads, so nested parallel_for() calls push locally
+        static thread_local impl* current_pool;
+        static thread_local size_t current_queue;
+
+        void push(size_t queue, job* owner, size_t begin, size_t end) {
+            if (begin == end) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+            for (size_t i = begin; i < end; ++i) {
+                queues[queue]->tasks.push_back(task{ owner, i });
+            }
+        }
+
+        bool pop(size_t queue, bool steal, task& result) {
+            std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+            std::deque<task>& tasks = queues[queue]->tasks;
+            if (tasks.empty()) {
+                return false;
+            }
+            if (steal) {
+                result = tasks.front();
+                tasks.pop_front();
+            }
+            else {
+                result = tasks.back();
+                tasks.pop_back();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // own queue first, then steal round the others
+        bool run_one(size_t self) {
+            task next;
+            const size_t count = queues.size();
+            bool found = self < count && pop(self, false, next);
+            for (size_t i = 1; !found && i <= count; ++i) {
+                found = pop((self + i) % count, true, next);
+            }
+            if (found) {
+                next.owner->fn(next.owner->context, next.index);
+                next.owner->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            return found;
+        }
+
+        void worker_loop(size_t self) {
+            current_pool = this;
+            current_queue = self;
+            for (;;) {
+                if (run_one(self)) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) != 0; });
+                if (stopping) {
+                    return;
+                }
+            }
+        }
+    };
+
+    thread_local thread_pool::impl* thread_pool::impl::current_pool = nullptr;
+    thread_local size_t thread_pool::impl::current_queue = 0;
+
+    thread_pool::thread_pool(size_t threads) : state(std::make_unique<impl>()) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        const size_t worker_count = threads > 1 ? threads - 1 : 0;
+        for (size_t i = 0; i < worker_count; ++i) {
+            state->queues.push_back(std::make_unique<task_queue>());
+        }
+        for (size_t i = 0; i < worker_count; ++i) {
+            state->workers.emplace_back([this, i] { state->worker_loop(i); });
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(state->sleep_mutex);
+            state->stopping = true;
+        }
+        state->wake.notify_all();
+        for (std::thread& worker : state->workers) {
+            worker.join();
+        }
+    }
+
+    size_t thread_pool::size() const noexcept {
+        return state->workers.size() + 1;
+    }
+
+    thread_pool& thread_pool::default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    void thread_pool::run(size_t count, task_fn fn, void* context) {
+        const size_t queue_count = state->queues.size();
+        if (count == 0) {
+            return;
+        }
+        if (queue_count == 0 || count == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(context, i);
+            }
+            return;
+        }
+        job work{ fn, context, {} };
+        work.remaining.store(count, std::memory_order_relaxed);
+        const bool nested = impl::current_pool == state.get();
+        // count first, so a worker that wakes up finds the tasks accounted for
+        state->queued.fetch_add(count, std::memory_order_relaxed);
+        if (nested) {
+            state->push(impl::current_queue, &work, 0, count);
+        }
+        else {
+            // contiguous slices per worker keep neighbouring chunks on one core until stolen
+            for (size_t q = 0; q < queue_count; ++q) {
+                state->push(q, &work, count * q / queue_count, count * (q + 1) / queue_count);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->sleep_mutex);
+        }
+        state->wake.notify_all();
+        const size_t self = nested ? impl::current_queue : queue_count;
+        while (work.remaining.load(std::memory_order_acquire) != 0) {
+            if (!state->run_one(self)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    namespace execution {
+
+        thread_pool& parallel_policy::get_pool() const {
+            return pool != nullptr ? *pool : thread_pool::default_pool();
+        }
+
+    }
+
+}
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "filter.hpp"
+#include "parallel.hpp"
+#include "reductions.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    template<typename T>
+    std::vector<T> iota_values(size_t count, T start, T step) {
+        std::vector<T> result(count);
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = start + step * static_cast<T>(i);
+        }
+        return result;
+    }
+
+    template<typename T, size_t LEN>
+    void test_transform(size_t offset) {
+        for (size_t count : { size_t(0), size_t(1), size_t(5), size_t(31), size_t(64), size_t(257) }) {
+            const std::vector<T> a = iota_values<T>(count + offset, T(1), T(0.5));
+            const std::vector<T> b = iota_values<T>(count + offset, T(-3), T(2));
+            std::vector<T> out(count + offset + 1, T(-1));
+            const sw::span<const T> in0(a.data() + offset, count);
+            const sw::span<const T> in1(b.data() + offset, count);
+            const sw::span<T> dst(out.data() + offset, count);
+
+            sw::transform<LEN>(in0, dst, [](auto const& x) { return -x * T(2); });
+            bool ok = true;
+            for (size_t i = 0; i < count; ++i) {
+                ok &= dst[i] == -in0[i] * T(2);
+            }
+            SW_CHECK(ok);
+
+            sw::transform<LEN>(in0, in1, dst, [](auto const& x, auto const& y) { return x - y * T(4); });
+            ok = true;
+            for (size_t i = 0; i < count; ++i) {
+                ok &= dst[i] == in0[i] - in1[i] * T(4);
+            }
+            SW_CHECK(ok);
+
+            sw::transform<LEN>(in0, in1, in0, dst, [](auto const& x, auto const& y, auto const& z) {
+                // building on locals needs an explicit vector as the result
+                const sw::vector<T, LEN> sum = x + y;
+                return sw::vector<T, LEN>(sum * z);
+            });
+            ok = true;
+            for (size_t i = 0; i < count; ++i) {
+                ok &= dst[i] == (in0[i] + in1[i]) * in0[i];
+            }
+            SW_CHECK(ok);
+
+            // in place, and nothing past the end gets written
+            sw::transform<LEN>(dst, dst, [](auto const& x) { return x + T(1); });
+            ok = true;
+            for (size_t i = 0; i < count; ++i) {
+                ok &= dst[i] == (in0[i] + in1[i]) * in0[i] + T(1);
+            }
+            SW_CHECK(ok);
+            SW_CHECK(out[offset + count] == T(-1));
+            SW_CHECK(offset == 0 || out[offset - 1] == T(-1));
+        }
+    }
+
+    template<typename T>
+    void test_transform_reduce() {
+        for (size_t count : { size_t(0), size_t(3), size_t(16), size_t(100), size_t(1000) }) {
+            const std::vector<T> a = iota_values<T>(count, T(1), T(1));
+            const std::vector<T> b(count, T(2));
+            // sum of (x + 1) isn't zero for the masked lanes, the tail has to be cut off
+            const T shifted = sw::transform_reduce(sw::span(a), [](auto const& x) { return x + T(1); });
+            SW_CHECK(shifted == T(count * (count + 1) / 2 + count));
+            const T dot = sw::transform_reduce(sw::span(a), sw::span(b), [](auto const& x, auto const& y) { return x * y; });
+            SW_CHECK(dot == T(count * (count + 1)));
+        }
+    }
+
+    template<typename T>
+    void test_reductions() {
+        for (size_t count : { size_t(0), size_t(1), size_t(5), size_t(31), size_t(64), size_t(257), size_t(1000) }) {
+            std::vector<T> values(count), others(count);
+            double sum = 0.0, dot = 0.0, product = 1.0;
+            T low = std::numeric_limits<T>::infinity(), high = -low;
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = std::sin(T(i) * T(0.9)) * T(8);
+                others[i] = T(1) + T(i % 7) * T(0.001);
+                sum += double(values[i]);
+                dot += double(values[i]) * double(others[i]);
+                product *= double(others[i]);
+                low = values[i] < low ? values[i] : low;
+                high = values[i] > high ? values[i] : high;
+            }
+            const sw::span<const T> in(values);
+            const double tolerance = std::is_same_v<T, float> ? 1e-5 : 1e-13;
+            SW_CHECK(std::fabs(double(sw::reduce_add(in)) - sum) <= tolerance * (8.0 * double(count) + 1.0));
+            SW_CHECK(std::fabs(double(sw::reduce_add<sw::summation::compensated>(in)) - sum) <= tolerance * (std::fabs(sum) + 1e-3));
+            SW_CHECK(sw::reduce_min(in) == low);
+            SW_CHECK(sw::reduce_max(in) == high);
+            SW_CHECK(std::fabs(double(sw::reduce_mul(sw::span<const T>(others))) - product) <= tolerance * double(count + 1) * product);
+            SW_CHECK(std::fabs(double(sw::dot(in, sw::span<const T>(others))) - dot) <= tolerance * (8.0 * double(count) + 1.0));
+            SW_CHECK(std::fabs(double(sw::dot<sw::summation::compensated>(in, sw::span<const T>(others))) - dot) <= tolerance * (std::fabs(dot) + 1e-3));
+            if constexpr (std::is_same_v<T, float>) {
+                // the same through a narrower register
+                SW_CHECK(sw::reduce_max<4>(in) == high);
+            }
+        }
+    }
+
+    // long float sums drift with plain accumulation, not with the compensated one
+    void test_compensated() {
+        const size_t count = 10000000;
+        std::vector<float> values(count);
+        double exact = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = 0.1f + float(i % 1000) * 1e-5f;
+            exact += double(values[i]);
+        }
+        const float compensated = sw::reduce_add<sw::summation::compensated>(sw::span<const float>(values));
+        SW_CHECK(std::fabs(double(compensated) - exact) <= 0.5 * std::fabs(double(std::nextafter(compensated, 0.0f)) - double(compensated)));
+        // cancellation: the small terms vanish from a plain sum of products
+        const std::vector<float> a = { 1e8f, 1.0f, -1e8f, 1.0f, 0.5f };
+        const std::vector<float> b = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+        SW_CHECK(sw::dot<sw::summation::compensated>(sw::span(a), sw::span(b)) == 2.5f);
+        SW_CHECK((sw::dot<sw::summation::compensated, 4>(sw::span(a), sw::span(b)) == 2.5f));
+        const std::vector<double> big = { 1e17, 3.0, -1e17, 0.25 };
+        SW_CHECK(sw::reduce_add<sw::summation::compensated>(sw::span(big)) == 3.25);
+        // every lane of an odd sized vector, the padding must not take part
+        const float lanes[3] = { 2.0f, 3.0f, 4.0f };
+        SW_CHECK(sw::reduce_mul(sw::vector<float, 3>::load_partial(lanes, 3)) == 24.0f);
+    }
+
+    template<typename T>
+    void test_filter() {
+        for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(64), size_t(1001) }) {
+            std::vector<T> in(count), out(count, T(-1));
+            for (size_t i = 0; i < count; ++i) {
+                in[i] = T((i * 37) % 101);
+            }
+            std::vector<T> expected;
+            for (T value : in) {
+                if (value < T(40)) {
+                    expected.push_back(value);
+                }
+            }
+            const size_t kept = sw::filter(sw::span<const T>(in.data(), count), sw::span(out), [](auto const& x) { return x < T(40); });
+            SW_CHECK(kept == expected.size());
+            SW_CHECK(std::equal(expected.begin(), expected.end(), out.begin()));
+
+            // one column selected by another, and in place
+            std::vector<T> values(count);
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = T(i);
+            }
+            std::vector<T> rows(count);
+            const size_t selected = sw::filter(sw::span(in), sw::span(values), sw::span(rows), [](auto const& x) { return x >= T(40); });
+            bool ok = selected == count - expected.size();
+            for (size_t r = 0, i = 0; i < count; ++i) {
+                if (in[i] >= T(40)) {
+                    ok &= r < selected && rows[r++] == T(i);
+                }
+            }
+            SW_CHECK(ok);
+            SW_CHECK(sw::filter(sw::span(in), sw::span(in), [](auto const& x) { return x < T(40); }) == expected.size());
+            SW_CHECK(std::equal(expected.begin(), expected.end(), in.begin()));
+        }
+    }
+
+    // every half through the scalar and the vector conversions, then floats of all kinds back
+    void test_half() {
+        std::vector<sw::half> halves(65536);
+        for (size_t i = 0; i < halves.size(); ++i) {
+            halves[i] = sw::half::from_bits(uint16_t(i));
+        }
+        std::vector<float> widened(halves.size());
+        sw::transform(sw::span<const sw::half>(halves), sw::span<float>(widened), [](auto const& x) { return x; });
+        std::vector<sw::half> narrowed(halves.size());
+        sw::transform(sw::span<const float>(widened), sw::span<sw::half>(narrowed), [](auto const& x) { return x; });
+        bool ok = true;
+        for (size_t i = 0; i < halves.size(); ++i) {
+            const float scalar = halves[i];
+            if (std::isnan(scalar)) {
+                ok &= std::isnan(widened[i]) && std::isnan(float(narrowed[i]));
+                continue;
+            }
+            ok &= std::memcmp(&scalar, &widened[i], sizeof(float)) == 0;
+            ok &= sw::half(scalar).bits() == i && narrowed[i].bits() == i;
+        }
+        SW_CHECK(ok);
+
+        // edges of the range, ties between halves and random bit patterns
+        std::vector<float> floats = { 0.0f, -0.0f, 65504.0f, 65519.99f, 65520.0f, -1e9f, 1e-8f, 2.98e-8f, 5.96e-8f, 6.1e-5f,
+            1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min() };
+        uint32_t state = 12345;
+        while (floats.size() < 4099) {
+            state = state * 1664525u + 1013904223u;
+            uint32_t bits = state;
+            // mostly exponents a half can hold
+            if (floats.size() % 4 != 0) {
+                bits = (bits & 0x807FFFFFu) | ((100u + (state >> 8) % 45u) << 23);
+            }
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            floats.push_back(std::isnan(value) ? 1.5f : value);
+        }
+        std::vector<sw::half> stored(floats.size() + 1, sw::half::from_bits(0x1234));
+        sw::transform(sw::span<const float>(floats), sw::span<sw::half>(stored.data() + 1, floats.size()), [](auto const& x) { return x * 1.0f; });
+        std::vector<float> reloaded(floats.size());
+        sw::transform(sw::span<const sw::half>(stored.data() + 1, floats.size()), sw::span<float>(reloaded), [](auto const& x) { return x; });
+        for (size_t i = 0; i < floats.size(); ++i) {
+            const uint16_t expected = sw::half(floats[i]).bits();
+            ok &= stored[i + 1].bits() == expected;
+            ok &= reloaded[i] == float(sw::half::from_bits(expected));
+#if SW_ISA_LEVEL >= 2
+            ok &= expected == _cvtss_sh(floats[i], _MM_FROUND_TO_NEAREST_INT);
+#endif
+        }
+        ok &= stored[0].bits() == 0x1234;
+        const float sum = sw::transform_reduce(sw::span<const sw::half>(halves.data() + 0x3C00, 100), [](auto const& x) { return x; });
+        float expected_sum = 0.0f;
+        for (size_t i = 0; i < 100; ++i) {
+            expected_sum += halves[0x3C00 + i];
+        }
+        ok &= std::fabs(sum - expected_sum) <= 1e-5f * std::fabs(expected_sum);
+
+        // partial loads and stores leave the rest alone
+        const auto v = sw::load_f16<sw::native_length<float>>(halves.data() + 0x3C00, 3);
+        std::vector<sw::half> partial(sw::native_length<float>, sw::half::from_bits(0xFFFF));
+        sw::store_f16(partial.data(), v, 2);
+        std::vector<float> lanes(sw::native_length<float>);
+        v.store_unaligned(lanes.data());
+        ok &= lanes[0] == 1.0f && lanes[2] == float(halves[0x3C02]) && (lanes.size() < 4 || lanes[3] == 0.0f);
+        ok &= partial[0].bits() == 0x3C00 && partial[1].bits() == 0x3C01 && partial[2].bits() == 0xFFFF;
+        SW_CHECK(ok);
+    }
+
+    void test_thread_pool() {
+        for (size_t threads : { size_t(1), size_t(2), size_t(5) }) {
+            sw::thread_pool pool(threads);
+            SW_CHECK(pool.size() == threads);
+            std::vector<std::atomic<int>> hits(1000);
+            pool.parallel_for(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+            bool once = true;
+            for (auto const& hit : hits) {
+                once &= hit.load() == 1;
+            }
+            SW_CHECK(once);
+            // nested calls from inside a task help out instead of blocking
+            std::atomic<size_t> inner{ 0 };
+            pool.parallel_for(8, [&](size_t) {
+                pool.parallel_for(16, [&](size_t) { inner.fetch_add(1); });
+            });
+            SW_CHECK(inner.load() == 8 * 16);
+        }
+    }
+
+    void test_parallel() {
+        const size_t count = 300001;
+        const std::vector<float> a = iota_values<float>(count, 0.25f, 0.001f);
+        const std::vector<float> b = iota_values<float>(count, 3.0f, -0.0007f);
+        std::vector<float> expected(count), out(count + 1);
+        const auto op = [](auto const& x, auto const& y) { return x * y - x; };
+        sw::transform(sw::span(a), sw::span(b), sw::span(expected), op);
+        const sw::span<float> shifted(out.data() + 1, count);
+
+        float reference = 0.0f;
+        for (size_t threads : { size_t(1), size_t(3), size_t(8) }) {
+            sw::thread_pool pool(threads);
+            const sw::execution::parallel_policy policy{ &pool, 16 * 1024 };
+            sw::transform(policy, sw::span(a), sw::span(b), shifted, op);
+            SW_CHECK(std::memcmp(shifted.data(), expected.data(), sizeof(float) * count) == 0);
+            // bitwise the same for every thread count
+            const float dot = sw::transform_reduce(policy, sw::span(a), sw::span(b), [](auto const& x, auto const& y) { return x * y; });
+            if (threads == 1) {
+                reference = dot;
+            }
+            SW_CHECK(std::memcmp(&dot, &reference, sizeof(float)) == 0);
+        }
+        double exact = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            exact += double(a[i]) * double(b[i]);
+        }
+        SW_CHECK(std::fabs(reference - exact) <= 1e-4 * std::fabs(exact));
+        // the default pool and the sequenced policy
+        sw::transform(sw::execution::par, sw::span(a), sw::span(b), sw::span<float>(out.data(), count), op);
+        SW_CHECK(std::memcmp(out.data(), expected.data(), sizeof(float) * count) == 0);
+        const float seq = sw::transform_reduce(sw::execution::seq, sw::span(a), [](auto const& x) { return x; });
+        SW_CHECK(seq == sw::transform_reduce(sw::span(a), [](auto const& x) { return x; }));
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    for (size_t offset : { size_t(0), size_t(1), size_t(3) }) {
+        test_transform<float, sw::native_length<float>>(offset);
+        test_transform<double, sw::native_length<double>>(offset);
+        test_transform<float, 4>(offset);
+        test_transform<int32_t, 4>(offset);
+    }
+    test_transform_reduce<float>();
+    test_transform_reduce<double>();
+    test_reductions<float>();
+    test_reductions<double>();
+    test_compensated();
+    test_filter<float>();
+    test_filter<double>();
+    test_filter<int32_t>();
+    test_filter<int16_t>();
+    test_half();
+    test_thread_pool();
+    test_parallel();
+    return sw_test::finish("bulk_tests");
+}
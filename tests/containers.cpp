@@ -0,0 +1,194 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "aligned_arena.hpp"
+#include "geometric_functions.hpp"
+#include "soa_array.hpp"
+#include "vector_functions.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    using points = sw::soa_array<float, 3>;
+
+    void test_soa_layout() {
+        points cloud;
+        SW_CHECK(cloud.empty() && cloud.num_blocks() == 0);
+        SW_CHECK(cloud.begin() == cloud.end());
+        const size_t count = 3 * points::length + 1;
+        for (size_t i = 0; i < count; ++i) {
+            const float f = static_cast<float>(i);
+            cloud.push_back({ f, 2.0f * f, -f });
+        }
+        SW_CHECK(cloud.size() == count);
+        SW_CHECK(cloud.num_blocks() == 4);
+        SW_CHECK(cloud.capacity() % points::length == 0);
+        for (size_t c = 0; c < 3; ++c) {
+            SW_CHECK(reinterpret_cast<uintptr_t>(cloud.data(c)) % points::alignment == 0);
+        }
+        SW_CHECK(cloud.get(7)[1] == 14.0f);
+        SW_CHECK(cloud(2, 9) == -9.0f);
+        SW_CHECK(cloud.data(1)[5] == 10.0f);
+
+        points copy = cloud;
+        copy.set(0, { 1.0f, 1.0f, 1.0f });
+        SW_CHECK(cloud.get(0)[0] == 0.0f && copy.get(0)[0] == 1.0f);
+        points moved = std::move(copy);
+        SW_CHECK(moved.size() == count && copy.empty());
+    }
+
+    void test_soa_blocks() {
+        points cloud(2 * points::length + 3);
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            cloud.set(i, { 1.0f, 2.0f, 3.0f });
+        }
+        // scale every point, a block at a time
+        size_t visited = 0;
+        for (points::block block : cloud) {
+            for (size_t c = 0; c < points::components; ++c) {
+                block.store(c, block.load(c) * 2.0f);
+            }
+            visited += block.size();
+        }
+        SW_CHECK(visited == cloud.size());
+        SW_CHECK(cloud.get(cloud.size() - 1)[2] == 6.0f);
+        // padding stayed zero, so whole blocks can be summed
+        float sum = 0.0f;
+        const points& view = cloud;
+        for (points::const_block block : view) {
+            sum += sw::reduce_add(block.load(0) + block.load(1) + block.load(2));
+        }
+        SW_CHECK(sum == 12.0f * static_cast<float>(cloud.size()));
+        SW_CHECK(view.block_at(2).size() == 3);
+
+        // shrinking zeroes what falls off
+        cloud.resize(1);
+        cloud.resize(points::length);
+        SW_CHECK(cloud.get(1)[0] == 0.0f && cloud.get(0)[0] == 2.0f);
+        cloud.clear();
+        SW_CHECK(cloud.empty() && cloud.capacity() != 0);
+    }
+
+
+    // counts what reaches upstream
+    struct counting_resource : std::pmr::memory_resource {
+        size_t allocations = 0;
+        size_t live = 0;
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations;
+            ++live;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            --live;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void test_soa_geometric() {
+        using batch = sw::soa_vector<float, 3>;
+        const size_t count = 2 * points::length + 5;
+        points a(count), b(count), out(count);
+        for (size_t i = 0; i < count; ++i) {
+            const float f = static_cast<float>(i);
+            a.set(i, { f, 1.0f, -2.0f });
+            b.set(i, { 0.5f, f, 3.0f });
+        }
+        float dots[points::length], lengths[points::length];
+        bool ok = true;
+        for (size_t block = 0; block < a.num_blocks(); ++block) {
+            const batch pa = batch::load(a.block_at(block));
+            const batch pb = batch::load(b.block_at(block));
+            // results per element, nothing horizontal
+            sw::dot(pa, pb).store_unaligned(dots);
+            sw::length(pa).store_unaligned(lengths);
+            sw::cross(pa, pb).store(out.block_at(block));
+            for (size_t lane = 0; lane < out.block_at(block).size(); ++lane) {
+                const float f = static_cast<float>(block * points::length + lane);
+                ok &= dots[lane] == 0.5f * f + f - 6.0f;
+                ok &= lengths[lane] == std::sqrt(f * f + 5.0f);
+            }
+        }
+        SW_CHECK(ok);
+        // a x b with a = (f, 1, -2), b = (0.5, f, 3)
+        SW_CHECK((out.get(7) == points::element_type{ 3.0f + 14.0f, -1.0f - 21.0f, 49.0f - 0.5f }));
+
+        batch x{}, y{}, z{};
+        x[0] = sw::vector<float, points::length>(1.0f);
+        y[1] = sw::vector<float, points::length>(1.0f);
+        z[2] = sw::vector<float, points::length>(1.0f);
+        const batch diagonal = x + y - z;
+        SW_CHECK(sw::reduce_add(sw::cross(x, y)[2]) == static_cast<float>(points::length));
+        SW_CHECK(sw::reduce_add(sw::distance(diagonal, x)) == std::sqrt(2.0f) * static_cast<float>(points::length));
+        // reflecting (1, 1, -1) on the z plane flips z, projecting onto x keeps x
+        const batch reflected = sw::reflect(diagonal, z);
+        SW_CHECK(sw::reduce_add(reflected[2]) == static_cast<float>(points::length));
+        const batch projected = sw::project(diagonal, x * sw::vector<float, points::length>(4.0f));
+        SW_CHECK(sw::reduce_add(projected[0]) == static_cast<float>(points::length) && sw::reduce_add(projected[1]) == 0.0f);
+        const batch unit = sw::normalize(diagonal);
+        SW_CHECK(std::fabs(sw::reduce_add(sw::length(unit)) - static_cast<float>(points::length)) < 1e-5f);
+        const batch rough = sw::normalize<sw::precision::refined>(diagonal);
+        SW_CHECK(std::fabs(sw::reduce_add(sw::dot(rough, unit)) - static_cast<float>(points::length)) < 1e-5f);
+    }
+
+    void test_arena() {
+        counting_resource upstream;
+        {
+            sw::aligned_arena arena(4096, &upstream);
+            SW_CHECK(arena.bytes_reserved() == 0);
+            float* a = arena.allocate_array<float>(3);
+            double* b = arena.allocate_array<double, 2>(5);
+            SW_CHECK((reinterpret_cast<uintptr_t>(a) % sw::vectorized_alignment<float, sw::native_length<float>> == 0));
+            SW_CHECK(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+            // padded to whole registers, so the next block doesn't overlap a full load
+            SW_CHECK(reinterpret_cast<char*>(b) - reinterpret_cast<char*>(a) >= static_cast<std::ptrdiff_t>(sizeof(float) * sw::native_length<float>));
+            SW_CHECK(upstream.allocations == 1);
+            // bigger than a chunk gets a chunk of its own
+            void* big = arena.allocate(10000, 64);
+            SW_CHECK(big != nullptr && reinterpret_cast<uintptr_t>(big) % 64 == 0);
+            SW_CHECK(upstream.allocations == 2);
+            const size_t reserved = arena.bytes_reserved();
+            SW_CHECK(arena.bytes_allocated() >= 10000);
+
+            // reset reuses the chunks without going upstream
+            arena.reset();
+            SW_CHECK(arena.bytes_allocated() == 0);
+            for (int frame = 0; frame < 4; ++frame) {
+                arena.allocate_array<float>(500);
+                (void)arena.allocate(9000, 32);
+                arena.reset();
+            }
+            SW_CHECK(upstream.allocations == 2);
+            SW_CHECK(arena.bytes_reserved() == reserved);
+
+            // as a pmr resource
+            std::pmr::vector<int> ints(&arena);
+            ints.assign(100, 7);
+            SW_CHECK(ints[99] == 7);
+            sw::soa_array<float, 3> cloud(17, &arena);
+            SW_CHECK(cloud.get_resource() == &arena);
+            SW_CHECK((reinterpret_cast<uintptr_t>(cloud.data(2)) % sw::soa_array<float, 3>::alignment == 0));
+            cloud.set(16, { 1.0f, 2.0f, 3.0f });
+            sw::soa_array<float, 3> moved = std::move(cloud);
+            SW_CHECK(moved.get_resource() == &arena && moved.get(16)[2] == 3.0f);
+            sw::soa_array<float, 3> elsewhere;
+            elsewhere = std::move(moved);
+            SW_CHECK(elsewhere.get_resource() == std::pmr::get_default_resource() && elsewhere.get(16)[1] == 2.0f);
+        }
+        // everything handed back on destruction
+        SW_CHECK(upstream.live == 0);
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_soa_layout();
+    test_soa_blocks();
+    test_soa_geometric();
+    test_arena();
+    return sw_test::finish("container_tests");
+}
@@ -0,0 +1,244 @@
+#include <array>
+#include <cfenv>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "convert.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    using sw_test::lanes_of;
+
+    template<sw::rounding MODE>
+    double round_scalar(double x) {
+        switch (MODE) {
+        case sw::rounding::down:
+            return std::floor(x);
+        case sw::rounding::up:
+            return std::ceil(x);
+        case sw::rounding::toward_zero:
+            return std::trunc(x);
+        default:
+            return std::nearbyint(x);
+        }
+    }
+
+    template<typename To, sw::rounding MODE, typename From>
+    To convert_scalar(From x) {
+        if constexpr (std::is_floating_point_v<From> && std::is_integral_v<To>) {
+            return To(round_scalar<MODE>(double(x)));
+        }
+        else {
+            return To(x);
+        }
+    }
+
+    // ties both ways, negatives and values past what float or int32 hold exactly
+    template<typename T, size_t LEN>
+    std::array<T, LEN> make_values(size_t round) {
+        static const double samples[] = { 2.5, -2.5, 1.5, -0.5, 0.49, -7.75, 3.0, 1e6 + 0.5, -123456.5, 8388609.0, 0.0, -1.25, 1e9, -65.5, 42.75, 16777217.0 };
+        std::array<T, LEN> result;
+        for (size_t i = 0; i < LEN; ++i) {
+            result[i] = T(samples[(i + round) % 16]);
+        }
+        return result;
+    }
+
+    template<typename From, typename To, size_t LEN, sw::rounding MODE>
+    void test_convert_mode() {
+        bool ok = true;
+        for (size_t round = 0; round < 4; ++round) {
+            const auto values = make_values<From, LEN>(round);
+            const auto converted = lanes_of(sw::convert<To, MODE>(sw::vector<From, LEN>::load_partial(values.data())));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= converted[i] == convert_scalar<To, MODE>(values[i]);
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename From, typename To, size_t LEN>
+    void test_convert() {
+        test_convert_mode<From, To, LEN, sw::rounding::nearest>();
+        test_convert_mode<From, To, LEN, sw::rounding::down>();
+        test_convert_mode<From, To, LEN, sw::rounding::up>();
+        test_convert_mode<From, To, LEN, sw::rounding::toward_zero>();
+    }
+
+    // every pair of lane types at LEN lanes, where both fit in a register at this level
+    template<size_t LEN>
+    void test_all_pairs() {
+        test_convert<float, int32_t, LEN>();
+        test_convert<int32_t, float, LEN>();
+        test_convert<float, double, LEN>();
+        test_convert<double, float, LEN>();
+        test_convert<double, int32_t, LEN>();
+        test_convert<int32_t, double, LEN>();
+        test_convert<double, int64_t, LEN>();
+        test_convert<int64_t, double, LEN>();
+        test_convert<int32_t, int64_t, LEN>();
+        test_convert<int64_t, int32_t, LEN>();
+        test_convert<float, int64_t, LEN>();
+        test_convert<int64_t, float, LEN>();
+    }
+
+    template<size_t LEN>
+    void test_edges() {
+        // int64 to double over the whole range, rounding the low bits like the scalar cast
+        std::array<int64_t, LEN> big;
+        const int64_t samples[] = { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), (int64_t(1) << 53) + 1, -(int64_t(1) << 60) - 12345, -1, 0, int64_t(1) << 62, 9007199254740993 };
+        for (size_t i = 0; i < LEN; ++i) {
+            big[i] = samples[i % 8];
+        }
+        const auto doubles = lanes_of(sw::convert<double>(sw::vector<int64_t, LEN>::load_partial(big.data())));
+        // int64 to int32 keeps the low bits, out of range floats give INT_MIN
+        const auto narrowed = lanes_of(sw::convert<int32_t>(sw::vector<int64_t, LEN>::load_partial(big.data())));
+        const std::array<float, 4> large = { 3e9f, -3e9f, std::numeric_limits<float>::quiet_NaN(), 2147483520.0f };
+        const auto clamped = lanes_of(sw::convert<int32_t>(sw::vector<float, 4>::load_partial(large.data())));
+        bool ok = true;
+        for (size_t i = 0; i < LEN; ++i) {
+            ok &= doubles[i] == double(big[i]);
+            ok &= narrowed[i] == int32_t(uint32_t(uint64_t(big[i])));
+        }
+        ok &= clamped[0] == std::numeric_limits<int32_t>::min() && clamped[1] == std::numeric_limits<int32_t>::min();
+        ok &= clamped[2] == std::numeric_limits<int32_t>::min() && clamped[3] == 2147483520;
+        SW_CHECK(ok);
+    }
+
+    // doubles and floats past 2^51 to int64, where those are still exact, and the lanes that are out of range
+    template<size_t LEN>
+    void test_large_int64() {
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        const double samples[] = { -3e15, 4.5e15, 9007199254740994.0, -4611686018427387904.0, 9.2e18, -9223372036854775808.0, 2251799813685249.5,
+            -6755399441055745.0, 1e20, -1e20, 9223372036854775808.0, std::numeric_limits<double>::quiet_NaN(), inf, -inf, -0.0, 4294967297.0 };
+        const auto expected = [](double x) {
+            return x >= -9223372036854775808.0 && x < 9223372036854775808.0 ? int64_t(x) : std::numeric_limits<int64_t>::min();
+        };
+        bool ok = true;
+        for (size_t round = 0; round < 16; round += LEN) {
+            std::array<double, LEN> doubles;
+            std::array<float, LEN> floats;
+            for (size_t i = 0; i < LEN; ++i) {
+                doubles[i] = samples[(i + round) % 16];
+                floats[i] = float(doubles[i]);
+            }
+            const auto from_doubles = lanes_of(sw::convert<int64_t, sw::rounding::toward_zero>(sw::vector<double, LEN>::load_partial(doubles.data())));
+            const auto from_floats = lanes_of(sw::convert<int64_t, sw::rounding::toward_zero>(sw::vector<float, LEN>::load_partial(floats.data())));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= from_doubles[i] == expected(doubles[i]);
+                ok &= from_floats[i] == expected(double(floats[i]));
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    // nearest stays ties to even whatever fesetround says
+    template<size_t LEN>
+    void test_rounding_mode() {
+        const double samples[] = { 2.5, -2.5, 0.5, -0.5, 1.5, 3.7, -3.7, 1e17 };
+        const int64_t expected[] = { 2, -2, 0, 0, 2, 4, -4, 100000000000000000 };
+        bool ok = true;
+        for (int mode : { FE_UPWARD, FE_DOWNWARD, FE_TOWARDZERO }) {
+            std::fesetround(mode);
+            for (size_t round = 0; round < 8; round += LEN) {
+                std::array<double, LEN> doubles;
+                std::array<float, LEN> floats;
+                for (size_t i = 0; i < LEN; ++i) {
+                    doubles[i] = samples[(i + round) % 8];
+                    floats[i] = float(doubles[i]);
+                }
+                const auto from_doubles = lanes_of(sw::convert<int64_t>(sw::vector<double, LEN>::load_partial(doubles.data())));
+                const auto from_floats = lanes_of(sw::convert<int32_t>(sw::vector<float, LEN>::load_partial(floats.data())));
+                for (size_t i = 0; i < LEN; ++i) {
+                    const size_t index = (i + round) % 8;
+                    ok &= from_doubles[i] == expected[index];
+                    ok &= index == 7 || from_floats[i] == int32_t(expected[index]);
+                }
+            }
+        }
+        std::fesetround(FE_TONEAREST);
+        SW_CHECK(ok);
+    }
+
+    // one register of LEN floats into two of doubles and back
+    template<size_t LEN>
+    void test_halves() {
+        std::array<float, LEN> values;
+        for (size_t i = 0; i < LEN; ++i) {
+            values[i] = float(i) * 1.5f - 3.25f;
+        }
+        const auto v = sw::vector<float, LEN>::load_partial(values.data());
+        const auto low = sw::convert<double>(sw::low_half(v));
+        const auto high = sw::convert<double>(sw::high_half(v));
+        const auto joined = lanes_of(sw::combine(sw::low_half(v), sw::high_half(v)));
+        const auto back = lanes_of(sw::convert<float>(low, high));
+        const auto rounded = lanes_of(sw::convert<int32_t, sw::rounding::down>(low, high));
+        const auto low_lanes = lanes_of(low);
+        const auto high_lanes = lanes_of(high);
+        bool ok = true;
+        for (size_t i = 0; i < LEN / 2; ++i) {
+            ok &= low_lanes[i] == double(values[i]);
+            ok &= high_lanes[i] == double(values[LEN / 2 + i]);
+        }
+        for (size_t i = 0; i < LEN; ++i) {
+            ok &= joined[i] == values[i] && back[i] == values[i];
+            ok &= rounded[i] == int32_t(std::floor(values[i]));
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename From, typename To>
+    void test_spans() {
+        bool ok = true;
+        for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(16), size_t(33), size_t(1027) }) {
+            std::vector<From> in(count);
+            for (size_t i = 0; i < count; ++i) {
+                in[i] = From(double(i) * 0.75 - 300.5);
+            }
+            std::vector<To> out(count + 1, To(99));
+            sw::convert<sw::rounding::up>(sw::span<const From>(in.data(), in.size()), sw::span<To>(out.data(), count));
+            for (size_t i = 0; i < count; ++i) {
+                ok &= out[i] == convert_scalar<To, sw::rounding::up>(in[i]);
+            }
+            ok &= out[count] == To(99);
+        }
+        SW_CHECK(ok);
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_all_pairs<2>();
+    test_convert<float, int32_t, 4>();
+    test_convert<int32_t, float, 3>();
+    test_edges<2>();
+    test_large_int64<2>();
+    test_rounding_mode<2>();
+    test_halves<4>();
+    test_spans<float, double>();
+    test_spans<double, float>();
+    test_spans<double, int32_t>();
+    test_spans<float, int64_t>();
+    test_spans<int64_t, double>();
+    test_spans<int32_t, float>();
+#if SW_ISA_LEVEL >= 2
+    test_all_pairs<4>();
+    test_convert<float, int32_t, 8>();
+    test_edges<4>();
+    test_large_int64<4>();
+    test_rounding_mode<4>();
+    test_halves<8>();
+#endif
+#if SW_ISA_LEVEL >= 3
+    test_all_pairs<8>();
+    test_convert<float, int32_t, 16>();
+    test_convert<int32_t, float, 16>();
+    test_edges<8>();
+    test_large_int64<8>();
+    test_rounding_mode<8>();
+    test_halves<16>();
+#endif
+    return sw_test::finish("convert_tests");
+}
@@ -0,0 +1,144 @@
+#include <cmath>
+#include <string_view>
+#include <vector>
+#include "kernels.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    void test_detection() {
+        const sw::cpu_features& features = sw::detect_cpu_features();
+        // cached, so every call hands back the same object
+        SW_CHECK(&features == &sw::detect_cpu_features());
+        const sw::isa best = sw::best_supported_isa();
+        SW_CHECK(sw::is_supported(best));
+        SW_CHECK(best < sw::isa::avx2 || (features.avx2 && features.fma));
+        SW_CHECK(best < sw::isa::avx512 || features.avx512f);
+        SW_CHECK(sw::active_isa() == best);
+        SW_CHECK(best == sw::best_supported_isa(features));
+        SW_CHECK(std::string_view(sw::isa_name(sw::isa::avx2)) == "avx2");
+    }
+
+    // every level needs all the extensions its code is compiled with, not just the headline one
+    void test_level_requirements() {
+        sw::cpu_features features;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::generic);
+        // SSE4.1 without POPCNT, e.g. a 45nm Core 2
+        features.sse41 = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::generic);
+        features.popcnt = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::sse41);
+        features.avx = features.avx2 = features.fma = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::sse41);
+        // a VM hiding BMI2 or F16C
+        features.f16c = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::sse41);
+        features.bmi2 = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::avx2);
+        features.avx512f = features.avx512bw = features.avx512dq = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::avx2);
+        features.avx512vl = true;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::avx512);
+        features.f16c = false;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::sse41);
+        features.f16c = true;
+        features.popcnt = false;
+        SW_CHECK(sw::best_supported_isa(features) == sw::isa::generic);
+    }
+
+    void check_kernels(size_t in_offset, size_t out_offset) {
+        // odd sizes to hit the head and tail of the loops
+        for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(16), size_t(37), size_t(1001) }) {
+            const size_t padded = count + 4;
+            std::vector<float> a(padded), b(padded), c(padded), out(padded, -1.0f);
+            for (size_t i = 0; i < padded; ++i) {
+                a[i] = static_cast<float>(i) * 0.5f + 1.0f;
+                b[i] = static_cast<float>(i % 13) + 2.0f;
+                c[i] = 3.0f - static_cast<float>(i);
+            }
+            const float* pa = a.data() + in_offset;
+            const float* pb = b.data() + in_offset;
+            const float* pc = c.data() + in_offset;
+            float* po = out.data() + out_offset;
+            sw::kernels::add(pa, pb, po, count);
+            for (size_t i = 0; i < count; ++i) {
+                SW_CHECK(po[i] == pa[i] + pb[i]);
+            }
+            sw::kernels::sub(pa, pb, po, count);
+            for (size_t i = 0; i < count; ++i) {
+                SW_CHECK(po[i] == pa[i] - pb[i]);
+            }
+            sw::kernels::mul(pa, pb, po, count);
+            for (size_t i = 0; i < count; ++i) {
+                SW_CHECK(po[i] == pa[i] * pb[i]);
+            }
+            sw::kernels::div(pa, pb, po, count);
+            for (size_t i = 0; i < count; ++i) {
+                SW_CHECK(po[i] == pa[i] / pb[i]);
+            }
+            sw::kernels::mul_add(pa, pb, pc, po, count);
+            for (size_t i = 0; i < count; ++i) {
+                SW_CHECK(std::fabs(po[i] - (pa[i] * pb[i] + pc[i])) <= 1e-5f * std::fabs(pa[i] * pb[i]) + 1e-5f);
+            }
+            // in place
+            sw::kernels::add(po, pb, po, count);
+            // nothing written past the end
+            SW_CHECK(po[count] == -1.0f);
+        }
+    }
+
+    void check_gemm() {
+        // several micro kernel tiles at every level, and edges on both sides
+        const size_t m = 67, n = 29, k = 41;
+        std::vector<float> a(m * k), b(k * n), c(m * n), parallel(m * n);
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = static_cast<float>(i % 7) - 3.0f;
+        }
+        for (size_t i = 0; i < b.size(); ++i) {
+            b[i] = static_cast<float>(i % 5) * 0.5f;
+        }
+        sw::kernels::gemm(m, n, k, 1.0f, a.data(), m, b.data(), k, 0.0f, c.data(), m);
+        sw::thread_pool pool(2);
+        sw::kernels::gemm(sw::execution::parallel_policy{ &pool }, m, n, k, 1.0f, a.data(), m, b.data(), k, 0.0f, parallel.data(), m);
+        bool ok = true;
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t i = 0; i < m; ++i) {
+                float expected = 0.0f;
+                for (size_t p = 0; p < k; ++p) {
+                    expected += a[i + p * m] * b[p + j * k];
+                }
+                // small integers and halves, exact in any order
+                ok &= c[i + j * m] == expected && parallel[i + j * m] == expected;
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    void test_every_level() {
+        const sw::isa initial = sw::active_isa();
+        for (sw::isa level : { sw::isa::generic, sw::isa::sse41, sw::isa::avx2, sw::isa::avx512 }) {
+            if (!sw::set_active_isa(level)) {
+                // MSVC builds have no generic kernels
+                SW_CHECK(level == sw::isa::generic || !sw::is_supported(level));
+                continue;
+            }
+            SW_CHECK(sw::active_isa() == level);
+            // matching and mismatched misalignment between inputs and output
+            check_kernels(0, 0);
+            check_kernels(1, 1);
+            check_kernels(1, 0);
+            check_kernels(3, 2);
+            check_gemm();
+        }
+        SW_CHECK(sw::set_active_isa(initial));
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_detection();
+    test_level_requirements();
+    test_every_level();
+    return sw_test::finish("dispatch_tests");
+}
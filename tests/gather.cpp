@@ -0,0 +1,145 @@
+#include <array>
+#include <vector>
+#include "gather.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    using sw_test::lanes_of;
+
+    // scattered, repeating and negative offsets into the middle of the table
+    template<typename I, size_t LEN>
+    std::array<I, LEN> make_indices(size_t round, size_t half_size) {
+        std::array<I, LEN> result;
+        for (size_t i = 0; i < LEN; ++i) {
+            const int64_t spread = int64_t((round * 31 + i * 17) % (2 * half_size - 1)) - int64_t(half_size - 1);
+            result[i] = I(i == 1 && round % 3 == 0 ? result[0] : spread);
+        }
+        return result;
+    }
+
+    template<typename T, typename I, size_t LEN>
+    void test_gather() {
+        constexpr size_t half_size = 97;
+        std::vector<T> table(2 * half_size);
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = T(i * 3 + 1);
+        }
+        const T* base = table.data() + half_size;
+        bool ok = true;
+        for (size_t round = 0; round < 16; ++round) {
+            const auto offsets = make_indices<I, LEN>(round, half_size);
+            const auto index = sw::vector<I, LEN>::load_partial(offsets.data());
+            std::array<T, LEN> fallback;
+            for (size_t i = 0; i < LEN; ++i) {
+                fallback[i] = T(1000 + i);
+            }
+            const auto src = sw::vector<T, LEN>::load_partial(fallback.data());
+            const sw::mask<T, LEN> m = sw::mask<T, LEN>::first(round % (LEN + 1)) ^ sw::mask<T, LEN>::first(round % 2);
+
+            const auto all = lanes_of(sw::gather(base, index));
+            const auto some = lanes_of(sw::gather(base, index, m, src));
+            const auto emulated = lanes_of(sw::vector<T, LEN>(sw::detail::emulated_gather_vals<T, LEN, I>(base, index(), m.bits(), src())));
+            for (size_t i = 0; i < LEN; ++i) {
+                const T expected = base[offsets[i]];
+                ok &= all[i] == expected;
+                ok &= some[i] == (m[i] ? expected : fallback[i]);
+                ok &= emulated[i] == some[i];
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, typename I, size_t LEN>
+    void test_scatter() {
+        constexpr size_t half_size = 53;
+        bool ok = true;
+        for (size_t round = 0; round < 16; ++round) {
+            std::vector<T> table(2 * half_size, T(0)), expected(2 * half_size, T(0));
+            const auto offsets = make_indices<I, LEN>(round, half_size);
+            std::array<T, LEN> values;
+            for (size_t i = 0; i < LEN; ++i) {
+                values[i] = T(round * 8 + i + 1);
+            }
+            const sw::mask<T, LEN> m = ~sw::mask<T, LEN>::first(round % 2);
+            for (size_t i = 0; i < LEN; ++i) {
+                // in lane order, the last lane of a repeated index wins
+                if (m[i]) {
+                    expected[half_size + offsets[i]] = values[i];
+                }
+            }
+            sw::scatter(table.data() + half_size, sw::vector<I, LEN>::load_partial(offsets.data()), sw::vector<T, LEN>::load_partial(values.data()), m);
+            ok &= table == expected;
+        }
+        SW_CHECK(ok);
+    }
+
+    // a lookup table over an array, with a tail that doesn't fill a register
+    template<typename T, typename I>
+    void test_bulk(size_t count) {
+        std::vector<T> table(300), out(count, T(0)), back(300, T(0));
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = T(i ^ 0x55);
+        }
+        std::vector<I> indices(count);
+        for (size_t i = 0; i < count; ++i) {
+            indices[i] = I((i * 37) % table.size());
+        }
+        sw::gather(sw::span<const T>(table.data(), table.size()), sw::span<const I>(indices.data(), count), sw::span<T>(out.data(), count));
+        bool ok = true;
+        for (size_t i = 0; i < count; ++i) {
+            ok &= out[i] == table[indices[i]];
+        }
+        sw::scatter(sw::span<const T>(out.data(), count), sw::span<const I>(indices.data(), count), sw::span<T>(back.data(), back.size()));
+        for (size_t i = 0; i < count; ++i) {
+            ok &= back[indices[i]] == table[indices[i]];
+        }
+        SW_CHECK(ok);
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_gather<float, int32_t, 4>();
+    test_gather<float, int64_t, 2>();
+    test_gather<double, int32_t, 2>();
+    test_gather<double, int64_t, 2>();
+    test_gather<int32_t, int32_t, 4>();
+    test_gather<uint64_t, int64_t, 2>();
+    test_gather<int16_t, int32_t, 4>();
+    test_gather<uint8_t, int64_t, 2>();
+    test_scatter<float, int32_t, 4>();
+    test_scatter<double, int64_t, 2>();
+    test_scatter<int32_t, int64_t, 2>();
+    test_scatter<uint8_t, int32_t, 4>();
+    test_bulk<float, int32_t>(1000);
+    test_bulk<double, int32_t>(101);
+    test_bulk<int32_t, int64_t>(77);
+    test_bulk<uint16_t, int32_t>(45);
+#if SW_ISA_LEVEL >= 2
+    test_gather<float, int32_t, 8>();
+    test_gather<float, int32_t, 7>();
+    test_gather<float, int64_t, 4>();
+    test_gather<double, int32_t, 4>();
+    test_gather<double, int64_t, 3>();
+    test_gather<int32_t, int64_t, 4>();
+    test_gather<int64_t, int32_t, 4>();
+    test_scatter<float, int32_t, 8>();
+    test_scatter<double, int32_t, 4>();
+    test_scatter<int64_t, int64_t, 4>();
+#endif
+#if SW_ISA_LEVEL >= 3
+    test_gather<float, int32_t, 16>();
+    test_gather<float, int32_t, 11>();
+    test_gather<float, int64_t, 8>();
+    test_gather<double, int32_t, 8>();
+    test_gather<double, int64_t, 8>();
+    test_gather<uint32_t, int64_t, 5>();
+    test_scatter<float, int32_t, 16>();
+    test_scatter<float, int64_t, 8>();
+    test_scatter<double, int32_t, 8>();
+    test_scatter<uint64_t, int64_t, 6>();
+#endif
+    return sw_test::finish("gather_tests");
+}
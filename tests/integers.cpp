@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "fixed_point.hpp"
+#include "integer_functions.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    using sw_test::lanes_of;
+
+#if SW_ISA_LEVEL >= 2
+    // 32 bit lanes past 4 need AVX2 registers, they used to fall back to 128 bits
+    static_assert(std::is_same_v<sw::simd_traits<int32_t, 8>::vector_type, __m256i>);
+    static_assert(std::is_same_v<sw::simd_traits<uint32_t, 6>::vector_type, __m256i>);
+    static_assert(std::is_same_v<sw::simd_traits<int64_t, 3>::vector_type, __m256i>);
+#endif
+
+    template<typename T, size_t LEN>
+    uint64_t mask_bits(sw::detail::mask_type_t<T, LEN> mask) {
+        if constexpr (std::is_integral_v<decltype(mask)>) {
+            return static_cast<uint64_t>(mask) & (LEN == 64 ? ~uint64_t(0) : (uint64_t(1) << LEN) - 1);
+        }
+        else {
+            std::array<T, sizeof(mask) / sizeof(T)> lanes;
+            std::memcpy(lanes.data(), &mask, sizeof(mask));
+            uint64_t result = 0;
+            for (size_t i = 0; i < LEN; ++i) {
+                result |= uint64_t(lanes[i] != T(0)) << i;
+            }
+            return result;
+        }
+    }
+
+    // the extremes first, then a spread of bit patterns
+    template<typename T>
+    T test_value(size_t i) {
+        switch (i) {
+        case 0:
+            return std::numeric_limits<T>::min();
+        case 1:
+            return std::numeric_limits<T>::max();
+        case 2:
+            return T(0);
+        case 3:
+            return T(-1);
+        default:
+            uint64_t x = i * 0x9E3779B97F4A7C15ull;
+            x ^= x >> 29;
+            return T(x >> (i % 48));
+        }
+    }
+
+    template<typename T, size_t LEN>
+    sw::vector<T, LEN> make_vector(size_t offset, std::array<T, LEN>& values) {
+        for (size_t i = 0; i < LEN; ++i) {
+            values[i] = test_value<T>(offset + i);
+        }
+        return sw::vector<T, LEN>::load_partial(values.data());
+    }
+
+    // wrapping product, both halves
+    template<typename T>
+    T low_product(T a, T b) {
+        return T(uint64_t(a) * uint64_t(b));
+    }
+
+    template<typename T>
+    T high_product(T a, T b) {
+        using wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        return T((wide(a) * wide(b)) >> (sizeof(T) * 8));
+    }
+
+    template<typename T, size_t LEN>
+    void test_compare_min_max() {
+        using sw::detail::compare_op;
+        bool ok = true;
+        for (size_t round = 0; round < 16; ++round) {
+            std::array<T, LEN> lhs, rhs;
+            const auto a = make_vector<T, LEN>(round * 3, lhs);
+            auto b = make_vector<T, LEN>(round * 5 + 1, rhs);
+            if (round % 4 == 0) {
+                // some equal lanes too
+                rhs = lhs;
+                rhs[0] = T(rhs[0] + 1);
+                b = sw::vector<T, LEN>::load_partial(rhs.data());
+            }
+            uint64_t eq = 0, neq = 0, lt = 0, le = 0, gt = 0, ge = 0;
+            for (size_t i = 0; i < LEN; ++i) {
+                eq |= uint64_t(lhs[i] == rhs[i]) << i;
+                neq |= uint64_t(lhs[i] != rhs[i]) << i;
+                lt |= uint64_t(lhs[i] < rhs[i]) << i;
+                le |= uint64_t(lhs[i] <= rhs[i]) << i;
+                gt |= uint64_t(lhs[i] > rhs[i]) << i;
+                ge |= uint64_t(lhs[i] >= rhs[i]) << i;
+            }
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::eq>(a(), b())) == eq;
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::neq>(a(), b())) == neq;
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::lt>(a(), b())) == lt;
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::le>(a(), b())) == le;
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::gt>(a(), b())) == gt;
+            ok &= mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::ge>(a(), b())) == ge;
+
+            const auto lowest = lanes_of(sw::min(a, b));
+            const auto highest = lanes_of(sw::max(a, b));
+            const auto magnitude = lanes_of(sw::abs(a));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= lowest[i] == std::min(lhs[i], rhs[i]);
+                ok &= highest[i] == std::max(lhs[i], rhs[i]);
+                // the most negative value has no positive counterpart and stays
+                const T expected = std::is_signed_v<T> && lhs[i] < T(0) ? T(uint64_t(0) - uint64_t(lhs[i])) : lhs[i];
+                ok &= magnitude[i] == expected;
+            }
+            ok &= sw::reduce_min(a) == *std::min_element(lhs.begin(), lhs.end());
+            ok &= sw::reduce_max(a) == *std::max_element(lhs.begin(), lhs.end());
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, size_t LEN>
+    void test_multiply() {
+        bool ok = true;
+        for (size_t round = 0; round < 16; ++round) {
+            std::array<T, LEN> lhs, rhs;
+            const auto a = make_vector<T, LEN>(round * 7, lhs);
+            const auto b = make_vector<T, LEN>(round * 11 + 2, rhs);
+            const auto low = lanes_of(sw::mullo(a, b));
+            const auto product = lanes_of(sw::vector<T, LEN>(a * b));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= low[i] == low_product(lhs[i], rhs[i]);
+                ok &= product[i] == low[i];
+            }
+            if constexpr (sizeof(T) <= 4) {
+                const auto high = lanes_of(sw::mulhi(a, b));
+                for (size_t i = 0; i < LEN; ++i) {
+                    ok &= high[i] == high_product(lhs[i], rhs[i]);
+                }
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, size_t LEN>
+    void test_shifts() {
+        constexpr int bits = int(sizeof(T) * 8);
+        std::array<T, LEN> values;
+        const auto a = make_vector<T, LEN>(0, values);
+        bool ok = true;
+        for (int count = 0; count <= bits + 1; ++count) {
+            const auto left = lanes_of(sw::shift_left(a, count));
+            const auto right = lanes_of(sw::shift_right(a, count));
+            for (size_t i = 0; i < LEN; ++i) {
+                const T expected_left = count >= bits ? T(0) : T(uint64_t(values[i]) << count);
+                T expected_right;
+                if (count >= bits) {
+                    expected_right = values[i] < T(0) ? T(-1) : T(0);
+                }
+                else {
+                    expected_right = T(values[i] >> count);
+                }
+                ok &= left[i] == expected_left;
+                ok &= right[i] == expected_right;
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, size_t LEN>
+    void test_divider() {
+        std::array<T, 24> divisors = { T(1), T(2), T(3), T(5), T(7), T(10), T(64), T(100), T(641), T(1000003),
+            std::numeric_limits<T>::max(), T(std::numeric_limits<T>::max() - 1), T(T(1) << 30), T(0x7FFF), T(6700417) };
+        if constexpr (std::is_signed_v<T>) {
+            const T negative[] = { T(-1), T(-2), T(-3), T(-7), T(-1000003), std::numeric_limits<T>::min(), T(std::numeric_limits<T>::min() + 1), T(-(T(1) << 20)), T(-6) };
+            std::copy(std::begin(negative), std::end(negative), divisors.begin() + 15);
+        }
+        else {
+            const T large[] = { T(0x80000000u), T(0x80000001u), T(0xFFFFFFFEu), T(0xC0000000u), T(3000000000u), T(12), T(24), T(1u << 31 >> 3), T(9) };
+            std::copy(std::begin(large), std::end(large), divisors.begin() + 15);
+        }
+        bool ok = true;
+        for (T d : divisors) {
+            const sw::divider<T> divider(d);
+            for (size_t round = 0; round < 64; ++round) {
+                std::array<T, LEN> values;
+                const auto n = make_vector<T, LEN>(round * LEN, values);
+                const auto quotients = lanes_of(sw::vector<T, LEN>(n / divider));
+                for (size_t i = 0; i < LEN; ++i) {
+                    if (std::is_signed_v<T> && values[i] == std::numeric_limits<T>::min() && d == T(-1)) {
+                        ok &= quotients[i] == values[i] && divider.divide(values[i]) == values[i];
+                        continue;
+                    }
+                    ok &= quotients[i] == T(values[i] / d);
+                    ok &= divider.divide(values[i]) == T(values[i] / d);
+                }
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T>
+    T saturate(int64_t x) {
+        return T(std::clamp<int64_t>(x, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+    }
+
+    template<typename T, size_t LEN>
+    void test_saturating() {
+        bool ok = true;
+        for (size_t round = 0; round < 16; ++round) {
+            std::array<T, LEN> lhs, rhs;
+            const auto a = make_vector<T, LEN>(round * 3, lhs);
+            const auto b = make_vector<T, LEN>(round * 5 + 1, rhs);
+            const auto sums = lanes_of(sw::adds(a, b));
+            const auto differences = lanes_of(sw::subs(a, b));
+            const auto averages = lanes_of(sw::avg(a, b));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= sums[i] == saturate<T>(int64_t(lhs[i]) + rhs[i]);
+                ok &= differences[i] == saturate<T>(int64_t(lhs[i]) - rhs[i]);
+                // floor division, the halves of negative sums round down too
+                const int64_t sum = int64_t(lhs[i]) + rhs[i] + 1;
+                ok &= averages[i] == T(sum >= 0 ? sum / 2 : (sum - 1) / 2);
+            }
+            if constexpr (std::is_same_v<T, int16_t>) {
+                const auto rounded = lanes_of(sw::mulhrs(a, b));
+                for (size_t i = 0; i < LEN; ++i) {
+                    ok &= rounded[i] == T((int32_t(lhs[i]) * rhs[i] + 0x4000) >> 15);
+                }
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    // pack_saturate and back through widen, on whole registers
+    template<typename T, typename To, size_t LEN>
+    void test_pack_widen() {
+        bool ok = true;
+        for (size_t round = 0; round < 8; ++round) {
+            std::array<T, LEN> lhs, rhs;
+            const auto a = make_vector<T, LEN>(round * 7, lhs);
+            const auto b = make_vector<T, LEN>(round * 7 + LEN, rhs);
+            const auto packed = sw::pack_saturate<To>(a, b);
+            const auto narrow = lanes_of(packed);
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= narrow[i] == saturate<To>(int64_t(lhs[i]));
+                ok &= narrow[LEN + i] == saturate<To>(int64_t(rhs[i]));
+            }
+            const auto low = lanes_of(sw::widen_low(packed));
+            const auto high = lanes_of(sw::widen_high(packed));
+            for (size_t i = 0; i < LEN; ++i) {
+                ok &= low[i] == narrow[i] && high[i] == narrow[LEN + i];
+            }
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, size_t LEN>
+    void test_fixed_point() {
+        using fixed = sw::fixed_point<T, LEN>;
+        constexpr double one = double(1 << fixed::fraction_bits);
+        bool ok = fixed::to_raw(0.5f) == T(one / 2) && fixed::to_raw(1.0f) == std::numeric_limits<T>::max() &&
+            fixed::to_raw(-1.0f) == std::numeric_limits<T>::min() && fixed::to_raw(-3.0f) == std::numeric_limits<T>::min() &&
+            fixed::to_float(T(one / 4)) == 0.25f;
+        for (size_t round = 0; round < 16; ++round) {
+            std::array<T, LEN> lhs, rhs, product, sum, negated;
+            const auto a = fixed(make_vector<T, LEN>(round * 3, lhs));
+            const auto b = fixed(make_vector<T, LEN>(round * 5 + 2, rhs));
+            (a * b).store(product.data());
+            (a + b).store(sum.data());
+            (-a).store(negated.data());
+            for (size_t i = 0; i < LEN; ++i) {
+                const double exact = double(lhs[i]) * double(rhs[i]) / one;
+                ok &= product[i] == saturate<T>(int64_t(std::floor(exact + 0.5)));
+                ok &= sum[i] == saturate<T>(int64_t(lhs[i]) + rhs[i]);
+                ok &= negated[i] == saturate<T>(-int64_t(lhs[i]));
+            }
+        }
+        // half of a half is a quarter
+        std::array<T, LEN> quarter;
+        (fixed(0.5f) * fixed(0.5f)).store(quarter.data());
+        ok &= quarter[LEN - 1] == T(one / 4);
+        SW_CHECK(ok);
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_compare_min_max<int8_t, 16>();
+    test_compare_min_max<uint8_t, 13>();
+    test_compare_min_max<int16_t, 8>();
+    test_compare_min_max<uint16_t, 8>();
+    test_compare_min_max<int32_t, 4>();
+    test_compare_min_max<uint32_t, 3>();
+    test_compare_min_max<int64_t, 2>();
+    test_compare_min_max<uint64_t, 2>();
+    test_multiply<int16_t, 8>();
+    test_multiply<uint16_t, 8>();
+    test_multiply<int32_t, 4>();
+    test_multiply<uint32_t, 4>();
+    test_multiply<int64_t, 2>();
+    test_multiply<uint64_t, 1>();
+    test_shifts<int16_t, 8>();
+    test_shifts<uint16_t, 8>();
+    test_shifts<int32_t, 4>();
+    test_shifts<uint32_t, 4>();
+    test_shifts<int64_t, 2>();
+    test_shifts<uint64_t, 2>();
+    test_divider<uint32_t, 4>();
+    test_divider<int32_t, 4>();
+    test_saturating<int8_t, 16>();
+    test_saturating<uint8_t, 16>();
+    test_saturating<int16_t, 8>();
+    test_saturating<uint16_t, 5>();
+    test_pack_widen<int16_t, int8_t, 8>();
+    test_pack_widen<int16_t, uint8_t, 8>();
+    test_pack_widen<uint16_t, uint8_t, 8>();
+    test_pack_widen<int32_t, int16_t, 4>();
+    test_pack_widen<int32_t, uint16_t, 4>();
+    test_pack_widen<uint32_t, uint16_t, 4>();
+    test_fixed_point<int16_t, 8>();
+    test_fixed_point<int16_t, 5>();
+    test_fixed_point<int8_t, 16>();
+    test_fixed_point<int8_t, 9>();
+#if SW_ISA_LEVEL >= 2
+    test_compare_min_max<int8_t, 32>();
+    test_compare_min_max<uint16_t, 11>();
+    test_compare_min_max<int32_t, 8>();
+    test_compare_min_max<uint32_t, 7>();
+    test_compare_min_max<int64_t, 4>();
+    test_compare_min_max<uint64_t, 3>();
+    test_multiply<int32_t, 8>();
+    test_multiply<uint16_t, 16>();
+    test_multiply<int64_t, 4>();
+    test_shifts<int32_t, 8>();
+    test_shifts<int64_t, 4>();
+    test_shifts<uint64_t, 3>();
+    test_divider<uint32_t, 8>();
+    test_divider<int32_t, 8>();
+    test_saturating<int8_t, 32>();
+    test_saturating<int16_t, 16>();
+    test_pack_widen<int16_t, int8_t, 16>();
+    test_pack_widen<uint32_t, uint16_t, 8>();
+    test_fixed_point<int16_t, 16>();
+    test_fixed_point<int8_t, 32>();
+    test_fixed_point<int8_t, 20>();
+#endif
+#if SW_ISA_LEVEL >= 3
+    test_compare_min_max<uint8_t, 64>();
+    test_compare_min_max<int16_t, 32>();
+    test_compare_min_max<int32_t, 16>();
+    test_compare_min_max<uint64_t, 8>();
+    test_multiply<int32_t, 16>();
+    test_multiply<uint64_t, 8>();
+    test_shifts<int16_t, 32>();
+    test_shifts<int64_t, 8>();
+    test_divider<uint32_t, 16>();
+    test_divider<int32_t, 13>();
+    test_saturating<uint8_t, 64>();
+    test_saturating<int16_t, 32>();
+    test_pack_widen<int16_t, uint8_t, 32>();
+    test_pack_widen<int32_t, int16_t, 16>();
+    test_fixed_point<int16_t, 32>();
+    test_fixed_point<int8_t, 64>();
+#endif
+    return sw_test::finish("integer_tests");
+}
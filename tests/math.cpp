@@ -0,0 +1,285 @@
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include "vector_functions.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    // float is checked against double, double against long double
+    template<typename T>
+    using reference_t = std::conditional_t<std::is_same_v<T, float>, double, long double>;
+
+    template<typename T>
+    long double ulp_error(T result, long double reference) {
+        if (std::isnan(reference)) {
+            return std::isnan(result) ? 0.0L : std::numeric_limits<long double>::infinity();
+        }
+        const T rounded = static_cast<T>(reference);
+        if (std::isinf(rounded) || std::isinf(result)) {
+            return result == rounded ? 0.0L : std::numeric_limits<long double>::infinity();
+        }
+        const T magnitude = std::fabs(rounded);
+        const T ulp = magnitude < std::numeric_limits<T>::min() ? std::numeric_limits<T>::denorm_min() :
+            std::nextafter(magnitude, std::numeric_limits<T>::infinity()) - magnitude;
+        return std::fabs(static_cast<long double>(result) - reference) / static_cast<long double>(ulp);
+    }
+
+    template<typename T, size_t LEN, typename Fn>
+    std::vector<T> apply(std::vector<T> const& x, Fn fn) {
+        std::vector<T> result(x.size());
+        for (size_t i = 0; i < x.size(); i += LEN) {
+            const size_t count = x.size() - i < LEN ? x.size() - i : LEN;
+            fn(sw::vector<T, LEN>::load_partial(x.data() + i, count)).store_partial(result.data() + i, count);
+        }
+        return result;
+    }
+
+    template<typename T, size_t LEN, typename Fn>
+    std::vector<T> apply(std::vector<T> const& x, std::vector<T> const& y, Fn fn) {
+        std::vector<T> result(x.size());
+        for (size_t i = 0; i < x.size(); i += LEN) {
+            const size_t count = x.size() - i < LEN ? x.size() - i : LEN;
+            fn(sw::vector<T, LEN>::load_partial(x.data() + i, count), sw::vector<T, LEN>::load_partial(y.data() + i, count))
+                .store_partial(result.data() + i, count);
+        }
+        return result;
+    }
+
+    template<typename T>
+    std::vector<T> uniform(T lo, T hi, size_t count, unsigned seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<T> dist(lo, hi);
+        std::vector<T> result(count);
+        for (T& v : result) {
+            v = dist(rng);
+        }
+        return result;
+    }
+
+    // spread over the exponents between 2^lo and 2^hi
+    template<typename T>
+    std::vector<T> log_uniform(int lo, int hi, size_t count, unsigned seed) {
+        std::vector<T> result = uniform<T>(T(lo), T(hi), count, seed);
+        for (T& v : result) {
+            v = std::exp2(v);
+        }
+        return result;
+    }
+
+    template<typename T, typename Reference>
+    long double max_error(std::vector<T> const& results, std::vector<T> const& x, Reference reference) {
+        long double worst = 0.0L;
+        for (size_t i = 0; i < x.size(); ++i) {
+            worst = std::max(worst, ulp_error(results[i], reference(static_cast<reference_t<T>>(x[i]))));
+        }
+        return worst;
+    }
+
+    template<typename T, typename Reference>
+    long double max_error(std::vector<T> const& results, std::vector<T> const& x, std::vector<T> const& y, Reference reference) {
+        long double worst = 0.0L;
+        for (size_t i = 0; i < x.size(); ++i) {
+            worst = std::max(worst, ulp_error(results[i], reference(static_cast<reference_t<T>>(x[i]), static_cast<reference_t<T>>(y[i]))));
+        }
+        return worst;
+    }
+
+    template<typename T, size_t LEN>
+    void test_accuracy() {
+        using R = reference_t<T>;
+        constexpr size_t count = 20000;
+        constexpr bool is_float = std::is_same_v<T, float>;
+
+        const std::vector<T> exp_x = uniform<T>(is_float ? T(-87) : T(-708), is_float ? T(88) : T(709), count, 1);
+        SW_CHECK(max_error(apply<T, LEN>(exp_x, [](auto const& v) { return sw::exp(v); }), exp_x, [](R v) { return std::exp(v); }) <= 1.0L);
+        const std::vector<T> small_x = uniform<T>(T(-1), T(1), count, 2);
+        SW_CHECK(max_error(apply<T, LEN>(small_x, [](auto const& v) { return sw::exp(v); }), small_x, [](R v) { return std::exp(v); }) <= 1.0L);
+        const std::vector<T> exp2_x = uniform<T>(is_float ? T(-126) : T(-1022), is_float ? T(127) : T(1023), count, 3);
+        SW_CHECK(max_error(apply<T, LEN>(exp2_x, [](auto const& v) { return sw::exp2(v); }), exp2_x, [](R v) { return std::exp2(v); }) <= 1.0L);
+
+        const std::vector<T> log_x = log_uniform<T>(is_float ? -149 : -1074, is_float ? 127 : 1023, count, 4);
+        SW_CHECK(max_error(apply<T, LEN>(log_x, [](auto const& v) { return sw::log(v); }), log_x, [](R v) { return std::log(v); }) <= 2.0L);
+        SW_CHECK(max_error(apply<T, LEN>(log_x, [](auto const& v) { return sw::log2(v); }), log_x, [](R v) { return std::log2(v); }) <= 2.0L);
+        // around 1 the result loses its leading bits, the worst case for the reduction
+        const std::vector<T> near_one = uniform<T>(T(0.5), T(2), count, 5);
+        SW_CHECK(max_error(apply<T, LEN>(near_one, [](auto const& v) { return sw::log(v); }), near_one, [](R v) { return std::log(v); }) <= 2.0L);
+        SW_CHECK(max_error(apply<T, LEN>(near_one, [](auto const& v) { return sw::log2(v); }), near_one, [](R v) { return std::log2(v); }) <= 2.0L);
+
+        const T trig_range = is_float ? T(8192) : T(16777216);
+        for (T range : { T(3.2), trig_range }) {
+            const std::vector<T> x = uniform<T>(-range, range, count, 6);
+            SW_CHECK(max_error(apply<T, LEN>(x, [](auto const& v) { return sw::sin(v); }), x, [](R v) { return std::sin(v); }) <= 2.0L);
+            SW_CHECK(max_error(apply<T, LEN>(x, [](auto const& v) { return sw::cos(v); }), x, [](R v) { return std::cos(v); }) <= 2.0L);
+            SW_CHECK(max_error(apply<T, LEN>(x, [](auto const& v) { return sw::tan(v); }), x, [](R v) { return std::tan(v); }) <= 4.0L);
+            // sincos has to match the separate functions exactly
+            const std::vector<T> s = apply<T, LEN>(x, [](auto const& v) { return sw::sincos(v).first; });
+            const std::vector<T> c = apply<T, LEN>(x, [](auto const& v) { return sw::sincos(v).second; });
+            SW_CHECK((s == apply<T, LEN>(x, [](auto const& v) { return sw::sin(v); })));
+            SW_CHECK((c == apply<T, LEN>(x, [](auto const& v) { return sw::cos(v); })));
+        }
+        // past the reduction limit up to the largest finite values, mixed with small lanes in the same registers
+        std::vector<T> large_x = log_uniform<T>(is_float ? 13 : 24, is_float ? 127 : 1023, count, 10);
+        for (size_t i = 0; i < count; i += 3) {
+            large_x[i] = small_x[i];
+        }
+        for (size_t i = 1; i < count; i += 2) {
+            large_x[i] = -large_x[i];
+        }
+        SW_CHECK(max_error(apply<T, LEN>(large_x, [](auto const& v) { return sw::sin(v); }), large_x, [](R v) { return std::sin(v); }) <= 2.0L);
+        SW_CHECK(max_error(apply<T, LEN>(large_x, [](auto const& v) { return sw::cos(v); }), large_x, [](R v) { return std::cos(v); }) <= 2.0L);
+        SW_CHECK(max_error(apply<T, LEN>(large_x, [](auto const& v) { return sw::tan(v); }), large_x, [](R v) { return std::tan(v); }) <= 4.0L);
+        SW_CHECK((apply<T, LEN>(large_x, [](auto const& v) { return sw::sincos(v).first; }) == apply<T, LEN>(large_x, [](auto const& v) { return sw::sin(v); })));
+        SW_CHECK((apply<T, LEN>(large_x, [](auto const& v) { return sw::sincos(v).second; }) == apply<T, LEN>(large_x, [](auto const& v) { return sw::cos(v); })));
+
+        const std::vector<T> ay = uniform<T>(T(-10), T(10), count, 7);
+        const std::vector<T> ax = uniform<T>(T(-10), T(10), count, 8);
+        SW_CHECK(max_error(apply<T, LEN>(ay, ax, [](auto const& a, auto const& b) { return sw::atan2(a, b); }), ay, ax,
+            [](R a, R b) { return std::atan2(a, b); }) <= 4.0L);
+
+        // results over the whole exponent range, float gets its core in double
+        const std::vector<T> px = log_uniform<T>(-20, 20, count, 9);
+        const std::vector<T> py = uniform<T>(T(-5), T(5), count, 10);
+        const long double pow_error = max_error(apply<T, LEN>(px, py, [](auto const& a, auto const& b) { return sw::pow(a, b); }), px, py,
+            [](R a, R b) { return std::pow(a, b); });
+        // double: about 1 + |y * log2(x)| / 2 ulp, |y * log2(x)| stays below 100 here
+        SW_CHECK(pow_error <= (is_float ? 1.0L : 51.0L));
+    }
+
+    template<typename T>
+    long double relative_error(T result, long double reference) {
+        return std::fabs(static_cast<long double>(result) - reference) / std::fabs(reference);
+    }
+
+    template<typename T, size_t LEN>
+    void test_precision() {
+        using R = reference_t<T>;
+        constexpr size_t count = 20000;
+        const std::vector<T> x = log_uniform<T>(-60, 60, count, 11);
+        const std::vector<T> y = uniform<T>(T(-100), T(100), count, 12);
+        const auto rcp = [](R v) { return R(1) / v; };
+        const auto rsqrt = [](R v) { return R(1) / std::sqrt(v); };
+        const auto div = [](R a, R b) { return a / b; };
+
+        // the estimate: 1.5 * 2^-12 relative error at worst, 2^-14 with AVX-512
+        const std::vector<T> fast_rcp = apply<T, LEN>(x, [](auto const& v) { return sw::rcp<sw::precision::fast>(v); });
+        const std::vector<T> fast_rsqrt = apply<T, LEN>(x, [](auto const& v) { return sw::rsqrt<sw::precision::fast>(v); });
+        const std::vector<T> fast_div = apply<T, LEN>(y, x, [](auto const& a, auto const& b) { return sw::div<sw::precision::fast>(a, b); });
+        long double fast_error = 0.0L;
+        for (size_t i = 0; i < count; ++i) {
+            fast_error = std::max(fast_error, relative_error(fast_rcp[i], rcp(x[i])));
+            fast_error = std::max(fast_error, relative_error(fast_rsqrt[i], rsqrt(x[i])));
+            fast_error = std::max(fast_error, relative_error(fast_div[i], div(y[i], x[i])));
+        }
+        SW_CHECK(fast_error <= 1.5L / 4096.0L);
+
+        SW_CHECK(max_error(apply<T, LEN>(x, [](auto const& v) { return sw::rcp<sw::precision::refined>(v); }), x, rcp) <= 3.0L);
+        SW_CHECK(max_error(apply<T, LEN>(x, [](auto const& v) { return sw::rsqrt<sw::precision::refined>(v); }), x, rsqrt) <= 3.0L);
+        SW_CHECK(max_error(apply<T, LEN>(y, x, [](auto const& a, auto const& b) { return sw::div<sw::precision::refined>(a, b); }), y, x, div) <= 2.0L);
+
+        // exact is the plain operations, bit for bit
+        const std::vector<T> exact_rsqrt = apply<T, LEN>(x, [](auto const& v) { return sw::rsqrt(v); });
+        const std::vector<T> exact_div = apply<T, LEN>(y, x, [](auto const& a, auto const& b) { return sw::div(a, b); });
+        bool same = true;
+        for (size_t i = 0; i < count; ++i) {
+            same &= exact_rsqrt[i] == T(1) / std::sqrt(x[i]) && exact_div[i] == y[i] / x[i];
+        }
+        SW_CHECK(same);
+    }
+
+    template<typename T, size_t LEN>
+    bool lanes_are(sw::vector<T, LEN> const& v, T expected) {
+        T lanes[LEN];
+        v.store_partial(lanes);
+        for (T lane : lanes) {
+            const bool same = std::isnan(expected) ? std::isnan(lane) : lane == expected && std::signbit(lane) == std::signbit(expected);
+            if (!same) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T, size_t LEN>
+    void test_special_values() {
+        using vec = sw::vector<T, LEN>;
+        constexpr T inf = std::numeric_limits<T>::infinity();
+        constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+
+        SW_CHECK((lanes_are(sw::exp(vec(T(0))), T(1))));
+        SW_CHECK((lanes_are(sw::exp(vec(inf)), inf)));
+        SW_CHECK((lanes_are(sw::exp(vec(-inf)), T(0))));
+        SW_CHECK((lanes_are(sw::exp(vec(T(1000))), inf)));
+        SW_CHECK((lanes_are(sw::exp(vec(nan)), nan)));
+        SW_CHECK((lanes_are(sw::exp2(vec(T(-3))), T(0.125))));
+        // subnormal results round once
+        SW_CHECK((lanes_are(sw::exp2(vec(T(std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits))), std::numeric_limits<T>::denorm_min())));
+
+        SW_CHECK((lanes_are(sw::log(vec(T(1))), T(0))));
+        SW_CHECK((lanes_are(sw::log(vec(T(0))), -inf)));
+        SW_CHECK((lanes_are(sw::log(vec(-T(0))), -inf)));
+        SW_CHECK((lanes_are(sw::log(vec(T(-1))), nan)));
+        SW_CHECK((lanes_are(sw::log(vec(inf)), inf)));
+        SW_CHECK((lanes_are(sw::log(vec(nan)), nan)));
+        SW_CHECK((lanes_are(sw::log2(vec(T(1024))), T(10))));
+        SW_CHECK((lanes_are(sw::log2(vec(std::numeric_limits<T>::denorm_min())), T(std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits))));
+
+        SW_CHECK((lanes_are(sw::sin(vec(-T(0))), -T(0))));
+        SW_CHECK((lanes_are(sw::cos(vec(T(0))), T(1))));
+        SW_CHECK((lanes_are(sw::sin(vec(inf)), nan)));
+        SW_CHECK((lanes_are(sw::tan(vec(-T(0))), -T(0))));
+        // past the reduction limit, these come from the C library as they are
+        const T large = std::is_same_v<T, float> ? T(1e7) : T(1e20);
+        SW_CHECK((lanes_are(sw::sin(vec(large)), std::sin(large))));
+        SW_CHECK((lanes_are(sw::cos(vec(std::numeric_limits<T>::max())), std::cos(std::numeric_limits<T>::max()))));
+
+        SW_CHECK((lanes_are(sw::atan2(vec(T(0)), vec(T(0))), T(0))));
+        SW_CHECK((lanes_are(sw::atan2(vec(-T(0)), vec(T(0))), -T(0))));
+        SW_CHECK((lanes_are(sw::atan2(vec(T(0)), vec(-T(0))), T(3.14159265358979323846))));
+        SW_CHECK((lanes_are(sw::atan2(vec(inf), vec(inf)), T(0.785398163397448309616))));
+        SW_CHECK((lanes_are(sw::atan2(vec(T(-1)), vec(-inf)), -T(3.14159265358979323846))));
+        SW_CHECK((lanes_are(sw::atan2(vec(nan), vec(T(1))), nan)));
+
+        SW_CHECK((lanes_are(sw::pow(vec(T(2)), T(10)), T(1024))));
+        SW_CHECK((lanes_are(sw::pow(vec(T(-2)), T(3)), T(-8))));
+        SW_CHECK((lanes_are(sw::pow(vec(T(-2)), T(0.5)), nan)));
+        SW_CHECK((lanes_are(sw::pow(vec(nan), T(0)), T(1))));
+        SW_CHECK((lanes_are(sw::pow(vec(T(1)), nan), T(1))));
+        SW_CHECK((lanes_are(sw::pow(vec(T(-1)), inf), T(1))));
+        SW_CHECK((lanes_are(sw::pow(vec(-T(0)), T(-1)), -inf)));
+        SW_CHECK((lanes_are(sw::pow(vec(-T(0)), T(0.5)), T(0))));
+        SW_CHECK((lanes_are(sw::pow(vec(-inf), T(0.5)), inf)));
+        SW_CHECK((lanes_are(sw::pow(vec(T(0.5)), -inf), inf)));
+        SW_CHECK((lanes_are(sw::pow(vec(T(2)), vec(T(-1))), T(0.5))));
+
+        // refined keeps the limits of the estimate
+        SW_CHECK((lanes_are(sw::rcp<sw::precision::refined>(vec(T(0))), inf)));
+        SW_CHECK((lanes_are(sw::rcp<sw::precision::refined>(vec(-inf)), -T(0))));
+        SW_CHECK((lanes_are(sw::rsqrt<sw::precision::refined>(vec(T(0))), inf)));
+        SW_CHECK((lanes_are(sw::rsqrt<sw::precision::refined>(vec(inf)), T(0))));
+        SW_CHECK((lanes_are(sw::rsqrt<sw::precision::refined>(vec(T(-1))), nan)));
+        SW_CHECK((lanes_are(sw::sqrt(vec(T(16))), T(4))));
+
+        // expressions go in directly
+        const vec a(T(0.5));
+        SW_CHECK((lanes_are(sw::log(a * T(2)), T(0))));
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_accuracy<float, sw::native_length<float>>();
+    test_accuracy<double, sw::native_length<double>>();
+    test_accuracy<float, 3>();
+    test_precision<float, sw::native_length<float>>();
+    test_precision<double, sw::native_length<double>>();
+    test_precision<float, 4>();
+    test_special_values<float, sw::native_length<float>>();
+    test_special_values<double, sw::native_length<double>>();
+    test_special_values<float, 3>();
+    test_special_values<double, 2>();
+    return sw_test::finish("math_tests");
+}
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "matrix.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    // column major, like matrix::load
+    template<typename T, size_t R, size_t C>
+    struct reference_matrix {
+        T elements[R * C];
+
+        T& at(size_t row, size_t col) {
+            return elements[col * R + row];
+        }
+
+        T at(size_t row, size_t col) const {
+            return elements[col * R + row];
+        }
+    };
+
+    template<typename T, size_t R, size_t C>
+    reference_matrix<T, R, C> make_reference(T seed) {
+        reference_matrix<T, R, C> result;
+        for (size_t i = 0; i < R * C; ++i) {
+            result.elements[i] = std::sin(seed + T(i * i) * T(0.37)) * T(2);
+        }
+        return result;
+    }
+
+    template<typename T, size_t R, size_t K, size_t C>
+    reference_matrix<T, R, C> multiply(reference_matrix<T, R, K> const& a, reference_matrix<T, K, C> const& b) {
+        reference_matrix<T, R, C> result;
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                T sum = T(0);
+                for (size_t k = 0; k < K; ++k) {
+                    sum += a.at(i, k) * b.at(k, j);
+                }
+                result.at(i, j) = sum;
+            }
+        }
+        return result;
+    }
+
+    template<typename T, size_t R, size_t C>
+    bool near(sw::matrix<T, R, C> const& m, reference_matrix<T, R, C> const& expected, T tolerance) {
+        bool ok = true;
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                ok &= std::fabs(m(i, j) - expected.at(i, j)) <= tolerance * (T(1) + std::fabs(expected.at(i, j)));
+            }
+        }
+        return ok;
+    }
+
+    template<typename T, size_t N>
+    void test_square(T tolerance) {
+        const auto ra = make_reference<T, N, N>(T(0.5));
+        const auto rb = make_reference<T, N, N>(T(-2));
+        const auto a = sw::matrix<T, N, N>::load(ra.elements);
+        const auto b = sw::matrix<T, N, N>::load(rb.elements);
+
+        T stored[N * N];
+        a.store(stored);
+        bool ok = true;
+        for (size_t i = 0; i < N * N; ++i) {
+            ok &= stored[i] == ra.elements[i];
+        }
+        SW_CHECK(ok);
+        SW_CHECK(a(1, 2) == ra.at(1, 2));
+        const auto identity = sw::matrix<T, N, N>::identity();
+        SW_CHECK(identity(1, 1) == T(1) && identity(0, 1) == T(0));
+
+        SW_CHECK(near(a * b, multiply(ra, rb), tolerance));
+        SW_CHECK(near(a * identity, ra, T(0)));
+
+        reference_matrix<T, N, N> rt;
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                rt.at(i, j) = ra.at(j, i);
+            }
+        }
+        SW_CHECK(near(sw::transpose(a), rt, T(0)));
+
+        // matrix * vector is the first column of a * [v 0 ...]
+        T lanes[N] = {};
+        for (size_t k = 0; k < N; ++k) {
+            lanes[k] = T(k) - T(1.5);
+        }
+        const sw::vector<T, N> mv = a * sw::vector<T, N>::load_partial(lanes);
+        T result[N];
+        mv.store_partial(result);
+        ok = true;
+        for (size_t i = 0; i < N; ++i) {
+            T expected = T(0);
+            for (size_t k = 0; k < N; ++k) {
+                expected += ra.at(i, k) * lanes[k];
+            }
+            ok &= std::fabs(result[i] - expected) <= tolerance * (T(1) + std::fabs(expected));
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T>
+    void test_inverse(T tolerance) {
+        using mat = sw::mat4<T>;
+        const reference_matrix<T, 4, 4> identity = [] {
+            reference_matrix<T, 4, 4> result{};
+            for (size_t i = 0; i < 4; ++i) {
+                result.at(i, i) = T(1);
+            }
+            return result;
+        }();
+
+        // rotation about z, non uniform scale, shear and translation
+        reference_matrix<T, 4, 4> affine = identity;
+        affine.at(0, 0) = T(0.8) * T(2); affine.at(0, 1) = T(-0.6) * T(0.5); affine.at(0, 2) = T(0.25);
+        affine.at(1, 0) = T(0.6) * T(2); affine.at(1, 1) = T(0.8) * T(0.5);
+        affine.at(2, 2) = T(3);
+        affine.at(0, 3) = T(10); affine.at(1, 3) = T(-4); affine.at(2, 3) = T(0.5);
+        const mat m = mat::load(affine.elements);
+        SW_CHECK(near(m * sw::inverse_affine(m), identity, tolerance));
+        SW_CHECK(near(sw::inverse_affine(m) * m, identity, tolerance));
+        SW_CHECK(near(sw::inverse(m) * m, identity, tolerance));
+        // the determinant of the 3x3 part is 2 * 0.5 * 3
+        SW_CHECK(std::fabs(sw::determinant(m) - T(3)) <= tolerance * T(3));
+
+        // general matrix with a projective last row
+        const auto general = make_reference<T, 4, 4>(T(0.3));
+        const mat g = mat::load(general.elements);
+        SW_CHECK(near(g * sw::inverse(g), identity, tolerance * T(16)));
+        SW_CHECK(near(sw::inverse(g) * g, identity, tolerance * T(16)));
+
+        // two equal columns
+        reference_matrix<T, 4, 4> singular = general;
+        for (size_t i = 0; i < 4; ++i) {
+            singular.at(i, 3) = singular.at(i, 0);
+        }
+        SW_CHECK(std::fabs(sw::determinant(mat::load(singular.elements))) <= tolerance * T(16));
+    }
+
+    template<typename T>
+    void test_transform_points() {
+        const auto reference = make_reference<T, 4, 4>(T(1.1));
+        const sw::mat4<T> m = sw::mat4<T>::load(reference.elements);
+        for (size_t count : { size_t(0), size_t(1), size_t(3), size_t(8), size_t(37), size_t(1003) }) {
+            // one spare point on either side, the first one also shifts the alignment of the output
+            std::vector<sw::vector<T, 4>> points(count + 2), out(count + 2, sw::vector<T, 4>(T(-7)));
+            std::vector<T> coordinates(4 * (count + 2));
+            for (size_t i = 0; i < coordinates.size(); ++i) {
+                coordinates[i] = T(i % 17) * T(0.25) - T(2);
+            }
+            for (size_t i = 0; i < points.size(); ++i) {
+                points[i] = sw::vector<T, 4>::load_unaligned(coordinates.data() + 4 * i);
+            }
+            const sw::span<const sw::vector<T, 4>> in(points.data() + 1, count);
+            const sw::span<sw::vector<T, 4>> dst(out.data() + 1, count);
+            sw::transform_points(m, in, dst);
+
+            bool ok = true;
+            for (size_t p = 0; p < count; ++p) {
+                T result[4];
+                dst[p].store_unaligned(result);
+                for (size_t i = 0; i < 4; ++i) {
+                    T expected = T(0);
+                    for (size_t k = 0; k < 4; ++k) {
+                        expected += reference.at(i, k) * coordinates[4 * (p + 1) + k];
+                    }
+                    ok &= std::fabs(result[i] - expected) <= T(1e-5) * (T(1) + std::fabs(expected));
+                }
+            }
+            SW_CHECK(ok);
+            T guard[4];
+            out[0].store_unaligned(guard);
+            SW_CHECK(guard[0] == T(-7) && guard[3] == T(-7));
+            out[count + 1].store_unaligned(guard);
+            SW_CHECK(guard[0] == T(-7) && guard[3] == T(-7));
+
+            // the same per point, in place and through the pool
+            ok = true;
+            for (size_t p = 0; p < count; ++p) {
+                T single[4], bulk[4];
+                (m * in[p]).store_unaligned(single);
+                dst[p].store_unaligned(bulk);
+                ok &= single[0] == bulk[0] && single[1] == bulk[1] && single[2] == bulk[2] && single[3] == bulk[3];
+            }
+            SW_CHECK(ok);
+            sw::thread_pool pool(3);
+            const sw::execution::parallel_policy policy{ &pool, 256 };
+            std::vector<sw::vector<T, 4>> parallel(count + 1);
+            sw::transform_points(policy, m, in, sw::span<sw::vector<T, 4>>(parallel.data(), count));
+            sw::transform_points(m, sw::span<sw::vector<T, 4>>(points.data() + 1, count));
+            ok = true;
+            for (size_t p = 0; p < count; ++p) {
+                T a[4], b[4], c[4];
+                dst[p].store_unaligned(a);
+                parallel[p].store_unaligned(b);
+                points[p + 1].store_unaligned(c);
+                ok &= a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
+                ok &= a[0] == c[0] && a[1] == c[1] && a[2] == c[2] && a[3] == c[3];
+            }
+            SW_CHECK(ok);
+        }
+    }
+
+    template<typename T>
+    void test_gemm(T tolerance) {
+        struct shape { size_t m, n, k; };
+        // odd sizes for the edge slivers, 300 deep for two kc panels, 300 rows for several mc blocks
+        for (shape s : { shape{ 1, 1, 1 }, shape{ 7, 5, 3 }, shape{ 33, 17, 65 }, shape{ 300, 70, 300 }, shape{ 64, 130, 64 }, shape{ 5, 4, 0 } }) {
+            const size_t lda = s.m + 3, ldb = s.k + 1, ldc = s.m + 2;
+            std::vector<T> a(lda * s.k), b(ldb * s.n), c(ldc * s.n);
+            for (size_t i = 0; i < a.size(); ++i) {
+                a[i] = std::sin(T(i) * T(0.7));
+            }
+            for (size_t i = 0; i < b.size(); ++i) {
+                b[i] = std::cos(T(i) * T(0.3));
+            }
+            for (size_t i = 0; i < c.size(); ++i) {
+                c[i] = T(i % 11) - T(5);
+            }
+            for (T beta : { T(0), T(1), T(-0.5) }) {
+                std::vector<T> out = c;
+                if (beta == T(0)) {
+                    // beta of 0 ignores whatever was in C
+                    for (size_t j = 0; j < s.n; ++j) {
+                        out[j * ldc] = std::numeric_limits<T>::quiet_NaN();
+                    }
+                }
+                sw::gemm(s.m, s.n, s.k, T(1.5), a.data(), lda, b.data(), ldb, beta, out.data(), ldc);
+                bool ok = true;
+                for (size_t j = 0; j < s.n; ++j) {
+                    for (size_t i = 0; i < ldc; ++i) {
+                        if (i >= s.m) {
+                            // padding between the columns stays alone
+                            ok &= out[i + j * ldc] == c[i + j * ldc];
+                            continue;
+                        }
+                        double expected = 0.0;
+                        for (size_t p = 0; p < s.k; ++p) {
+                            expected += double(a[i + p * lda]) * double(b[p + j * ldb]);
+                        }
+                        expected = 1.5 * expected + double(beta) * double(c[i + j * ldc]);
+                        ok &= std::fabs(double(out[i + j * ldc]) - expected) <= double(tolerance) * (std::sqrt(double(s.k)) + std::fabs(expected));
+                    }
+                }
+                SW_CHECK(ok);
+
+                // bitwise the same through the pool
+                sw::thread_pool pool(3);
+                std::vector<T> parallel = c;
+                sw::gemm(sw::execution::parallel_policy{ &pool }, s.m, s.n, s.k, T(1.5), a.data(), lda, b.data(), ldb, beta, parallel.data(), ldc);
+                if (beta == T(0)) {
+                    for (size_t j = 0; j < s.n; ++j) {
+                        parallel[j * ldc] = out[j * ldc];
+                    }
+                }
+                SW_CHECK(std::equal(out.begin(), out.end(), parallel.begin()));
+            }
+        }
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_square<float, 4>(1e-5f);
+    test_square<float, 3>(1e-5f);
+    test_inverse<float>(1e-5f);
+    test_transform_points<float>();
+    test_gemm<float>(1e-5f);
+#if SW_ISA_LEVEL >= 2
+    test_square<double, 4>(1e-13);
+    test_inverse<double>(1e-13);
+    test_transform_points<double>();
+#endif
+    test_gemm<double>(1e-13);
+    return sw_test::finish("matrix_tests");
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "scan.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    // log and CSV like text with some bytes from the upper half mixed in
+    std::string make_text(size_t count, size_t seed) {
+        static const char alphabet[] = "abc,\"\n\t 019;xyz\"\"";
+        std::string result(count, ' ');
+        uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+        for (size_t i = 0; i < count; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            result[i] = state % 11 == 0 ? char(0x80 + state % 128) : alphabet[state % (sizeof(alphabet) - 1)];
+        }
+        return result;
+    }
+
+    template<size_t LEN>
+    void test_registers() {
+        std::array<uint8_t, LEN> bytes, table_bytes;
+        for (size_t i = 0; i < LEN; ++i) {
+            bytes[i] = uint8_t(i * 37 + 11);
+            table_bytes[i] = uint8_t(200 - i);
+        }
+        bytes[LEN / 2] = 0x81;
+        const auto v = sw::vector<uint8_t, LEN>::load_partial(bytes.data());
+        const auto table = sw::vector<uint8_t, LEN>::load_partial(table_bytes.data());
+        std::array<uint8_t, LEN> shuffled;
+        sw::shuffle_bytes(table, v).store_partial(shuffled.data());
+
+        // one class for ASCII digits, one for bytes with the top bit set
+        const uint8_t low[16] = { 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2 };
+        const uint8_t high[16] = { 0, 0, 0, 1, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2 };
+        std::array<uint8_t, LEN> classes;
+        sw::classify(v, low, high).store_partial(classes.data());
+
+        const sw::byte_set set("\x0b\x30\x81");
+        const auto matched = sw::match(set, v);
+        bool ok = true;
+        for (size_t i = 0; i < LEN; ++i) {
+            const size_t lane = i & ~size_t(15);
+            ok &= shuffled[i] == (bytes[i] & 0x80 ? 0 : table_bytes[lane + (bytes[i] & 15)]);
+            ok &= classes[i] == (low[bytes[i] & 15] & high[bytes[i] >> 4]);
+            ok &= matched[i] == set.contains(bytes[i]);
+        }
+        ok &= sw::find_first(matched) == 0;
+        ok &= sw::find_first(sw::mask<uint8_t, LEN>()) == LEN;
+        ok &= sw::find_first(v == uint8_t(0x81)) == LEN / 2;
+        SW_CHECK(ok);
+    }
+
+    template<size_t LEN>
+    void test_spans() {
+        constexpr size_t lanes = LEN == 0 ? sw::native_length<uint8_t> : LEN;
+        const sw::byte_set delimiters(",;\n");
+        const sw::byte_set high("\xff\xc3");
+        for (size_t count : { size_t(0), size_t(1), size_t(lanes - 1), size_t(lanes), size_t(3 * lanes + 5), size_t(4099) }) {
+            const std::string text = make_text(count, count + lanes);
+            const sw::span<const char> data(text.data(), text.size());
+            bool ok = true;
+
+            ok &= sw::find_byte<LEN>(data, '\n') == std::min(text.find('\n'), count);
+            ok &= sw::find_byte<LEN>(data, '#') == count;
+            ok &= sw::find_first_of<LEN>(data, delimiters) == std::min(text.find_first_of(",;\n"), count);
+            ok &= sw::find_first_of<LEN>(data, high) == std::min(text.find_first_of("\xff\xc3"), count);
+            ok &= sw::count_byte<LEN>(data, '\n') == size_t(std::count(text.begin(), text.end(), '\n'));
+            ok &= sw::count_byte<LEN>(data, 0) == 0;
+
+            std::vector<size_t> all, unquoted;
+            size_t counted = 0;
+            bool inside = false;
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t byte = uint8_t(text[i]);
+                inside ^= byte == '"';
+                if (delimiters.contains(byte)) {
+                    all.push_back(i);
+                    if (!inside) {
+                        unquoted.push_back(i);
+                    }
+                }
+                counted += high.contains(byte);
+            }
+            ok &= sw::count_of<LEN>(data, high) == counted;
+
+            std::vector<size_t> positions(all.size() + 1, ~size_t(0));
+            ok &= sw::find_all<LEN>(data, delimiters, sw::span<size_t>(positions)) == all.size();
+            ok &= std::equal(all.begin(), all.end(), positions.begin());
+            ok &= sw::find_all_unquoted<LEN>(data, delimiters, sw::span<size_t>(positions)) == unquoted.size();
+            ok &= std::equal(unquoted.begin(), unquoted.end(), positions.begin());
+            // a short output stops the scan
+            if (all.size() > 2) {
+                ok &= sw::find_all<LEN>(data, delimiters, sw::span<size_t>(positions.data(), 2)) == 2;
+                ok &= positions[0] == all[0] && positions[1] == all[1];
+            }
+            SW_CHECK(ok);
+        }
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_registers<16>();
+    test_spans<16>();
+    test_spans<0>();
+#if SW_ISA_LEVEL >= 2
+    test_registers<32>();
+    test_spans<32>();
+#endif
+#if SW_ISA_LEVEL >= 3
+    test_registers<64>();
+    test_spans<64>();
+#endif
+    return sw_test::finish("scan_tests");
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef SIMD_WRAP_TESTS_TEST_HELPERS_HPP
+#define SIMD_WRAP_TESTS_TEST_HELPERS_HPP
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include "dispatch.hpp"
+#include "vector.hpp"
+
+/*
+    Minimal checking for the test executables: failures are printed and
+    counted, main() returns the result of finish(). Each test is compiled
+    once per ISA level, SW_TEST_REQUIRE_HOST_ISA() bails out with ctests
+    skip code when the host can't run the level this binary was built for.
+*/
+
+namespace sw_test {
+
+    inline int failures = 0;
+
+    inline void report_failure(const char* expr, const char* file, int line) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        ++failures;
+    }
+
+    inline int finish(const char* name) {
+        std::printf("%s [%s]: %s\n", name, sw::isa_name(sw::compiled_isa), failures == 0 ? "passed" : "FAILED");
+        return failures == 0 ? 0 : 1;
+    }
+
+    // copies the lanes out of the register, independent of its width
+    template<typename T, size_t LEN>
+    std::array<T, LEN> lanes_of(sw::vector<T, LEN> const& v) {
+        const auto reg = v();
+        std::array<T, LEN> result;
+        std::memcpy(result.data(), &reg, sizeof(T) * LEN);
+        return result;
+    }
+
+}
+
+#define SW_CHECK(expr) ((expr) ? (void)0 : sw_test::report_failure(#expr, __FILE__, __LINE__))
+
+#define SW_TEST_REQUIRE_HOST_ISA() \
+    do { \
+        if (!sw::is_supported(sw::compiled_isa)) { \
+            std::printf("skipped: host can't run %s\n", sw::isa_name(sw::compiled_isa)); \
+            return 77; \
+        } \
+    } while (false)
+
+#endif //!SIMD_WRAP_TESTS_TEST_HELPERS_HPP
@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "vector.hpp"
+#include "geometric_functions.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+    using sw_test::lanes_of;
+
+    // register selection has to follow the level this file was compiled for
+#if SW_ISA_LEVEL >= 1
+    static_assert(std::is_same_v<sw::simd_traits<float, 4>::vector_type, __m128>);
+    static_assert(std::is_same_v<sw::simd_traits<double, 2>::vector_type, __m128d>);
+    static_assert(std::is_same_v<sw::simd_traits<float, 3>::vector_type, __m128>);
+    static_assert(std::is_same_v<sw::simd_traits<uint8_t, 16>::vector_type, __m128i>);
+#else
+    // one 16 byte vector extension type per lane type
+    static_assert(std::is_same_v<sw::simd_traits<float, 4>::vector_type, sw::detail::generic_register_t<float>>);
+    static_assert(std::is_same_v<sw::simd_traits<float, 3>::vector_type, sw::detail::generic_register_t<float>>);
+    static_assert(std::is_same_v<sw::simd_traits<uint8_t, 16>::vector_type, sw::detail::generic_register_t<uint8_t>>);
+    static_assert(!std::is_same_v<sw::simd_traits<uint8_t, 16>::vector_type, sw::simd_traits<int8_t, 16>::vector_type>);
+#endif
+    static_assert(sw::is_simd_compatible<float, sw::USE_AVX_INTRINSICS ? 8 : 4>);
+    static_assert(sw::is_simd_compatible<float, 8> == sw::USE_AVX_INTRINSICS);
+    static_assert(sw::simd_traits<float, 4>::alignment == 16);
+    static_assert(sw::simd_traits<float, 4>::num_entries == 4);
+
+    template<typename T, size_t LEN>
+    bool all_lanes_equal(sw::vector<T, LEN> const& v, T expected) {
+        for (T lane : lanes_of(v)) {
+            if (lane != expected) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // one bit per lane, whichever representation the compiled level uses for masks
+    template<typename T, size_t LEN>
+    uint64_t mask_bits(sw::detail::mask_type_t<T, LEN> mask) {
+        if constexpr (std::is_integral_v<decltype(mask)>) {
+            return static_cast<uint64_t>(mask);
+        }
+        else {
+            std::array<T, sizeof(mask) / sizeof(T)> lanes;
+            std::memcpy(lanes.data(), &mask, sizeof(mask));
+            uint64_t result = 0;
+            for (size_t i = 0; i < lanes.size(); ++i) {
+                T zero = T(0);
+                if (std::memcmp(&lanes[i], &zero, sizeof(T)) != 0) {
+                    result |= uint64_t(1) << i;
+                }
+            }
+            return result;
+        }
+    }
+
+    void test_construction() {
+        sw::vector<float, 4> zero;
+        sw::vector<float, 4> filled(2.0f);
+        SW_CHECK(zero.size() == 4);
+        SW_CHECK(all_lanes_equal(zero, 0.0f));
+        SW_CHECK(all_lanes_equal(filled, 2.0f));
+        sw::vector<float, 3> odd(1.0f);
+        SW_CHECK(odd.size() == 3);
+#if SW_ISA_LEVEL >= 2
+        static_assert(std::is_same_v<sw::simd_traits<float, 8>::vector_type, __m256>);
+        static_assert(sw::simd_traits<float, 8>::alignment == 32);
+        static_assert(std::is_same_v<sw::simd_traits<double, 4>::vector_type, __m256d>);
+        sw::vector<double, 4> wide(1.0);
+        SW_CHECK(wide.size() == 4);
+        SW_CHECK(all_lanes_equal(wide, 1.0));
+#endif
+#if SW_ISA_LEVEL >= 3
+        static_assert(std::is_same_v<sw::simd_traits<float, 16>::vector_type, __m512>);
+        static_assert(std::is_same_v<sw::simd_traits<float, 12>::vector_type, __m512>);
+        static_assert(std::is_same_v<sw::simd_traits<double, 8>::vector_type, __m512d>);
+        static_assert(std::is_same_v<sw::simd_traits<uint8_t, 64>::vector_type, __m512i>);
+        static_assert(std::is_same_v<sw::simd_traits<int16_t, 32>::vector_type, __m512i>);
+        static_assert(std::is_same_v<sw::simd_traits<int64_t, 8>::vector_type, __m512i>);
+        static_assert(sw::simd_traits<float, 16>::alignment == 64);
+        static_assert(std::is_same_v<sw::simd_traits<float, 16>::mask_type, __mmask16>);
+        static_assert(std::is_same_v<sw::simd_traits<double, 8>::mask_type, __mmask8>);
+        static_assert(std::is_same_v<sw::simd_traits<uint8_t, 64>::mask_type, __mmask64>);
+        // VL: k-register masks at the narrower widths as well
+        static_assert(std::is_same_v<sw::simd_traits<float, 4>::mask_type, __mmask8>);
+        static_assert(sw::native_length<float> == 16);
+        sw::vector<float, 16> widest(3.0f);
+        SW_CHECK(all_lanes_equal(widest, 3.0f));
+        sw::vector<uint8_t, 64> bytes(uint8_t(200));
+        SW_CHECK(all_lanes_equal(bytes, uint8_t(200)));
+#else
+        static_assert(std::is_same_v<sw::simd_traits<float, 4>::mask_type, sw::simd_traits<float, 4>::vector_type>);
+        static_assert(!sw::is_simd_compatible<float, 16>);
+#endif
+    }
+
+    template<typename T, size_t LEN>
+    void test_compare() {
+        using sw::detail::compare_op;
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        std::array<T, sw::simd_traits<T, LEN>::num_entries> lhs{}, rhs{};
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            lhs[i] = T(i % 3);
+            rhs[i] = T(1);
+        }
+        lhs[0] = nan;
+        sw::detail::vector_type_t<T, LEN> a, b;
+        std::memcpy(&a, lhs.data(), sizeof(a));
+        std::memcpy(&b, rhs.data(), sizeof(b));
+        uint64_t expected_lt = 0, expected_eq = 0, expected_neq = 0, expected_ge = 0;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            expected_lt |= uint64_t(lhs[i] < rhs[i]) << i;
+            expected_eq |= uint64_t(lhs[i] == rhs[i]) << i;
+            expected_neq |= uint64_t(lhs[i] != rhs[i]) << i;
+            expected_ge |= uint64_t(lhs[i] >= rhs[i]) << i;
+        }
+        SW_CHECK((mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::lt>(a, b)) == expected_lt));
+        SW_CHECK((mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::eq>(a, b)) == expected_eq));
+        SW_CHECK((mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::neq>(a, b)) == expected_neq));
+        SW_CHECK((mask_bits<T, LEN>(sw::detail::compare_vals<T, LEN, compare_op::ge>(a, b)) == expected_ge));
+    }
+
+    template<typename T, size_t LEN>
+    void test_masks() {
+        using vec = sw::vector<T, LEN>;
+        std::array<T, LEN> values;
+        for (size_t i = 0; i < LEN; ++i) {
+            values[i] = T(i % 5);
+        }
+        const vec v = vec::load_partial(values.data());
+        uint64_t expected = 0;
+        for (size_t i = 0; i < LEN; ++i) {
+            expected |= uint64_t(values[i] >= T(2)) << i;
+        }
+        const sw::mask<T, LEN> m = v >= T(2);
+        SW_CHECK(m.bits() == expected);
+        SW_CHECK(sw::popcount(m) == std::bitset<64>(expected).count());
+        if constexpr (LEN >= 3) {
+            SW_CHECK((m[2] && !m[1]));
+            SW_CHECK(sw::any(m) && !sw::all(m) && !sw::none(m));
+            SW_CHECK((sw::mask<T, LEN>::first(3).bits() == 7));
+        }
+        // padding lanes are zero, so they compare equal but must not count
+        SW_CHECK(sw::all(v == v) && sw::none(v != v) && sw::none(T(7) < v));
+        SW_CHECK((sw::all(sw::mask<T, LEN>(true)) && sw::none(sw::mask<T, LEN>())));
+        SW_CHECK(((~m).bits() == (~expected & sw::mask<T, LEN>(true).bits())));
+        SW_CHECK(((m & (v < T(4))) | (v == T(0))).bits() == (((m.bits() & (v < T(4)).bits())) | (v == T(0)).bits()));
+        SW_CHECK((m ^ m).bits() == 0);
+        SW_CHECK((v + v > v + T(1)).bits() == (v > T(1)).bits());
+
+        const auto chosen = lanes_of(sw::select(m, v, T(9)));
+        bool ok = true;
+        for (size_t i = 0; i < LEN; ++i) {
+            ok &= chosen[i] == (values[i] >= T(2) ? values[i] : T(9));
+        }
+        SW_CHECK(ok);
+
+        // only the kept lanes are written, the rest of the buffer stays
+        std::array<T, LEN + 1> packed;
+        packed.fill(T(-3));
+        const size_t kept = sw::compress_store(packed.data(), m, v);
+        SW_CHECK(kept == sw::popcount(m));
+        size_t out = 0;
+        ok = true;
+        for (size_t i = 0; i < LEN; ++i) {
+            if (values[i] >= T(2)) {
+                ok &= packed[out++] == values[i];
+            }
+        }
+        for (; out < packed.size(); ++out) {
+            ok &= packed[out] == T(-3);
+        }
+        SW_CHECK(ok);
+    }
+
+    template<typename T, size_t LEN>
+    void test_expressions() {
+        using vec = sw::vector<T, LEN>;
+        const vec a(T(3)), b(T(4)), c(T(5)), d(T(6));
+        // nothing gets evaluated until assignment, the tree is just references and scalars
+        auto expr = a * b + c * d - T(2);
+        static_assert(!std::is_same_v<decltype(expr), vec>);
+        static_assert(sw::detail::is_expression_node_v<decltype(expr)>);
+        vec result = expr;
+        SW_CHECK(all_lanes_equal(result, T(40)));
+
+        result = T(2) * a - b / T(2) + (-c);
+        SW_CHECK(all_lanes_equal(result, T(-1)));
+        result = -(a - d);
+        SW_CHECK(all_lanes_equal(result, T(3)));
+        result = T(1) / b;
+        SW_CHECK(all_lanes_equal(result, T(0.25)));
+
+        result += a;
+        result *= T(4);
+        result -= vec(T(1));
+        result /= b * T(0.5);
+        SW_CHECK(all_lanes_equal(result, T(6)));
+
+        // negation only flips the sign bit
+        vec zero;
+        zero = -zero;
+        SW_CHECK(std::signbit(lanes_of(zero)[0]));
+    }
+
+    template<typename T, size_t LEN>
+    void test_integer_expressions() {
+        using vec = sw::vector<T, LEN>;
+        const vec a(T(7)), b(T(3));
+        vec result = a * b - T(1) + (-b);
+        SW_CHECK(all_lanes_equal(result, T(17)));
+        result -= a;
+        SW_CHECK(all_lanes_equal(result, T(10)));
+    }
+
+    template<size_t LEN>
+    void test_fma_contraction() {
+        using vec = sw::vector<float, LEN>;
+        // (1 + 2^-12)^2 = 1 + 2^-11 + 2^-24, the last term only survives if the product isn't rounded
+        const float x = 1.0f + std::ldexp(1.0f, -12);
+        const float rounded = 1.0f + std::ldexp(1.0f, -11);
+        const float residue = sw::CONTRACT_FMA ? std::ldexp(1.0f, -24) : 0.0f;
+        const vec a(x), c(rounded);
+        vec result = a * a - c;
+        SW_CHECK(all_lanes_equal(result, residue));
+        result = c - a * a;
+        SW_CHECK(all_lanes_equal(result, -residue));
+        result = -c + a * a;
+        SW_CHECK(all_lanes_equal(result, residue));
+        result = -c;
+        result += a * a;
+        SW_CHECK(all_lanes_equal(result, residue));
+        // operands of the fused node still evaluate normally
+        result = (a + 1.0f) * (a - 1.0f) + 1.0f;
+        SW_CHECK(std::fabs(lanes_of(result)[0] - x * x) <= 1e-6f);
+    }
+
+
+    template<typename T, size_t LEN>
+    void test_partial() {
+        using vec = sw::vector<T, LEN>;
+        constexpr size_t lanes = sw::simd_traits<T, LEN>::num_entries;
+        std::array<T, lanes + 4> src, dst;
+        for (size_t i = 0; i < src.size(); ++i) {
+            src[i] = T(i + 1);
+        }
+        for (size_t count = 0; count <= LEN; ++count) {
+            const vec v = vec::load_partial(src.data(), count);
+            const auto reg = v();
+            std::array<T, lanes> loaded;
+            std::memcpy(loaded.data(), &reg, sizeof(reg));
+            bool loaded_ok = true;
+            for (size_t i = 0; i < lanes; ++i) {
+                loaded_ok &= loaded[i] == (i < count ? src[i] : T(0));
+            }
+            SW_CHECK(loaded_ok);
+            dst.fill(T(7));
+            vec(T(3)).store_partial(dst.data(), count);
+            bool stored_ok = true;
+            for (size_t i = 0; i < dst.size(); ++i) {
+                stored_ok &= dst[i] == (i < count ? T(3) : T(7));
+            }
+            SW_CHECK(stored_ok);
+        }
+    }
+
+    template<typename T, size_t LEN>
+    void test_load_store() {
+        using vec = sw::vector<T, LEN>;
+        constexpr size_t alignment = sw::simd_traits<T, LEN>::alignment;
+        alignas(64) T src[LEN + 1];
+        alignas(64) T dst[LEN + 1];
+        for (size_t i = 0; i < LEN + 1; ++i) {
+            src[i] = T(i + 1);
+            dst[i] = T(0);
+        }
+        SW_CHECK((sw::is_aligned<T, LEN>(src)));
+        const vec aligned = vec::load(src);
+        aligned.store(dst);
+        bool copied = true;
+        for (size_t i = 0; i < LEN; ++i) {
+            copied &= dst[i] == src[i];
+        }
+        // exactly LEN elements, also for lengths that don't fill the register
+        SW_CHECK(copied && dst[LEN] == T(0));
+        const vec shifted = vec::load_unaligned(src + 1);
+        shifted.store_unaligned(dst + 1);
+        SW_CHECK(dst[1] == T(2) && dst[LEN] == T(LEN + 1) && dst[0] == T(1));
+        SW_CHECK(sw::reduce_add(aligned - shifted) == T(-T(LEN)));
+
+        // peeling: how far until the next aligned element, never past count
+        SW_CHECK((sw::peel_count<T, LEN>(src, 100) == 0));
+        SW_CHECK((sw::peel_count<T, LEN>(src + 1, 100) == alignment / sizeof(T) - 1));
+        SW_CHECK((sw::peel_count<T, LEN>(src + 1, 0) == 0));
+        SW_CHECK((sw::is_aligned<T, LEN>(src + 1 + sw::peel_count<T, LEN>(src + 1, 1000))));
+    }
+
+    template<typename T, size_t LEN>
+    void test_reductions() {
+        using vec = sw::vector<T, LEN>;
+        // broadcasting fills the padding lanes too, reductions must ignore them
+        SW_CHECK(sw::reduce_add(vec(T(1))) == T(LEN));
+        std::array<T, LEN> values;
+        for (size_t i = 0; i < LEN; ++i) {
+            values[i] = T(i + 2);
+        }
+        values[LEN / 2] = T(-5);
+        T sum = T(0), lowest = values[0], highest = values[0];
+        for (T value : values) {
+            sum += value;
+            lowest = std::min(lowest, value);
+            highest = std::max(highest, value);
+        }
+        const vec v = vec::load_partial(values.data());
+        SW_CHECK(sw::reduce_min(v) == lowest);
+        SW_CHECK(sw::reduce_max(v) == highest);
+        SW_CHECK(sw::reduce_add(v * T(2)) == T(2) * sum);
+    }
+
+    void test_geometric() {
+        const float xyz[3] = { 1.0f, 2.0f, 2.0f };
+        const sw::vector<float, 3> v = sw::vector<float, 3>::load_partial(xyz);
+        SW_CHECK(sw::dot(v, v) == 9.0f);
+        SW_CHECK(sw::length(v) == 3.0f);
+        SW_CHECK(sw::dot(sw::vector<float, 3>(2.0f), sw::vector<float, 3>(1.0f)) == 6.0f);
+        SW_CHECK(sw::length(sw::vector<double, 1>(-4.0)) == 4.0);
+        const auto unit = lanes_of(sw::normalize(v));
+        SW_CHECK(unit[0] == 1.0f / 3.0f && unit[1] == 2.0f / 3.0f && unit[2] == 2.0f / 3.0f);
+        const auto rough = lanes_of(sw::normalize<sw::precision::fast>(v));
+        SW_CHECK(std::fabs(rough[1] - 2.0f / 3.0f) < 1e-3f);
+    }
+
+}
+
+int main() {
+    SW_TEST_REQUIRE_HOST_ISA();
+    test_construction();
+    test_expressions<float, 4>();
+    test_expressions<double, 2>();
+    test_integer_expressions<int32_t, 4>();
+    test_integer_expressions<int16_t, 8>();
+    test_fma_contraction<4>();
+    test_compare<float, 4>();
+    test_compare<double, 2>();
+    test_masks<float, 4>();
+    test_masks<float, 3>();
+    test_masks<double, 2>();
+    test_masks<int32_t, 4>();
+    test_masks<int64_t, 2>();
+    test_masks<int16_t, 7>();
+    test_masks<int8_t, 16>();
+    test_partial<float, 3>();
+    test_partial<double, 1>();
+    test_partial<uint8_t, 13>();
+    test_partial<int16_t, 5>();
+    test_partial<int64_t, 1>();
+    test_load_store<float, 4>();
+    test_load_store<float, 3>();
+    test_load_store<double, 2>();
+    test_reductions<float, 3>();
+    test_reductions<float, 4>();
+    test_reductions<double, 1>();
+    SW_CHECK(sw::reduce_add(sw::vector<uint8_t, 15>(uint8_t(2))) == uint8_t(30));
+    SW_CHECK(sw::reduce_add(sw::vector<int32_t, 3>(-2)) == -6);
+    test_geometric();
+#if SW_ISA_LEVEL >= 2
+    test_expressions<float, 8>();
+    test_expressions<double, 4>();
+    test_integer_expressions<int16_t, 16>();
+    test_fma_contraction<8>();
+    test_compare<float, 8>();
+    test_compare<double, 4>();
+    test_masks<float, 8>();
+    test_masks<double, 3>();
+    test_masks<uint32_t, 7>();
+    test_masks<int64_t, 4>();
+    test_masks<int16_t, 16>();
+    test_masks<int8_t, 29>();
+    test_partial<float, 6>();
+    test_partial<double, 3>();
+    test_partial<uint8_t, 29>();
+    test_partial<int64_t, 3>();
+    test_load_store<float, 8>();
+    test_load_store<double, 3>();
+    test_reductions<float, 6>();
+    test_reductions<double, 3>();
+    SW_CHECK(sw::reduce_add(sw::vector<int16_t, 11>(int16_t(3))) == 33);
+#endif
+#if SW_ISA_LEVEL >= 3
+    test_expressions<float, 16>();
+    test_expressions<double, 8>();
+    test_integer_expressions<int16_t, 32>();
+    test_integer_expressions<int32_t, 16>();
+    test_fma_contraction<16>();
+    test_compare<float, 16>();
+    test_compare<double, 8>();
+    test_masks<float, 16>();
+    test_masks<double, 7>();
+    test_masks<int32_t, 13>();
+    test_masks<int8_t, 64>();
+    test_partial<float, 13>();
+    test_partial<double, 7>();
+    test_partial<uint8_t, 50>();
+    test_partial<int32_t, 11>();
+    test_load_store<float, 16>();
+    test_load_store<double, 7>();
+    test_reductions<float, 13>();
+    test_reductions<double, 5>();
+    SW_CHECK(sw::reduce_add(sw::vector<int32_t, 12>(5)) == 60);
+    SW_CHECK(sw::reduce_add(sw::vector<uint8_t, 40>(uint8_t(1))) == 40);
+#endif
+    return sw_test::finish("type_tests");
+}